@@ -195,6 +195,8 @@ bcache::insert (const void *addr, int length, bool *added)
 
     memcpy (&newobj->d.data, addr, length);
     newobj->length = length;
+    if (m_bucket[hash_index] != nullptr)
+      m_collision_count++;
     newobj->next = m_bucket[hash_index];
     newobj->half_hash = half_hash;
     m_bucket[hash_index] = newobj;
@@ -365,6 +367,8 @@ Total memory used by bcache, including overhead: %ld\n"),
 	      m_total_count + m_expand_hash_count);
   gdb_printf (_("    Half hash misses:          %lu\n"),
 	      m_half_hash_miss_count);
+  gdb_printf (_("    Hash collisions:           %lu\n"),
+	      m_collision_count);
   gdb_printf (_("    Hash table population:     "));
   print_percentage (occupied_buckets, m_num_buckets);
   gdb_printf (_("    Median hash chain length:  %3d\n"),
@@ -375,6 +379,12 @@ Total memory used by bcache, including overhead: %ld\n"),
   else
     /* i18n: "Average hash chain length: (not applicable)".  */
     gdb_printf (_("(not applicable)\n"));
+  gdb_printf (_("    Average occupied chain length: "));
+  if (occupied_buckets > 0)
+    gdb_printf ("%.2f\n", (double) m_unique_count / occupied_buckets);
+  else
+    /* i18n: "Average occupied chain length: (not applicable)".  */
+    gdb_printf (_("(not applicable)\n"));
   gdb_printf (_("    Maximum hash chain length: %3d\n"), 
 	      max_chain_length);
   gdb_printf ("\n");
@@ -200,6 +200,9 @@ struct bcache
      16 bits of hash values) hit, but the corresponding combined
      length/data compare missed.  */
   unsigned long m_half_hash_miss_count = 0;
+  /* Number of times that a new string was entered into a bucket that
+     already held other strings.  */
+  unsigned long m_collision_count = 0;
 
   /* Expand the hash table.  */
   void expand_hash_table ();
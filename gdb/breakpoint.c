@@ -63,6 +63,7 @@
 #include "stack.h"
 #include "ax-gdb.h"
 #include "dummy-frame.h"
+#include "maint.h"
 #include "interps.h"
 #include "gdbsupport/format.h"
 #include "thread-fsm.h"
@@ -13215,11 +13216,94 @@ breakpoint_re_set_one (breakpoint *b)
   b->re_set ();
 }
 
-/* Re-set breakpoint locations for the current program space.
-   Locations bound to other program spaces are left untouched.  */
+/* If true, breakpoint_re_set_objfiles only re-sets the breakpoints
+   whose locations may change because of the new objfiles.  */
 
-void
-breakpoint_re_set (void)
+static bool incremental_breakpoint_re_set = true;
+
+/* Return true if decoding the location spec of B against OBJFILE alone
+   finds a location in OBJFILE, or fails in a way a full re-set should
+   report.  */
+
+static bool
+locspec_found_in_objfile (code_breakpoint *b, struct objfile *objfile)
+{
+  struct linespec_result canonical;
+
+  /* Decode the location spec in the language and radix it was given
+     in, as breakpoint_re_set_one does.  The caller restores them.  */
+  input_radix = b->input_radix;
+  set_language (b->language);
+
+  try
+    {
+      decode_line_full (b->locspec.get (), DECODE_LINE_FUNFIRSTLINE,
+			objfile->pspace, NULL, 0, &canonical,
+			multiple_symbols_all, b->filter.get (), objfile);
+    }
+  catch (const gdb_exception_error &e)
+    {
+      return e.error != NOT_FOUND_ERROR;
+    }
+
+  for (const linespec_sals &lsal : canonical.lsals)
+    for (const symtab_and_line &sal : lsal.sals)
+      if (is_addr_in_objfile (sal.pc, objfile))
+	return true;
+
+  return false;
+}
+
+/* Return true if breakpoint B must be re-set now that NEW_OBJFILES
+   were added to the current program space.  */
+
+static bool
+breakpoint_affected_by_objfiles (breakpoint *b,
+				 gdb::array_view<objfile *const> new_objfiles)
+{
+  /* Only the location specs of user breakpoints and tracepoints are
+     checked against the new objfiles.  Anything else is re-set.  */
+  if ((!is_breakpoint (b) && !is_tracepoint (b))
+      || b->type == bp_static_marker_tracepoint)
+    return true;
+
+  code_breakpoint *cb = gdb::checked_static_cast<code_breakpoint *> (b);
+
+  if (cb->locspec == nullptr
+      || cb->locspec_range_end != nullptr
+      || (cb->locspec->type () != LINESPEC_LOCATION_SPEC
+	  && cb->locspec->type () != EXPLICIT_LOCATION_SPEC))
+    return true;
+
+  /* A full re-set drops the locations left in unloaded shared
+     libraries, unless all the locations are there.  */
+  bool any_unloaded = false;
+  for (bp_location &loc : b->locations ())
+    if (loc.pspace == current_program_space && loc.shlib_disabled)
+      any_unloaded = true;
+  if (any_unloaded && !all_locations_are_pending (b, current_program_space))
+    return true;
+
+  /* A condition that could not be parsed may refer to symbols of the
+     new objfiles.  */
+  if (b->cond_string != nullptr)
+    for (bp_location &loc : b->locations ())
+      if (loc.cond == nullptr)
+	return true;
+
+  for (objfile *objfile : new_objfiles)
+    if (locspec_found_in_objfile (cb, objfile))
+      return true;
+
+  return false;
+}
+
+/* Re-set the breakpoint locations for the current program space, or,
+   if NEW_OBJFILES is not empty, just the ones that the addition of
+   NEW_OBJFILES to it may change.  */
+
+static void
+breakpoint_re_set_1 (gdb::array_view<objfile *const> new_objfiles)
 {
   {
     scoped_restore_current_language save_language;
@@ -13248,7 +13332,9 @@ breakpoint_re_set (void)
       {
 	try
 	  {
-	    breakpoint_re_set_one (&b);
+	    if (new_objfiles.empty ()
+		|| breakpoint_affected_by_objfiles (&b, new_objfiles))
+	      breakpoint_re_set_one (&b);
 	  }
 	catch (const gdb_exception &ex)
 	  {
@@ -13269,6 +13355,33 @@ breakpoint_re_set (void)
   /* Now we can insert.  */
   update_global_location_list (UGLL_MAY_INSERT);
 }
+
+/* Re-set breakpoint locations for the current program space.
+   Locations bound to other program spaces are left untouched.  */
+
+void
+breakpoint_re_set (void)
+{
+  scoped_time_it time_it ("breakpoint re-set");
+
+  breakpoint_re_set_1 ({});
+}
+
+/* See breakpoint.h.  */
+
+void
+breakpoint_re_set_objfiles (gdb::array_view<objfile *const> new_objfiles)
+{
+  if (!incremental_breakpoint_re_set)
+    {
+      breakpoint_re_set ();
+      return;
+    }
+
+  scoped_time_it time_it ("incremental breakpoint re-set");
+
+  breakpoint_re_set_1 (new_objfiles);
+}
 
 /* Reset the thread number of this breakpoint:
 
@@ -15114,6 +15227,18 @@ user-query to see if a pending breakpoint should be created."),
 
   pending_break_support = AUTO_BOOLEAN_AUTO;
 
+  add_setshow_boolean_cmd ("incremental-breakpoint-re-set",
+			   class_maintenance,
+			   &incremental_breakpoint_re_set, _("\
+Set whether breakpoints are re-set incrementally."), _("\
+Show whether breakpoints are re-set incrementally."), _("\
+When on, which is the default, the breakpoints are re-set after shared\n\
+libraries are loaded only if their location specs match in the new\n\
+libraries.  When off, all the breakpoints are re-set."),
+			   NULL, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
   add_setshow_boolean_cmd ("auto-hw", no_class,
 			   &automatic_hardware_breakpoints, _("\
 Set automatic usage of hardware breakpoints."), _("\
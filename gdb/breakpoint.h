@@ -1491,6 +1491,14 @@ extern void update_breakpoint_locations
 
 extern void breakpoint_re_set (void);
 
+/* Like breakpoint_re_set, after NEW_OBJFILES were added to the
+   current program space.  Only the breakpoints whose locations may
+   change because of them are re-set, unless "maintenance set
+   incremental-breakpoint-re-set" is off.  */
+
+extern void breakpoint_re_set_objfiles
+  (gdb::array_view<objfile *const> new_objfiles);
+
 extern void breakpoint_re_set_thread (struct breakpoint *);
 
 extern void delete_breakpoint (struct breakpoint *);
@@ -85,8 +85,14 @@ complaint_interceptor *complaint_interceptor::g_complaint_interceptor;
 complaint_interceptor::complaint_interceptor ()
   : m_saved_warning_hook (deprecated_warning_hook)
 {
-  /* These cannot be stacked.  */
-  gdb_assert (g_complaint_interceptor == nullptr);
+  /* If complaints are already intercepted, leave them to the outer
+     interceptor.  */
+  if (g_complaint_interceptor != nullptr)
+    {
+      m_nested = true;
+      return;
+    }
+
   g_complaint_interceptor = this;
   deprecated_warning_hook = issue_complaint;
 }
@@ -106,6 +112,9 @@ wrap_warning_hook (void (*hook) (const char *, va_list), ...)
 
 complaint_interceptor::~complaint_interceptor ()
 {
+  if (m_nested)
+    return;
+
   for (const std::string &str : m_complaints)
     {
       if (m_saved_warning_hook)
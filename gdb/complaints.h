@@ -61,7 +61,8 @@ extern void clear_complaints ();
    When this is instantiated, it hooks into the complaint mechanism,
    so the 'complaint' macro can continue to be used.  When it is
    destroyed, it issues all the complaints that have been stored.  It
-   should only be instantiated in the main thread.  */
+   should only be instantiated in the main thread.  Instances may be
+   nested; then the outermost one handles all the complaints.  */
 
 class complaint_interceptor
 {
@@ -77,6 +78,10 @@ class complaint_interceptor
   /* The issued complaints.  */
   std::unordered_set<std::string> m_complaints;
 
+  /* True if another interceptor was already handling the
+     complaints.  */
+  bool m_nested = false;
+
   /* The saved value of deprecated_warning_hook.  */
   void (*m_saved_warning_hook) (const char *, va_list)
     ATTRIBUTE_FPTR_PRINTF (1,0);
@@ -23,8 +23,10 @@
 #include "gdbcore.h"
 #include "target-dcache.h"
 #include "inferior.h"
-#include "splay-tree.h"
 #include "gdbarch.h"
+#include "gdbsupport/byte-vector.h"
+#include <algorithm>
+#include <unordered_map>
 
 /* Commands with a prefix of `{set,show} dcache'.  */
 static struct cmd_list_element *dcache_set_list = NULL;
@@ -43,14 +45,21 @@ static struct cmd_list_element *dcache_show_list = NULL;
    significantly.  This is most useful when accessing a large amount
    of data, such as when performing a backtrace.
 
-   The cache is a splay tree along with a linked list for replacement.
-   Each block caches a LINE_SIZE area of memory.  Within each line we
-   remember the address of the line (which must be a multiple of
-   LINE_SIZE) and the actual data block.
+   The cache is a hash table indexed by line address, along with a
+   linked list for replacement.  Each block caches a LINE_SIZE area of
+   memory.  Within each line we remember the address of the line (which
+   must be a multiple of LINE_SIZE) and the actual data block.
 
    Lines are only allocated as needed, so DCACHE_SIZE really specifies the
    *maximum* number of lines in the cache.
 
+   When a read misses, the adjacent missing lines of the same read are
+   fetched with a single target read.  If the miss starts right where
+   the previous one ended, the access looks sequential, and some lines
+   past the end of the read are fetched too.  This readahead window
+   doubles with each sequential miss, up to DCACHE_READAHEAD_LIMIT
+   lines, and is dropped as soon as a miss is elsewhere.
+
    At present, the cache is write-through rather than writeback: as soon
    as data is written to the cache, it is also immediately written to
    the target.  Therefore, cache lines are never "dirty".  Whether a given
@@ -60,7 +69,7 @@ static struct cmd_list_element *dcache_show_list = NULL;
 /* NOTE: Interaction of dcache and memory region attributes
 
    As there is no requirement that memory region attributes be aligned
-   to or be a multiple of the dcache page size, dcache_read_line() and
+   to or be a multiple of the dcache page size, dcache_read_range() and
    dcache_write_line() must break up the page by memory region.  If a
    chunk does not have the cache attribute set, an invalid memory type
    is set, etc., then the chunk is skipped.  Those chunks are handled
@@ -83,6 +92,11 @@ static unsigned dcache_size = DCACHE_DEFAULT_SIZE;
 #define DCACHE_DEFAULT_LINE_SIZE 64
 static unsigned dcache_line_size = DCACHE_DEFAULT_LINE_SIZE;
 
+/* The maximum number of lines read ahead of a sequential access.  Zero
+   disables readahead.  */
+#define DCACHE_DEFAULT_READAHEAD_LIMIT 64
+static unsigned dcache_readahead_limit = DCACHE_DEFAULT_READAHEAD_LIMIT;
+
 /* Each cache block holds LINE_SIZE bytes of data
    starting at a multiple-of-LINE_SIZE address.  */
 
@@ -98,35 +112,52 @@ struct dcache_block
 
   CORE_ADDR addr;		/* address of data */
   int refs;			/* # hits */
+  bool readahead;		/* read ahead and not used yet */
   gdb_byte data[1];		/* line_size bytes at given address */
 };
 
 struct dcache_struct
 {
-  splay_tree tree;
-  struct dcache_block *oldest; /* least-recently-allocated list.  */
+  /* The lines in the cache, indexed by address.  */
+  std::unordered_map<CORE_ADDR, struct dcache_block *> lines;
+
+  struct dcache_block *oldest = nullptr; /* least-recently-allocated list.  */
 
   /* The free list is maintained identically to OLDEST to simplify
      the code: we only need one set of accessors.  */
-  struct dcache_block *freelist;
+  struct dcache_block *freelist = nullptr;
 
   /* The number of in-use lines in the cache.  */
-  int size;
-  CORE_ADDR line_size;  /* current line_size.  */
+  int size = 0;
+  CORE_ADDR line_size = 0;  /* current line_size.  */
 
   /* The ptid of last inferior to use cache or null_ptid.  */
-  ptid_t ptid;
+  ptid_t ptid = null_ptid;
 
   /* The process target of last inferior to use the cache or
      nullptr.  */
-  process_stratum_target *proc_target;
+  process_stratum_target *proc_target = nullptr;
+
+  /* The address just past the lines fetched by the last miss, and the
+     number of lines to read ahead if the next miss is there.  */
+  CORE_ADDR next_miss_addr = 0;
+  unsigned readahead = 0;
+
+  /* Statistics, kept since the cache was created.  HITS and MISSES
+     count the lines looked up by reads; READAHEAD_LINES the lines
+     fetched ahead of a read, of which READAHEAD_HITS were used
+     later.  */
+  ULONGEST hits = 0;
+  ULONGEST misses = 0;
+  ULONGEST readahead_lines = 0;
+  ULONGEST readahead_hits = 0;
+  ULONGEST target_reads = 0;
+  ULONGEST bytes_read = 0;
 };
 
 typedef void (block_func) (struct dcache_block *block, void *param);
 
-static struct dcache_block *dcache_hit (DCACHE *dcache, CORE_ADDR addr);
-
-static int dcache_read_line (DCACHE *dcache, struct dcache_block *db);
+static struct dcache_block *dcache_lookup (DCACHE *dcache, CORE_ADDR addr);
 
 static struct dcache_block *dcache_alloc (DCACHE *dcache, CORE_ADDR addr);
 
@@ -223,10 +254,9 @@ free_block (struct dcache_block *block, void *param)
 void
 dcache_free (DCACHE *dcache)
 {
-  splay_tree_delete (dcache->tree);
   for_each_block (&dcache->oldest, free_block, NULL);
   for_each_block (&dcache->freelist, free_block, NULL);
-  xfree (dcache);
+  delete dcache;
 }
 
 
@@ -239,7 +269,6 @@ invalidate_block (struct dcache_block *block, void *param)
 {
   DCACHE *dcache = (DCACHE *) param;
 
-  splay_tree_remove (dcache->tree, (splay_tree_key) block->addr);
   append_block (&dcache->freelist, block);
 }
 
@@ -250,10 +279,13 @@ dcache_invalidate (DCACHE *dcache)
 {
   for_each_block (&dcache->oldest, invalidate_block, dcache);
 
+  dcache->lines.clear ();
   dcache->oldest = NULL;
   dcache->size = 0;
   dcache->ptid = null_ptid;
   dcache->proc_target = nullptr;
+  dcache->next_miss_addr = 0;
+  dcache->readahead = 0;
 
   if (dcache->line_size != dcache_line_size)
     {
@@ -271,11 +303,11 @@ dcache_invalidate (DCACHE *dcache)
 static void
 dcache_invalidate_line (DCACHE *dcache, CORE_ADDR addr)
 {
-  struct dcache_block *db = dcache_hit (dcache, addr);
+  struct dcache_block *db = dcache_lookup (dcache, addr);
 
   if (db)
     {
-      splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
+      dcache->lines.erase (db->addr);
       remove_block (&dcache->oldest, db);
       append_block (&dcache->freelist, db);
       --dcache->size;
@@ -286,39 +318,49 @@ dcache_invalidate_line (DCACHE *dcache, CORE_ADDR addr)
    containing it.  Otherwise return NULL.  */
 
 static struct dcache_block *
-dcache_hit (DCACHE *dcache, CORE_ADDR addr)
+dcache_lookup (DCACHE *dcache, CORE_ADDR addr)
 {
-  struct dcache_block *db;
+  auto it = dcache->lines.find (MASK (dcache, addr));
+
+  if (it == dcache->lines.end ())
+    return NULL;
+
+  return it->second;
+}
 
-  splay_tree_node node = splay_tree_lookup (dcache->tree,
-					    (splay_tree_key) MASK (dcache, addr));
+/* Like dcache_lookup, but count the lookup in the statistics of the
+   line and of DCACHE.  */
 
-  if (!node)
+static struct dcache_block *
+dcache_hit (DCACHE *dcache, CORE_ADDR addr)
+{
+  struct dcache_block *db = dcache_lookup (dcache, addr);
+
+  if (db == NULL)
     return NULL;
 
-  db = (struct dcache_block *) node->value;
   db->refs++;
+  dcache->hits++;
+  if (db->readahead)
+    {
+      db->readahead = false;
+      dcache->readahead_hits++;
+    }
   return db;
 }
 
-/* Fill a cache line from target memory.
-   The result is 1 for success, 0 if the (entire) cache line
-   wasn't readable.  */
+/* Read LEN bytes of target memory at MEMADDR into MYADDR, breaking up
+   the read by memory region.
+   The result is 1 for success, 0 if the whole range wasn't readable.  */
 
 static int
-dcache_read_line (DCACHE *dcache, struct dcache_block *db)
+dcache_read_range (DCACHE *dcache, CORE_ADDR memaddr, gdb_byte *myaddr,
+		   ULONGEST len)
 {
-  CORE_ADDR memaddr;
-  gdb_byte *myaddr;
-  int len;
+  ULONGEST reg_len;
   int res;
-  int reg_len;
   struct mem_region *region;
 
-  len = dcache->line_size;
-  memaddr = db->addr;
-  myaddr  = db->data;
-
   while (len > 0)
     {
       /* Don't overrun if this block is right at the end of the region.  */
@@ -338,9 +380,11 @@ dcache_read_line (DCACHE *dcache, struct dcache_block *db)
 	  continue;
 	}
 
+      dcache->target_reads++;
       res = target_read_raw_memory (memaddr, myaddr, reg_len);
       if (res != 0)
 	return 0;
+      dcache->bytes_read += reg_len;
 
       memaddr += reg_len;
       myaddr += reg_len;
@@ -364,7 +408,7 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
       db = dcache->oldest;
       remove_block (&dcache->oldest, db);
 
-      splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
+      dcache->lines.erase (db->addr);
     }
   else
     {
@@ -381,65 +425,93 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
 
   db->addr = MASK (dcache, addr);
   db->refs = 0;
+  db->readahead = false;
 
   /* Put DB at the end of the list, it's the newest.  */
   append_block (&dcache->oldest, db);
 
-  splay_tree_insert (dcache->tree, (splay_tree_key) db->addr,
-		     (splay_tree_value) db);
+  dcache->lines[db->addr] = db;
 
   return db;
 }
 
-/* Using the data cache DCACHE, store in *PTR the contents of the byte at
-   address ADDR in the remote machine.  
+/* Fill the cache lines from ADDR, which is not cached, with a single
+   target read.  The read covers the following lines up to the one
+   holding LAST, the last byte the caller wants, as long as they are
+   not cached either, and the lines read ahead if the access looks
+   sequential.  Return the number of lines of the caller's range that
+   are now cached, which is 0 if the line at ADDR wasn't readable.  */
 
-   Returns 1 for success, 0 for error.  */
-
-static int
-dcache_peek_byte (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr)
+static ULONGEST
+dcache_read_lines (DCACHE *dcache, CORE_ADDR addr, CORE_ADDR last)
 {
-  struct dcache_block *db = dcache_hit (dcache, addr);
-
-  if (!db)
+  const CORE_ADDR line_size = dcache->line_size;
+  ULONGEST max_lines = dcache_size;
+  CORE_ADDR next;
+
+  addr = MASK (dcache, addr);
+
+  /* Coalesce the adjacent misses of the caller's range.  */
+  ULONGEST wanted = 1;
+  next = addr + line_size;
+  while (wanted < max_lines
+	 && next != 0
+	 && next <= MASK (dcache, last)
+	 && dcache_lookup (dcache, next) == NULL)
     {
-      db = dcache_alloc (dcache, addr);
-
-      if (!dcache_read_line (dcache, db))
-	 return 0;
+      wanted++;
+      next += line_size;
     }
 
-  *ptr = db->data[XFORM (dcache, addr)];
-  return 1;
-}
-
-/* Write the byte at PTR into ADDR in the data cache.
+  /* Grow the readahead window if this miss continues the previous
+     one, otherwise drop it.  */
+  if (addr == dcache->next_miss_addr)
+    dcache->readahead = std::min (std::max (2 * dcache->readahead, 1u),
+				  dcache_readahead_limit);
+  else
+    dcache->readahead = 0;
+
+  ULONGEST ahead = 0;
+  if (next > MASK (dcache, last))
+    while (ahead < dcache->readahead
+	   && wanted + ahead < max_lines
+	   && next != 0
+	   && dcache_lookup (dcache, next) == NULL)
+      {
+	ahead++;
+	next += line_size;
+      }
 
-   The caller should have written the data through to target memory
-   already.
+  gdb::byte_vector buf ((wanted + ahead) * line_size);
+  if (!dcache_read_range (dcache, addr, buf.data (), buf.size ()))
+    {
+      /* Some line of the range wasn't readable.  Don't let the
+	 readahead or the other lines hide the ones that are: fall
+	 back to the line at ADDR alone.  */
+      dcache->readahead = 0;
+      if (wanted + ahead == 1
+	  || !dcache_read_range (dcache, addr, buf.data (), line_size))
+	{
+	  dcache->next_miss_addr = 0;
+	  return 0;
+	}
+      wanted = 1;
+      ahead = 0;
+    }
 
-   If ADDR is not in cache, this function does nothing; writing to an
-   area of memory which wasn't present in the cache doesn't cause it
-   to be loaded in.  */
+  for (ULONGEST i = 0; i < wanted + ahead; ++i)
+    {
+      struct dcache_block *db = dcache_alloc (dcache, addr + i * line_size);
 
-static void
-dcache_poke_byte (DCACHE *dcache, CORE_ADDR addr, const gdb_byte *ptr)
-{
-  struct dcache_block *db = dcache_hit (dcache, addr);
+      memcpy (db->data, buf.data () + i * line_size, line_size);
+      db->readahead = i >= wanted;
+    }
 
-  if (db)
-    db->data[XFORM (dcache, addr)] = *ptr;
-}
+  dcache->misses += wanted;
+  dcache->readahead_lines += ahead;
+  dcache->next_miss_addr = addr + (wanted + ahead) * line_size;
 
-static int
-dcache_splay_tree_compare (splay_tree_key a, splay_tree_key b)
-{
-  if (a > b)
-    return 1;
-  else if (a == b)
-    return 0;
-  else
-    return -1;
+  return wanted;
 }
 
 /* Allocate and initialize a data cache.  */
@@ -447,18 +519,9 @@ dcache_splay_tree_compare (splay_tree_key a, splay_tree_key b)
 DCACHE *
 dcache_init (void)
 {
-  DCACHE *dcache = XNEW (DCACHE);
+  DCACHE *dcache = new dcache_struct;
 
-  dcache->tree = splay_tree_new (dcache_splay_tree_compare,
-				 NULL,
-				 NULL);
-
-  dcache->oldest = NULL;
-  dcache->freelist = NULL;
-  dcache->size = 0;
   dcache->line_size = dcache_line_size;
-  dcache->ptid = null_ptid;
-  dcache->proc_target = nullptr;
 
   return dcache;
 }
@@ -487,15 +550,37 @@ dcache_read_memory_partial (struct target_ops *ops, DCACHE *dcache,
       dcache->proc_target = proc_target;
     }
 
-  for (i = 0; i < len; i++)
+  /* Copy the data line by line.  FILLED is the number of lines from
+     the current one on that were just read from the target, and so
+     are not counted as hits.  */
+  const CORE_ADDR last = memaddr + len - 1;
+  ULONGEST filled = 0;
+  i = 0;
+  while (i < len)
     {
-      if (!dcache_peek_byte (dcache, memaddr + i, myaddr + i))
+      CORE_ADDR addr = memaddr + i;
+      struct dcache_block *db;
+
+      db = filled > 0 ? NULL : dcache_hit (dcache, addr);
+      if (db == NULL)
 	{
-	  /* That failed.  Discard its cache line so we don't have a
-	     partially read line.  */
-	  dcache_invalidate_line (dcache, memaddr + i);
-	  break;
+	  if (filled == 0)
+	    {
+	      filled = dcache_read_lines (dcache, addr, last);
+	      if (filled == 0)
+		break;
+	    }
+	  db = dcache_lookup (dcache, addr);
+	  gdb_assert (db != NULL);
+	  db->refs++;
+	  --filled;
 	}
+
+      ULONGEST offset = XFORM (dcache, addr);
+      ULONGEST chunk = std::min<ULONGEST> (dcache->line_size - offset,
+					   len - i);
+      memcpy (myaddr + i, db->data + offset, chunk);
+      i += chunk;
     }
 
   if (i == 0)
@@ -530,17 +615,52 @@ dcache_update (DCACHE *dcache, enum target_xfer_status status,
 	       CORE_ADDR memaddr, const gdb_byte *myaddr,
 	       ULONGEST len)
 {
-  ULONGEST i;
+  ULONGEST i = 0;
 
-  for (i = 0; i < len; i++)
-    if (status == TARGET_XFER_OK)
-      dcache_poke_byte (dcache, memaddr + i, myaddr + i);
-    else
-      {
-	/* Discard the whole cache line so we don't have a partially
-	   valid line.  */
-	dcache_invalidate_line (dcache, memaddr + i);
-      }
+  /* Writing to an area of memory which wasn't present in the cache
+     doesn't cause it to be loaded in.  */
+  while (i < len)
+    {
+      CORE_ADDR addr = memaddr + i;
+      ULONGEST offset = XFORM (dcache, addr);
+      ULONGEST chunk = std::min<ULONGEST> (dcache->line_size - offset,
+					   len - i);
+
+      if (status == TARGET_XFER_OK)
+	{
+	  struct dcache_block *db = dcache_lookup (dcache, addr);
+
+	  if (db)
+	    memcpy (db->data + offset, myaddr + i, chunk);
+	}
+      else
+	{
+	  /* Discard the whole cache line so we don't have a partially
+	     valid line.  */
+	  dcache_invalidate_line (dcache, addr);
+	}
+
+      i += chunk;
+    }
+}
+
+/* Return the lines of DCACHE, sorted by address.  */
+
+static std::vector<struct dcache_block *>
+dcache_sorted_lines (DCACHE *dcache)
+{
+  std::vector<struct dcache_block *> result;
+
+  result.reserve (dcache->lines.size ());
+  for (const auto &line : dcache->lines)
+    result.push_back (line.second);
+  std::sort (result.begin (), result.end (),
+	     [] (const struct dcache_block *a, const struct dcache_block *b)
+	     {
+	       return a->addr < b->addr;
+	     });
+
+  return result;
 }
 
 /* Print DCACHE line INDEX.  */
@@ -548,9 +668,8 @@ dcache_update (DCACHE *dcache, enum target_xfer_status status,
 static void
 dcache_print_line (DCACHE *dcache, int index)
 {
-  splay_tree_node n;
   struct dcache_block *db;
-  int i, j;
+  int j;
 
   if (dcache == NULL)
     {
@@ -558,22 +677,15 @@ dcache_print_line (DCACHE *dcache, int index)
       return;
     }
 
-  n = splay_tree_min (dcache->tree);
+  std::vector<struct dcache_block *> lines = dcache_sorted_lines (dcache);
 
-  for (i = index; i > 0; --i)
-    {
-      if (!n)
-	break;
-      n = splay_tree_successor (dcache->tree, n->key);
-    }
-
-  if (!n)
+  if (index >= lines.size ())
     {
       gdb_printf (_("No such cache line exists.\n"));
       return;
     }
-    
-  db = (struct dcache_block *) n->value;
+
+  db = lines[index];
 
   gdb_printf (_("Line %d: address %s [%d hits]\n"),
 	      index, paddress (current_inferior ()->arch (), db->addr),
@@ -595,7 +707,6 @@ dcache_print_line (DCACHE *dcache, int index)
 static void
 dcache_info_1 (DCACHE *dcache, const char *exp)
 {
-  splay_tree_node n;
   int i, refcount;
 
   if (exp)
@@ -629,23 +740,27 @@ dcache_info_1 (DCACHE *dcache, const char *exp)
 
   refcount = 0;
 
-  n = splay_tree_min (dcache->tree);
   i = 0;
 
-  while (n)
+  for (struct dcache_block *db : dcache_sorted_lines (dcache))
     {
-      struct dcache_block *db = (struct dcache_block *) n->value;
-
       gdb_printf (_("Line %d: address %s [%d hits]\n"),
 		  i, paddress (current_inferior ()->arch (), db->addr),
 		  db->refs);
       i++;
       refcount += db->refs;
-
-      n = splay_tree_successor (dcache->tree, n->key);
     }
 
   gdb_printf (_("Cache state: %d active lines, %d hits\n"), i, refcount);
+  gdb_printf (_("Lookups: %s hits, %s misses\n"),
+	      pulongest (dcache->hits), pulongest (dcache->misses));
+  gdb_printf (_("Target reads: %s, %s bytes\n"),
+	      pulongest (dcache->target_reads),
+	      pulongest (dcache->bytes_read));
+  gdb_printf (_("Readahead: %s lines, %s used, window %u of %u lines\n"),
+	      pulongest (dcache->readahead_lines),
+	      pulongest (dcache->readahead_hits),
+	      dcache->readahead, dcache_readahead_limit);
 }
 
 static void
@@ -700,8 +815,9 @@ exists only for compatibility reasons."),
 	    _("\
 Print information on the dcache performance.\n\
 Usage: info dcache [LINENUMBER]\n\
-With no arguments, this command prints the cache configuration and a\n\
-summary of each line in the cache.  With an argument, dump\"\n\
+With no arguments, this command prints the cache configuration, a\n\
+summary of each line in the cache, and the hit, miss and readahead\n\
+statistics of the cache.  With an argument, dump\"\n\
 the contents of the given line."));
 
   add_setshow_prefix_cmd ("dcache", class_obscure,
@@ -727,4 +843,14 @@ Show number of dcache lines."),
 			     set_dcache_size,
 			     NULL,
 			     &dcache_set_list, &dcache_show_list);
+  add_setshow_zuinteger_cmd ("readahead-limit", class_obscure,
+			     &dcache_readahead_limit, _("\
+Set the maximum number of dcache lines read ahead."), _("\
+Show the maximum number of dcache lines read ahead."), _("\
+When memory is read sequentially, the dcache reads lines past the end\n\
+of each read, doubling their number with each sequential miss up to\n\
+this limit.  Zero disables readahead."),
+			     NULL,
+			     NULL,
+			     &dcache_set_list, &dcache_show_list);
 }
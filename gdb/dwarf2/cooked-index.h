@@ -262,6 +262,18 @@ class cooked_index_shard
 				 const cooked_index_entry *parent_entry,
 				 dwarf2_per_cu_data *per_cu);
 
+  /* Create a new cooked_index_entry read from the index cache.  Unlike
+     'add', CANONICAL is already known, and the entries must be added
+     in sorted order, so that 'finalize' has nothing left to do.  The
+     parent of the entry is left for the caller to set.  If VISIBLE is
+     false, the entry is only the parent of other entries, and is not
+     entered into the table.  NAME and CANONICAL must outlive this
+     object.  */
+  cooked_index_entry *add_cached (sect_offset die_offset, enum dwarf_tag tag,
+				  cooked_index_flag flags, const char *name,
+				  const char *canonical,
+				  dwarf2_per_cu_data *per_cu, bool visible);
+
   /* Install a new fixed addrmap from the given mutable addrmap.  */
   void install_addrmap (addrmap_mutable *map)
   {
@@ -346,6 +358,9 @@ class cooked_index_shard
   /* The addrmap.  This maps address ranges to dwarf2_per_cu_data
      objects.  */
   addrmap *m_addrmap = nullptr;
+  /* True if the entries were read from the index cache, and so are
+     already canonicalized and sorted.  */
+  bool m_from_cache = false;
   /* Storage for canonical names.  */
   std::vector<gdb::unique_xmalloc_ptr<char>> m_names;
   /* A future that tracks when the 'finalize' method is done.  Note
@@ -424,10 +439,13 @@ class cooked_index : public dwarf_scanner_base
      the index code ensures this itself -- e.g., 'all_entries' will
      wait on the 'finalize' future.  However, on destruction, if an
      index is being written, it's also necessary to wait for that to
-     complete.  */
+     complete.  No index is written for an index that was itself read
+     from the index cache, in which case there is nothing to wait
+     for.  */
   void wait_completely () override
   {
-    m_write_future.wait ();
+    if (m_write_future.valid ())
+      m_write_future.wait ();
   }
 
   /* Start writing to the index cache, if the user asked for this.  */
@@ -447,4 +465,97 @@ class cooked_index : public dwarf_scanner_base
   gdb::future<void> m_write_future;
 };
 
+/* The native format of a cooked index in the index cache.  The file
+   is mapped into memory, and the names are used in place, so all the
+   records are in host byte order and naturally aligned.  A file
+   written by a host with a different byte order or by another version
+   of GDB is ignored.
+
+   The file is made of the header, followed by the unit, entry and
+   range tables, each aligned to 8 bytes, and then the string table.
+   Strings are given as offsets into the string table.  */
+
+#define COOKED_INDEX_CACHE_MAGIC "GDBCOOK"
+#define COOKED_INDEX_CACHE_VERSION 1
+
+/* Used for a missing string, parent or unit.  */
+constexpr uint32_t cooked_index_cache_none = 0xffffffff;
+
+struct cooked_index_cache_header
+{
+  /* COOKED_INDEX_CACHE_MAGIC, zero-terminated.  */
+  char magic[8];
+  /* COOKED_INDEX_CACHE_VERSION.  */
+  uint32_t version;
+  /* The value 1, to check the byte order.  */
+  uint32_t byte_order;
+  /* The version of GDB which wrote the file.  */
+  uint32_t gdb_version;
+  /* The build ID of the dwz file, as a hex string, or
+     cooked_index_cache_none.  */
+  uint32_t dwz_build_id;
+  /* The number of units.  This is the number of units in the
+     objfile, in the same order.  */
+  uint32_t n_units;
+  /* The number of entries.  The first N_VISIBLE entries are those in
+     the index, sorted by canonical name.  The others are only the
+     parents of other entries.  */
+  uint32_t n_entries;
+  uint32_t n_visible;
+  /* The number of address ranges.  */
+  uint32_t n_ranges;
+  /* The file offsets of the tables, and the size of the string
+     table.  */
+  uint64_t units_offset;
+  uint64_t entries_offset;
+  uint64_t ranges_offset;
+  uint64_t strings_offset;
+  uint64_t strings_size;
+};
+
+/* A unit, to check that the objfile matches the index, and to restore
+   what the indexer learned about the unit.  */
+
+struct cooked_index_cache_unit
+{
+  uint64_t sect_off;
+  uint32_t length;
+  /* The language of the unit, as an enum language.  */
+  uint32_t lang;
+  /* The DW_LANG_* of the unit.  */
+  uint16_t dw_lang;
+  /* The DW_UT_* of the unit, or 0 if it is not known.  */
+  uint8_t unit_type;
+  /* Bit 0 is set for a type unit, and bit 1 for a unit from the dwz
+     file.  */
+  uint8_t flags;
+  uint32_t padding;
+};
+
+struct cooked_index_cache_entry
+{
+  uint64_t die_offset;
+  /* The name and canonical name.  */
+  uint32_t name;
+  uint32_t canonical;
+  /* The index of the parent entry, or cooked_index_cache_none.  */
+  uint32_t parent;
+  /* The index of the unit.  */
+  uint32_t unit;
+  uint16_t tag;
+  uint8_t flags;
+  uint8_t padding[5];
+};
+
+/* A range of addresses, END inclusive, belonging to a unit.  Earlier
+   ranges take precedence over later ones.  */
+
+struct cooked_index_cache_range
+{
+  uint64_t start;
+  uint64_t end;
+  uint32_t unit;
+  uint32_t padding;
+};
+
 #endif /* GDB_DWARF2_COOKED_INDEX_H */
@@ -42,10 +42,12 @@
 #include "dwarf2/loc.h"
 #include "dwarf2/frame-tailcall.h"
 #include "gdbsupport/gdb_binary_search.h"
+#include "cli/cli-cmds.h"
 #if GDB_SELF_TEST
 #include "gdbsupport/selftest.h"
 #include "selftest-arch.h"
 #endif
+#include <map>
 #include <unordered_map>
 
 #include <algorithm>
@@ -251,13 +253,18 @@ execute_stack_op (const gdb_byte *exp, ULONGEST len, int addr_size,
 
 /* Execute FDE program from INSN_PTR possibly up to INSN_END or up to inferior
    PC.  Modify FS state accordingly.  Return current INSN_PTR where the
-   execution has stopped, one can resume it on the next call.  */
+   execution has stopped, one can resume it on the next call.
+
+   If ROW_START is not NULL, raise it to the highest address the state
+   was at before reaching PC.  The state found for PC is then the same
+   for any address from *ROW_START up to the address the execution
+   stopped at.  */
 
 static const gdb_byte *
 execute_cfa_program (struct dwarf2_fde *fde, const gdb_byte *insn_ptr,
 		     const gdb_byte *insn_end, struct gdbarch *gdbarch,
 		     CORE_ADDR pc, struct dwarf2_frame_state *fs,
-		     CORE_ADDR text_offset)
+		     CORE_ADDR text_offset, CORE_ADDR *row_start = nullptr)
 {
   int eh_frame_p = fde->eh_frame_p;
   unsigned int bytes_read;
@@ -269,6 +276,9 @@ execute_cfa_program (struct dwarf2_fde *fde, const gdb_byte *insn_ptr,
       uint64_t utmp, reg;
       int64_t offset;
 
+      if (row_start != nullptr)
+	*row_start = std::max (*row_start, fs->pc);
+
       if ((insn & 0xc0) == DW_CFA_advance_loc)
 	fs->pc += (insn & 0x3f) * fs->code_align;
       else if ((insn & 0xc0) == DW_CFA_offset)
@@ -512,6 +522,9 @@ bad CFI data; mismatched DW_CFA_restore_state at %s"),
 	}
     }
 
+  if (row_start != nullptr && fs->pc <= pc)
+    *row_start = std::max (*row_start, fs->pc);
+
   if (fs->initial.reg.empty ())
     {
       /* Don't allow remember/restore between CIE and FDE programs.  */
@@ -889,6 +902,201 @@ struct dwarf2_frame_cache
   struct dwarf2_frame_fn_data *fn_data;
 };
 
+/* A row of the table described by the CFI of an FDE: the rules to
+   compute the CFA and to find the saved registers at the addresses
+   [LOW, HIGH) of the FDE.  Decoding a row means running the CIE initial
+   instructions and the FDE program, so the rows are cached per
+   objfile, and reused when a frame is unwound at an address that was
+   already seen, e.g. by every backtrace of a thread stopped at the same
+   place.  */
+
+struct dwarf2_frame_row
+{
+  /* The FDE and the architecture the row was decoded for.  */
+  const struct dwarf2_fde *fde;
+  struct gdbarch *gdbarch;
+
+  /* The unrelocated addresses the row applies to.  */
+  unrelocated_addr low;
+  unrelocated_addr high;
+
+  /* The unrelocated entry PC of the function, if it is within the FDE.
+     The FDE program is first run up to the entry PC in that case.  */
+  bool entry_pc_p;
+  unrelocated_addr entry_pc;
+
+  /* The CFA offset from the stack pointer at the entry PC, if the CFA
+     is defined that way there.  */
+  bool entry_cfa_sp_offset_p;
+  LONGEST entry_cfa_sp_offset;
+
+  /* The unrelocated address the decoded state is at, for complaints.  */
+  unrelocated_addr pc;
+
+  /* The rules, indexed by DWARF register number, and the CFA rule.  */
+  std::vector<struct dwarf2_frame_state_reg> reg;
+  enum cfa_how_kind cfa_how;
+  LONGEST cfa_offset;
+  ULONGEST cfa_reg;
+  const gdb_byte *cfa_exp;
+
+  /* Whether the CFA is REG - OFFSET, see dwarf2_frame_state.  */
+  bool armcc_cfa_offsets_reversed;
+};
+
+/* The rows decoded for the FDEs of an objfile, by low address.  */
+
+struct dwarf2_frame_row_cache
+{
+  std::map<unrelocated_addr, dwarf2_frame_row> rows;
+
+  /* The number of frames unwound with a cached row, and with a newly
+     decoded one.  */
+  unsigned long hits = 0;
+  unsigned long misses = 0;
+};
+
+static const registry<objfile>::key<dwarf2_frame_row_cache>
+  dwarf2_frame_row_cache_key;
+
+/* Whether decoded rows are cached.  */
+
+static bool dwarf2_frame_row_cache_enabled = true;
+
+/* Decode into ROW the row of FDE, whose relocated initial location is
+   FDE_PC, for the address PC of THIS_FRAME.  If ENTRY_PC is not NULL,
+   it is the relocated entry PC of the function, within FDE.  */
+
+static void
+dwarf2_frame_decode_row (frame_info_ptr this_frame, struct dwarf2_fde *fde,
+			 CORE_ADDR fde_pc, CORE_ADDR pc,
+			 const CORE_ADDR *entry_pc, CORE_ADDR text_offset,
+			 dwarf2_frame_row *row)
+{
+  struct gdbarch *gdbarch = get_frame_arch (this_frame);
+  const gdb_byte *instr;
+
+  /* Allocate and initialize the frame state.  */
+  struct dwarf2_frame_state fs (fde_pc, fde->cie);
+
+  /* Check for "quirks" - known bugs in producers.  */
+  dwarf2_frame_find_quirks (&fs, fde);
+
+  /* The addresses from ROW_START up to where the execution of the
+     programs stops share the state of PC.  */
+  CORE_ADDR row_start = fde_pc;
+
+  /* First decode all the insns in the CIE.  */
+  execute_cfa_program (fde, fde->cie->initial_instructions,
+		       fde->cie->end, gdbarch, pc, &fs, text_offset,
+		       &row_start);
+
+  /* Save the initialized register set.  */
+  fs.initial = fs.regs;
+
+  row->entry_cfa_sp_offset_p = false;
+  row->entry_cfa_sp_offset = 0;
+  if (entry_pc != nullptr)
+    {
+      /* Decode the insns in the FDE up to the entry PC.  */
+      instr = execute_cfa_program (fde, fde->instructions, fde->end, gdbarch,
+				   *entry_pc, &fs, text_offset, &row_start);
+
+      if (fs.regs.cfa_how == CFA_REG_OFFSET
+	  && (dwarf_reg_to_regnum (gdbarch, fs.regs.cfa_reg)
+	      == gdbarch_sp_regnum (gdbarch)))
+	{
+	  row->entry_cfa_sp_offset = fs.regs.cfa_offset;
+	  row->entry_cfa_sp_offset_p = true;
+	}
+    }
+  else
+    instr = fde->instructions;
+
+  /* Then decode the insns in the FDE up to our target PC.  */
+  execute_cfa_program (fde, instr, fde->end, gdbarch, pc, &fs, text_offset,
+		       &row_start);
+
+  row->fde = fde;
+  row->gdbarch = gdbarch;
+  row->low = (unrelocated_addr) (row_start - text_offset);
+  row->high = (fs.pc > pc
+	       ? (unrelocated_addr) (fs.pc - text_offset)
+	       : fde->end_addr ());
+  row->entry_pc_p = entry_pc != nullptr;
+  row->entry_pc = (entry_pc != nullptr
+		   ? (unrelocated_addr) (*entry_pc - text_offset)
+		   : (unrelocated_addr) 0);
+  row->pc = (unrelocated_addr) (fs.pc - text_offset);
+  row->reg = std::move (fs.regs.reg);
+  row->cfa_how = fs.regs.cfa_how;
+  row->cfa_offset = fs.regs.cfa_offset;
+  row->cfa_reg = fs.regs.cfa_reg;
+  row->cfa_exp = fs.regs.cfa_exp;
+  row->armcc_cfa_offsets_reversed = fs.armcc_cfa_offsets_reversed;
+}
+
+/* Return the row of FDE for the address PC of THIS_FRAME, from the
+   cache of OBJFILE if possible, or decoded into LOCAL_ROW.  FDE_PC,
+   ENTRY_PC and TEXT_OFFSET are as for dwarf2_frame_decode_row.  */
+
+static const dwarf2_frame_row *
+dwarf2_frame_find_row (frame_info_ptr this_frame, struct objfile *objfile,
+		       struct dwarf2_fde *fde, CORE_ADDR fde_pc, CORE_ADDR pc,
+		       const CORE_ADDR *entry_pc, CORE_ADDR text_offset,
+		       dwarf2_frame_row *local_row)
+{
+  if (!dwarf2_frame_row_cache_enabled)
+    {
+      dwarf2_frame_decode_row (this_frame, fde, fde_pc, pc, entry_pc,
+			       text_offset, local_row);
+      return local_row;
+    }
+
+  dwarf2_frame_row_cache *row_cache = dwarf2_frame_row_cache_key.get (objfile);
+  if (row_cache == nullptr)
+    row_cache = dwarf2_frame_row_cache_key.emplace (objfile);
+
+  unrelocated_addr seek_pc = (unrelocated_addr) (pc - text_offset);
+  unrelocated_addr seek_entry_pc
+    = (entry_pc != nullptr
+       ? (unrelocated_addr) (*entry_pc - text_offset)
+       : (unrelocated_addr) 0);
+
+  auto it = row_cache->rows.upper_bound (seek_pc);
+  if (it != row_cache->rows.begin ())
+    {
+      const dwarf2_frame_row &row = std::prev (it)->second;
+
+      if (seek_pc < row.high
+	  && row.fde == fde
+	  && row.gdbarch == get_frame_arch (this_frame)
+	  && row.entry_pc_p == (entry_pc != nullptr)
+	  && row.entry_pc == seek_entry_pc)
+	{
+	  row_cache->hits++;
+	  return &row;
+	}
+    }
+
+  row_cache->misses++;
+  dwarf2_frame_decode_row (this_frame, fde, fde_pc, pc, entry_pc,
+			   text_offset, local_row);
+
+  /* When the entry PC is after PC, which can happen for functions with
+     non-contiguous ranges, the row found is not the one of PC, and is
+     not cached.  A row already cached at the same address, for another
+     entry PC, may be in use by a caller, and is not replaced.  */
+  if (local_row->low > seek_pc || seek_pc >= local_row->high)
+    return local_row;
+
+  auto inserted = row_cache->rows.try_emplace (local_row->low,
+					       std::move (*local_row));
+  if (!inserted.second)
+    return local_row;
+  return &inserted.first->second;
+}
+
 static struct dwarf2_frame_cache *
 dwarf2_frame_cache (frame_info_ptr this_frame, void **this_cache)
 {
@@ -897,7 +1105,6 @@ dwarf2_frame_cache (frame_info_ptr this_frame, void **this_cache)
   struct dwarf2_frame_cache *cache;
   struct dwarf2_fde *fde;
   CORE_ADDR entry_pc;
-  const gdb_byte *instr;
 
   if (*this_cache)
     return (struct dwarf2_frame_cache *) *this_cache;
@@ -922,7 +1129,8 @@ dwarf2_frame_cache (frame_info_ptr this_frame, void **this_cache)
      get_frame_address_in_block does just this.  It's not clear how
      reliable the method is though; there is the potential for the
      register state pre-call being different to that on return.  */
-  CORE_ADDR pc1 = get_frame_address_in_block (this_frame);
+  CORE_ADDR pc = get_frame_address_in_block (this_frame);
+  CORE_ADDR pc1 = pc;
 
   /* Find the correct FDE.  */
   fde = dwarf2_frame_find_fde (&pc1, &cache->per_objfile);
@@ -931,69 +1139,42 @@ dwarf2_frame_cache (frame_info_ptr this_frame, void **this_cache)
 
   CORE_ADDR text_offset = cache->per_objfile->objfile->text_section_offset ();
 
-  /* Allocate and initialize the frame state.  */
-  struct dwarf2_frame_state fs (pc1, fde->cie);
-
   cache->addr_size = fde->cie->addr_size;
 
-  /* Check for "quirks" - known bugs in producers.  */
-  dwarf2_frame_find_quirks (&fs, fde);
-
-  /* First decode all the insns in the CIE.  */
-  execute_cfa_program (fde, fde->cie->initial_instructions,
-		       fde->cie->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs,
-		       text_offset);
-
-  /* Save the initialized register set.  */
-  fs.initial = fs.regs;
-
   /* Fetching the entry pc for THIS_FRAME won't necessarily result
      in an address that's within the range of FDE locations.  This
      is due to the possibility of the function occupying non-contiguous
      ranges.  */
-  LONGEST entry_cfa_sp_offset;
-  int entry_cfa_sp_offset_p = 0;
-  if (get_frame_func_if_available (this_frame, &entry_pc)
-      && fde->initial_location <= (unrelocated_addr) (entry_pc - text_offset)
-      && (unrelocated_addr) (entry_pc - text_offset) < fde->end_addr ())
-    {
-      /* Decode the insns in the FDE up to the entry PC.  */
-      instr = execute_cfa_program (fde, fde->instructions, fde->end, gdbarch,
-				   entry_pc, &fs, text_offset);
-
-      if (fs.regs.cfa_how == CFA_REG_OFFSET
-	  && (dwarf_reg_to_regnum (gdbarch, fs.regs.cfa_reg)
-	      == gdbarch_sp_regnum (gdbarch)))
-	{
-	  entry_cfa_sp_offset = fs.regs.cfa_offset;
-	  entry_cfa_sp_offset_p = 1;
-	}
-    }
-  else
-    instr = fde->instructions;
-
-  /* Then decode the insns in the FDE up to our target PC.  */
-  execute_cfa_program (fde, instr, fde->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs,
-		       text_offset);
+  bool entry_pc_p
+    = (get_frame_func_if_available (this_frame, &entry_pc)
+       && fde->initial_location <= (unrelocated_addr) (entry_pc - text_offset)
+       && (unrelocated_addr) (entry_pc - text_offset) < fde->end_addr ());
+
+  /* Find the row of the CFI for PC.  */
+  dwarf2_frame_row local_row;
+  const dwarf2_frame_row *row
+    = dwarf2_frame_find_row (this_frame, cache->per_objfile->objfile, fde,
+			     pc1, pc, entry_pc_p ? &entry_pc : nullptr,
+			     text_offset, &local_row);
+  const std::vector<struct dwarf2_frame_state_reg> &regs = row->reg;
+  ULONGEST retaddr_column = fde->cie->return_address_register;
 
   try
     {
       /* Calculate the CFA.  */
-      switch (fs.regs.cfa_how)
+      switch (row->cfa_how)
 	{
 	case CFA_REG_OFFSET:
-	  cache->cfa = read_addr_from_reg (this_frame, fs.regs.cfa_reg);
-	  if (fs.armcc_cfa_offsets_reversed)
-	    cache->cfa -= fs.regs.cfa_offset;
+	  cache->cfa = read_addr_from_reg (this_frame, row->cfa_reg);
+	  if (row->armcc_cfa_offsets_reversed)
+	    cache->cfa -= row->cfa_offset;
 	  else
-	    cache->cfa += fs.regs.cfa_offset;
+	    cache->cfa += row->cfa_offset;
 	  break;
 
 	case CFA_EXP:
 	  cache->cfa =
-	    execute_stack_op (fs.regs.cfa_exp, fs.regs.cfa_exp_len,
+	    execute_stack_op (row->cfa_exp, row->cfa_exp_len,
 			      cache->addr_size, this_frame, 0, 0,
 			      cache->per_objfile);
 	  break;
@@ -1028,7 +1209,7 @@ dwarf2_frame_cache (frame_info_ptr this_frame, void **this_cache)
   {
     int column;		/* CFI speak for "register number".  */
 
-    for (column = 0; column < fs.regs.reg.size (); column++)
+    for (column = 0; column < regs.size (); column++)
       {
 	/* Use the GDB register number as the destination index.  */
 	int regnum = dwarf_reg_to_regnum (gdbarch, column);
@@ -1048,16 +1229,17 @@ dwarf2_frame_cache (frame_info_ptr this_frame, void **this_cache)
 	   problems when a debug info register falls outside of the
 	   table.  We need a way of iterating through all the valid
 	   DWARF2 register numbers.  */
-	if (fs.regs.reg[column].how == DWARF2_FRAME_REG_UNSPECIFIED)
+	if (regs[column].how == DWARF2_FRAME_REG_UNSPECIFIED)
 	  {
 	    if (cache->reg[regnum].how == DWARF2_FRAME_REG_UNSPECIFIED)
 	      complaint (_("\
 incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 			 gdbarch_register_name (gdbarch, regnum),
-			 paddress (gdbarch, fs.pc));
+			 paddress (gdbarch,
+				   (CORE_ADDR) row->pc + text_offset));
 	  }
 	else
-	  cache->reg[regnum] = fs.regs.reg[column];
+	  cache->reg[regnum] = regs[column];
       }
   }
 
@@ -1071,10 +1253,6 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 	if (cache->reg[regnum].how == DWARF2_FRAME_REG_RA
 	    || cache->reg[regnum].how == DWARF2_FRAME_REG_RA_OFFSET)
 	  {
-	    const std::vector<struct dwarf2_frame_state_reg> &regs
-	      = fs.regs.reg;
-	    ULONGEST retaddr_column = fs.retaddr_column;
-
 	    /* It seems rather bizarre to specify an "empty" column as
 	       the return adress column.  However, this is exactly
 	       what GCC does on some targets.  It turns out that GCC
@@ -1082,7 +1260,7 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 	       register corresponding to the return address column.
 	       Incidentally, that's how we should treat a return
 	       address column specifying "same value" too.  */
-	    if (fs.retaddr_column < fs.regs.reg.size ()
+	    if (retaddr_column < regs.size ()
 		&& regs[retaddr_column].how != DWARF2_FRAME_REG_UNSPECIFIED
 		&& regs[retaddr_column].how != DWARF2_FRAME_REG_SAME_VALUE)
 	      {
@@ -1095,12 +1273,12 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 	      {
 		if (cache->reg[regnum].how == DWARF2_FRAME_REG_RA)
 		  {
-		    cache->reg[regnum].loc.reg = fs.retaddr_column;
+		    cache->reg[regnum].loc.reg = retaddr_column;
 		    cache->reg[regnum].how = DWARF2_FRAME_REG_SAVED_REG;
 		  }
 		else
 		  {
-		    cache->retaddr_reg.loc.reg = fs.retaddr_column;
+		    cache->retaddr_reg.loc.reg = retaddr_column;
 		    cache->retaddr_reg.how = DWARF2_FRAME_REG_SAVED_REG;
 		  }
 	      }
@@ -1108,12 +1286,13 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
       }
   }
 
-  if (fs.retaddr_column < fs.regs.reg.size ()
-      && fs.regs.reg[fs.retaddr_column].how == DWARF2_FRAME_REG_UNDEFINED)
+  if (retaddr_column < regs.size ()
+      && regs[retaddr_column].how == DWARF2_FRAME_REG_UNDEFINED)
     cache->undefined_retaddr = 1;
 
+  LONGEST entry_cfa_sp_offset = row->entry_cfa_sp_offset;
   dwarf2_tailcall_sniffer_first (this_frame, &cache->tailcall_cache,
-				 (entry_cfa_sp_offset_p
+				 (row->entry_cfa_sp_offset_p
 				  ? &entry_cfa_sp_offset : NULL));
 
   return cache;
@@ -2251,6 +2430,38 @@ dwarf2_build_frame_info (struct objfile *objfile)
   set_comp_unit (objfile, unit.release ());
 }
 
+/* The "maintenance info dwarf-unwind-rows" command.  */
+
+static void
+maintenance_info_dwarf_unwind_rows (const char *arg, int from_tty)
+{
+  for (objfile *objfile : current_program_space->objfiles ())
+    {
+      const dwarf2_frame_row_cache *row_cache
+	= dwarf2_frame_row_cache_key.get (objfile);
+      if (row_cache == nullptr)
+	continue;
+
+      unsigned long lookups = row_cache->hits + row_cache->misses;
+      gdb_printf (_("DWARF unwind rows for '%s':\n"),
+		  objfile_name (objfile));
+      gdb_printf (_("  Rows cached: %zu\n"), row_cache->rows.size ());
+      gdb_printf (_("  Frames unwound: %lu\n"), lookups);
+      gdb_printf (_("  Frames unwound with a cached row: %lu (%.1f%%)\n"),
+		  row_cache->hits,
+		  lookups == 0 ? 0.0 : 100.0 * row_cache->hits / lookups);
+    }
+}
+
+static void
+show_dwarf_unwind_row_cache (struct ui_file *file, int from_tty,
+			     struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file,
+	      _("Caching of the DWARF unwind rows is %s.\n"),
+	      value);
+}
+
 /* Handle 'maintenance show dwarf unwinders'.  */
 
 static void
@@ -2279,6 +2490,25 @@ architecture that doesn't support them will have no effect."),
 			   &set_dwarf_cmdlist,
 			   &show_dwarf_cmdlist);
 
+  add_setshow_boolean_cmd ("unwind-row-cache", class_maintenance,
+			   &dwarf2_frame_row_cache_enabled, _("\
+Set whether the decoded DWARF unwind rows are cached."), _("\
+Show whether the decoded DWARF unwind rows are cached."), _("\
+When on, the rules found by running the call frame information program\n\
+of a function for an address are kept, and used again to unwind frames\n\
+at addresses they apply to, instead of running the program again."),
+			   NULL,
+			   show_dwarf_unwind_row_cache,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
+  add_cmd ("dwarf-unwind-rows", class_maintenance,
+	   maintenance_info_dwarf_unwind_rows, _("\
+Print statistics about the cache of DWARF unwind rows.\n\
+For each objfile, this shows the number of rows decoded from the call\n\
+frame information and cached, and how many frames were unwound with them."),
+	   &maintenanceinfolist);
+
 #if GDB_SELF_TEST
   selftests::register_test_foreach_arch ("execute_cfa_program",
 					 selftests::execute_cfa_program_test);
@@ -169,10 +169,14 @@ index_cache::store (dwarf2_per_bfd *per_bfd,
 			 bfd_get_filename (per_bfd->obfd));
 
       /* Write the index itself to the directory, using the build id as the
-	 filename.  */
-      write_dwarf_index (per_bfd, m_dir.c_str (),
-			 ctx.build_id_str.c_str (), dwz_build_id_ptr,
-			 dw_index_kind::GDB_INDEX);
+	 filename.  The native format is preferred, as it can be loaded
+	 without any processing, but it can't describe every objfile.  */
+      if (!write_cooked_index_cache (per_bfd, m_dir.c_str (),
+				     ctx.build_id_str.c_str (),
+				     dwz_build_id_ptr))
+	write_dwarf_index (per_bfd, m_dir.c_str (),
+			   ctx.build_id_str.c_str (), dwz_build_id_ptr,
+			   dw_index_kind::GDB_INDEX);
     }
   catch (const gdb_exception_error &except)
     {
@@ -199,8 +203,8 @@ struct index_cache_resource_mmap final : public index_cache_resource
 /* See dwarf-index-cache.h.  */
 
 gdb::array_view<const gdb_byte>
-index_cache::lookup_gdb_index (const bfd_build_id *build_id,
-			       std::unique_ptr<index_cache_resource> *resource)
+index_cache::lookup (const bfd_build_id *build_id, const char *suffix,
+		     std::unique_ptr<index_cache_resource> *resource)
 {
   if (!enabled ())
     return {};
@@ -212,8 +216,8 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
       return {};
     }
 
-  /* Compute where we would expect a gdb index file for this build id to be.  */
-  std::string filename = make_index_filename (build_id, INDEX4_SUFFIX);
+  /* Compute where we would expect an index file for this build id to be.  */
+  std::string filename = make_index_filename (build_id, suffix);
 
   try
     {
@@ -245,8 +249,8 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
 /* See dwarf-index-cache.h.  This is a no-op on unsupported systems.  */
 
 gdb::array_view<const gdb_byte>
-index_cache::lookup_gdb_index (const bfd_build_id *build_id,
-			       std::unique_ptr<index_cache_resource> *resource)
+index_cache::lookup (const bfd_build_id *build_id, const char *suffix,
+		     std::unique_ptr<index_cache_resource> *resource)
 {
   return {};
 }
@@ -255,6 +259,25 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
 
 /* See dwarf-index-cache.h.  */
 
+gdb::array_view<const gdb_byte>
+index_cache::lookup_gdb_index (const bfd_build_id *build_id,
+			       std::unique_ptr<index_cache_resource> *resource)
+{
+  return lookup (build_id, INDEX4_SUFFIX, resource);
+}
+
+/* See dwarf-index-cache.h.  */
+
+gdb::array_view<const gdb_byte>
+index_cache::lookup_cooked_index
+  (const bfd_build_id *build_id,
+   std::unique_ptr<index_cache_resource> *resource)
+{
+  return lookup (build_id, INDEX_COOKED_SUFFIX, resource);
+}
+
+/* See dwarf-index-cache.h.  */
+
 std::string
 index_cache::make_index_filename (const bfd_build_id *build_id,
 				  const char *suffix) const
@@ -90,6 +90,12 @@ class index_cache
   lookup_gdb_index (const bfd_build_id *build_id,
 		    std::unique_ptr<index_cache_resource> *resource);
 
+  /* Like lookup_gdb_index, but look for a cooked index in the native
+     format of the cache.  See cooked_index_cache_header.  */
+  gdb::array_view<const gdb_byte>
+  lookup_cooked_index (const bfd_build_id *build_id,
+		       std::unique_ptr<index_cache_resource> *resource);
+
   /* Return the number of cache hits.  */
   unsigned int n_hits () const
   { return m_n_hits; }
@@ -114,6 +120,12 @@ class index_cache
 
 private:
 
+  /* Look for the file of the objfile with build id BUILD_ID whose name
+     ends in SUFFIX.  See lookup_gdb_index.  */
+  gdb::array_view<const gdb_byte>
+  lookup (const bfd_build_id *build_id, const char *suffix,
+	  std::unique_ptr<index_cache_resource> *resource);
+
   /* Compute the absolute filename where the index of the objfile with build
      id BUILD_ID will be stored.  SUFFIX is appended at the end of the
      filename.  */
@@ -26,6 +26,7 @@
 #include "gdbsupport/byte-vector.h"
 #include "gdbsupport/filestuff.h"
 #include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/parallel-for.h"
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/scoped_fd.h"
 #include "complaints.h"
@@ -39,10 +40,10 @@
 #include "objfiles.h"
 #include "ada-lang.h"
 #include "dwarf2/tag.h"
+#include "gdbsupport/version.h"
 
 #include <algorithm>
 #include <cmath>
-#include <forward_list>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -137,6 +138,16 @@ class data_buf
     append_uint (sizeof (value), BFD_ENDIAN_LITTLE, value);
   }
 
+  /* Grow SIZE bytes at the end of the buffer.  Returns a pointer to
+     the start of the new block, which the caller must fill in.  The
+     pointer stays valid until the buffer is grown again, so that the
+     block can be filled from several threads.  */
+  gdb_byte *grow (size_t size)
+  {
+    m_vec.resize (m_vec.size () + size);
+    return &*(m_vec.end () - size);
+  }
+
   /* Return the size of the buffer.  */
   virtual size_t size () const
   {
@@ -150,20 +161,12 @@ class data_buf
   }
 
   /* Write the buffer to FILE.  */
-  void file_write (FILE *file) const
+  virtual void file_write (FILE *file) const
   {
     ::file_write (file, m_vec);
   }
 
 private:
-  /* Grow SIZE bytes at the end of the buffer.  Returns a pointer to
-     the start of the new block.  */
-  gdb_byte *grow (size_t size)
-  {
-    m_vec.resize (m_vec.size () + size);
-    return &*(m_vec.end () - size);
-  }
-
   gdb::byte_vector m_vec;
 };
 
@@ -172,7 +175,11 @@ struct symtab_index_entry
 {
   /* The name of the symbol.  */
   const char *name;
+  /* The hash of NAME, as computed by mapped_index_string_hash.  */
+  offset_type name_hash;
   /* The offset of the name in the constant pool.  */
+  offset_type name_offset;
+  /* The offset of the CU vector in the constant pool.  */
   offset_type index_offset;
   /* A sorted vector of the indices of all the CUs that hold an object
      of this name.  */
@@ -191,30 +198,37 @@ struct mapped_symtab
     data.resize (1024);
   }
 
-  /* Minimize each entry in the symbol table, removing duplicates.  */
+  /* Minimize each entry in the symbol table, removing duplicates.
+     The entries are independent, so this is done in parallel.  */
   void minimize ()
   {
-    for (symtab_index_entry &item : data)
-      item.minimize ();
+    gdb::parallel_for_each (1000, data.begin (), data.end (),
+			    [] (std::vector<symtab_index_entry>::iterator start,
+				std::vector<symtab_index_entry>::iterator end)
+			    {
+			      for (auto it = start; it != end; ++it)
+				it->minimize ();
+			    });
   }
 
   offset_type n_elements = 0;
   std::vector<symtab_index_entry> data;
 
-  /* Temporary storage for names.  */
-  auto_obstack m_string_obstack;
+  /* Temporary storage for names, one obstack per worker thread that
+     computed some.  */
+  std::vector<std::unique_ptr<auto_obstack>> m_string_obstacks;
 };
 
-/* Find a slot in SYMTAB for the symbol NAME.  Returns a reference to
-   the slot.
+/* Find a slot in SYMTAB for the symbol NAME, whose hash is HASH.
+   Returns a reference to the slot.
 
    Function is used only during write_hash_table so no index format backward
    compatibility is needed.  */
 
 static symtab_index_entry &
-find_slot (struct mapped_symtab *symtab, const char *name)
+find_slot (struct mapped_symtab *symtab, const char *name, offset_type hash)
 {
-  offset_type index, step, hash = mapped_index_string_hash (INT_MAX, name);
+  offset_type index, step;
 
   index = hash & (symtab->data.size () - 1);
   step = ((hash * 17) & (symtab->data.size () - 1)) | 1;
@@ -241,19 +255,20 @@ hash_expand (struct mapped_symtab *symtab)
   for (auto &it : old_entries)
     if (it.name != NULL)
       {
-	auto &ref = find_slot (symtab, it.name);
+	auto &ref = find_slot (symtab, it.name, it.name_hash);
 	ref = std::move (it);
       }
 }
 
-/* Add an entry to SYMTAB.  NAME is the name of the symbol.
+/* Add an entry to SYMTAB.  NAME is the name of the symbol, and
+   NAME_HASH its hash as computed by mapped_index_string_hash.
    CU_INDEX is the index of the CU in which the symbol appears.
    IS_STATIC is one if the symbol is static, otherwise zero (global).  */
 
 static void
 add_index_entry (struct mapped_symtab *symtab, const char *name,
-		 int is_static, gdb_index_symbol_kind kind,
-		 offset_type cu_index)
+		 offset_type name_hash, int is_static,
+		 gdb_index_symbol_kind kind, offset_type cu_index)
 {
   offset_type cu_index_and_attrs;
 
@@ -261,11 +276,12 @@ add_index_entry (struct mapped_symtab *symtab, const char *name,
   if (4 * symtab->n_elements / 3 >= symtab->data.size ())
     hash_expand (symtab);
 
-  symtab_index_entry &slot = find_slot (symtab, name);
+  symtab_index_entry &slot = find_slot (symtab, name, name_hash);
   if (slot.name == NULL)
     {
       slot.name = name;
-      /* index_offset is set later.  */
+      slot.name_hash = name_hash;
+      /* name_offset and index_offset are set later.  */
     }
 
   cu_index_and_attrs = 0;
@@ -364,11 +380,12 @@ class vector_hasher
   }
 };
 
-/* Write the mapped hash table SYMTAB to the data buffer OUTPUT, with
-   constant pool entries going into the data buffer CPOOL.  */
+/* Lay out the mapped hash table SYMTAB, putting its constant pool
+   entries into the data buffer CPOOL and recording their offsets in
+   the entries.  The table itself is written by symtab_hash_buf.  */
 
 static void
-write_hash_table (mapped_symtab *symtab, data_buf &output, data_buf &cpool)
+write_hash_table (mapped_symtab *symtab, data_buf &cpool)
 {
   {
     /* Elements are sorted vectors of the indices of all the CUs that
@@ -406,33 +423,74 @@ write_hash_table (mapped_symtab *symtab, data_buf &output, data_buf &cpool)
       }
   }
 
-  /* Now write out the hash table.  */
+  /* Now add the names.  */
   std::unordered_map<c_str_view, offset_type, c_str_view_hasher> str_table;
-  for (const auto &entry : symtab->data)
+  for (auto &entry : symtab->data)
     {
-      offset_type str_off, vec_off;
-
-      if (entry.name != NULL)
-	{
-	  const auto insertpair = str_table.emplace (entry.name, cpool.size ());
-	  if (insertpair.second)
-	    cpool.append_cstr0 (entry.name);
-	  str_off = insertpair.first->second;
-	  vec_off = entry.index_offset;
-	}
-      else
-	{
-	  /* While 0 is a valid constant pool index, it is not valid
-	     to have 0 for both offsets.  */
-	  str_off = 0;
-	  vec_off = 0;
-	}
+      if (entry.name == NULL)
+	continue;
 
-      output.append_offset (str_off);
-      output.append_offset (vec_off);
+      const auto insertpair = str_table.emplace (entry.name, cpool.size ());
+      if (insertpair.second)
+	cpool.append_cstr0 (entry.name);
+      entry.name_offset = insertpair.first->second;
     }
 }
 
+/* The symbol table of a .gdb_index, once laid out by
+   write_hash_table.  Its slots are written straight from the
+   mapped_symtab to the file, rather than copied into a buffer
+   first.  */
+
+class symtab_hash_buf : public data_buf
+{
+public:
+  explicit symtab_hash_buf (const mapped_symtab &symtab)
+    : m_symtab (symtab)
+  {}
+
+  /* Each slot is a pair of offsets.  */
+  size_t size () const override
+  {
+    return m_symtab.data.size () * 2 * sizeof (offset_type);
+  }
+
+  void file_write (FILE *file) const override
+  {
+    /* Write the slots in blocks, to keep the number of calls to
+       fwrite down.  */
+    gdb_byte block[512 * 2 * sizeof (offset_type)];
+    size_t used = 0;
+
+    for (const symtab_index_entry &entry : m_symtab.data)
+      {
+	/* While 0 is a valid constant pool index, it is not valid
+	   to have 0 for both offsets.  */
+	offset_type str_off = entry.name != NULL ? entry.name_offset : 0;
+	offset_type vec_off = entry.name != NULL ? entry.index_offset : 0;
+
+	store_unsigned_integer (&block[used], sizeof (offset_type),
+				BFD_ENDIAN_LITTLE, str_off);
+	used += sizeof (offset_type);
+	store_unsigned_integer (&block[used], sizeof (offset_type),
+				BFD_ENDIAN_LITTLE, vec_off);
+	used += sizeof (offset_type);
+
+	if (used == sizeof (block))
+	  {
+	    ::file_write (file, block, used);
+	    used = 0;
+	  }
+      }
+
+    if (used > 0)
+      ::file_write (file, block, used);
+  }
+
+private:
+  const mapped_symtab &m_symtab;
+};
+
 using cu_index_map
   = std::unordered_map<const dwarf2_per_cu_data *, unsigned int>;
 
@@ -546,69 +604,43 @@ class debug_names
   /* Is this symbol from DW_TAG_compile_unit or DW_TAG_type_unit?  */
   enum class unit_kind { cu, tu };
 
-  /* Insert one symbol.  */
-  void insert (const cooked_index_entry *entry)
+  /* Insert all the symbols of TABLE.  Their names are computed in
+     parallel, and then entered in the order of the index.  */
+  void insert (cooked_index *table)
   {
-    const auto it = m_cu_index_htab.find (entry->per_cu);
-    gdb_assert (it != m_cu_index_htab.cend ());
-    const char *name = entry->full_name (&m_string_obstack);
-
-    /* This is incorrect but it mirrors gdb's historical behavior; and
-       because the current .debug_names generation is also incorrect,
-       it seems better to follow what was done before, rather than
-       introduce a mismatch between the newer and older gdb.  */
-    dwarf_tag tag = entry->tag;
-    if (tag != DW_TAG_typedef && tag_is_type (tag))
-      tag = DW_TAG_structure_type;
-    else if (tag == DW_TAG_enumerator || tag == DW_TAG_constant)
-      tag = DW_TAG_variable;
-
-    int cu_index = it->second;
-    bool is_static = (entry->flags & IS_STATIC) != 0;
-    unit_kind kind = (entry->per_cu->is_debug_types
-		      ? unit_kind::tu
-		      : unit_kind::cu);
-
-    if (entry->per_cu->lang () == language_ada)
+    std::vector<const cooked_index_entry *> entries;
+    for (const cooked_index_entry *entry : table->all_entries ())
+      entries.push_back (entry);
+
+    /* main_name is computed lazily and may not be called from a
+       worker thread.  */
+    const char *ada_main_name = main_name ();
+
+    using entry_iterator = std::vector<const cooked_index_entry *>::iterator;
+    std::vector<symbol_batch> batches
+      = gdb::parallel_for_each (1000, entries.begin (), entries.end (),
+				[&] (entry_iterator start, entry_iterator end)
+	{
+	  symbol_batch batch;
+	  batch.storage.reset (new auto_obstack);
+	  batch.symbols.reserve (end - start);
+	  for (entry_iterator it = start; it != end; ++it)
+	    compute_symbols (*it, ada_main_name, &batch);
+	  return batch;
+	});
+
+    for (symbol_batch &batch : batches)
       {
-	/* We want to ensure that the Ada main function's name appears
-	   verbatim in the index.  However, this name will be of the
-	   form "_ada_mumble", and will be rewritten by ada_decode.
-	   So, recognize it specially here and add it to the index by
-	   hand.  */
-	if (strcmp (main_name (), name) == 0)
+	for (const auto &symbol : batch.symbols)
 	  {
 	    const auto insertpair
-	      = m_name_to_value_set.emplace (c_str_view (name),
+	      = m_name_to_value_set.emplace (c_str_view (symbol.first),
 					     std::set<symbol_value> ());
 	    std::set<symbol_value> &value_set = insertpair.first->second;
-	    value_set.emplace (symbol_value (tag, cu_index, is_static, kind));
+	    value_set.insert (symbol.second);
 	  }
-
-	/* In order for the index to work when read back into gdb, it
-	   has to supply a funny form of the name: it should be the
-	   encoded name, with any suffixes stripped.  Using the
-	   ordinary encoded name will not work properly with the
-	   searching logic in find_name_components_bounds; nor will
-	   using the decoded name.  Furthermore, an Ada "verbatim"
-	   name (of the form "<MumBle>") must be entered without the
-	   angle brackets.  Note that the current index is unusual,
-	   see PR symtab/24820 for details.  */
-	std::string decoded = ada_decode (name);
-	if (decoded[0] == '<')
-	  name = (char *) obstack_copy0 (&m_string_obstack,
-					 decoded.c_str () + 1,
-					 decoded.length () - 2);
-	else
-	  name = obstack_strdup (&m_string_obstack,
-				 ada_encode (decoded.c_str ()));
+	m_string_obstacks.push_back (std::move (batch.storage));
       }
-
-    const auto insertpair
-      = m_name_to_value_set.emplace (c_str_view (name),
-				     std::set<symbol_value> ());
-    std::set<symbol_value> &value_set = insertpair.first->second;
-    value_set.emplace (symbol_value (tag, cu_index, is_static, kind));
   }
 
   /* Build all the tables.  All symbols must be already inserted.
@@ -625,40 +657,58 @@ class debug_names
     m_name_table_string_offs.reserve (name_count);
     m_name_table_entry_offs.reserve (name_count);
 
-    /* Map each hash of symbol to its name and value.  */
+    /* Hash all the names in parallel.  */
+    using name_iterator = decltype (m_name_to_value_set)::const_iterator;
     struct hash_it_pair
     {
       uint32_t hash;
-      decltype (m_name_to_value_set)::const_iterator it;
+      name_iterator it;
     };
-    std::vector<std::forward_list<hash_it_pair>> bucket_hash;
-    bucket_hash.resize (m_bucket_table.size ());
-    for (decltype (m_name_to_value_set)::const_iterator it
-	   = m_name_to_value_set.cbegin ();
+    std::vector<hash_it_pair> hashed (name_count);
+    size_t ix = 0;
+    for (name_iterator it = m_name_to_value_set.cbegin ();
 	 it != m_name_to_value_set.cend ();
 	 ++it)
+      hashed[ix++].it = it;
+    gdb::parallel_for_each (1000, hashed.begin (), hashed.end (),
+			    [] (std::vector<hash_it_pair>::iterator start,
+				std::vector<hash_it_pair>::iterator end)
       {
-	const char *const name = it->first.c_str ();
-	const uint32_t hash = dwarf5_djb_hash (name);
-	hash_it_pair hashitpair;
-	hashitpair.hash = hash;
-	hashitpair.it = it;
-	auto &slot = bucket_hash[hash % bucket_hash.size()];
-	slot.push_front (std::move (hashitpair));
-      }
-    for (size_t bucket_ix = 0; bucket_ix < bucket_hash.size (); ++bucket_ix)
+	for (auto iter = start; iter != end; ++iter)
+	  iter->hash = dwarf5_djb_hash (iter->it->first.c_str ());
+      });
+
+    /* Group the names by bucket.  This is a counting sort: BUCKET_START
+       ends up holding the index in BUCKET_HASH of the first name of
+       each bucket.  */
+    const size_t n_buckets = m_bucket_table.size ();
+    std::vector<size_t> bucket_start (n_buckets + 1);
+    for (const hash_it_pair &hashitpair : hashed)
+      ++bucket_start[hashitpair.hash % n_buckets + 1];
+    for (size_t bucket_ix = 0; bucket_ix < n_buckets; ++bucket_ix)
+      bucket_start[bucket_ix + 1] += bucket_start[bucket_ix];
+    std::vector<hash_it_pair> bucket_hash (name_count);
+    {
+      std::vector<size_t> next (bucket_start.begin (),
+				bucket_start.end () - 1);
+      for (const hash_it_pair &hashitpair : hashed)
+	bucket_hash[next[hashitpair.hash % n_buckets]++] = hashitpair;
+    }
+
+    for (size_t bucket_ix = 0; bucket_ix < n_buckets; ++bucket_ix)
       {
-	const std::forward_list<hash_it_pair> &hashitlist
-	  = bucket_hash[bucket_ix];
-	if (hashitlist.empty ())
+	const size_t first = bucket_start[bucket_ix];
+	const size_t last = bucket_start[bucket_ix + 1];
+	if (first == last)
 	  continue;
 	uint32_t &bucket_slot = m_bucket_table[bucket_ix];
 	/* The hashes array is indexed starting at 1.  */
 	store_unsigned_integer (reinterpret_cast<gdb_byte *> (&bucket_slot),
 				sizeof (bucket_slot), m_dwarf5_byte_order,
 				m_hash_table.size () + 1);
-	for (const hash_it_pair &hashitpair : hashitlist)
+	for (size_t i = first; i < last; ++i)
 	  {
+	    const hash_it_pair &hashitpair = bucket_hash[i];
 	    m_hash_table.push_back (0);
 	    store_unsigned_integer (reinterpret_cast<gdb_byte *>
 							(&m_hash_table.back ()),
@@ -1008,6 +1058,73 @@ class debug_names
     offset_vec_tmpl<OffsetSize> m_name_table_entry_offs;
   };
 
+  /* The names and values computed by one worker thread, along with
+     the storage for the names it had to build.  */
+  struct symbol_batch
+  {
+    std::vector<std::pair<const char *, symbol_value>> symbols;
+    std::unique_ptr<auto_obstack> storage;
+  };
+
+  /* Compute the names and values ENTRY must be entered with, and add
+     them to BATCH.  ADA_MAIN_NAME is the result of main_name.  This
+     is called from worker threads.  */
+  void compute_symbols (const cooked_index_entry *entry,
+			const char *ada_main_name, symbol_batch *batch) const
+  {
+    const auto it = m_cu_index_htab.find (entry->per_cu);
+    gdb_assert (it != m_cu_index_htab.cend ());
+    struct obstack *storage = batch->storage.get ();
+    const char *name = entry->full_name (storage);
+
+    /* This is incorrect but it mirrors gdb's historical behavior; and
+       because the current .debug_names generation is also incorrect,
+       it seems better to follow what was done before, rather than
+       introduce a mismatch between the newer and older gdb.  */
+    dwarf_tag tag = entry->tag;
+    if (tag != DW_TAG_typedef && tag_is_type (tag))
+      tag = DW_TAG_structure_type;
+    else if (tag == DW_TAG_enumerator || tag == DW_TAG_constant)
+      tag = DW_TAG_variable;
+
+    int cu_index = it->second;
+    bool is_static = (entry->flags & IS_STATIC) != 0;
+    unit_kind kind = (entry->per_cu->is_debug_types
+		      ? unit_kind::tu
+		      : unit_kind::cu);
+    symbol_value value (tag, cu_index, is_static, kind);
+
+    if (entry->per_cu->lang () == language_ada)
+      {
+	/* We want to ensure that the Ada main function's name appears
+	   verbatim in the index.  However, this name will be of the
+	   form "_ada_mumble", and will be rewritten by ada_decode.
+	   So, recognize it specially here and add it to the index by
+	   hand.  */
+	if (strcmp (ada_main_name, name) == 0)
+	  batch->symbols.emplace_back (name, value);
+
+	/* In order for the index to work when read back into gdb, it
+	   has to supply a funny form of the name: it should be the
+	   encoded name, with any suffixes stripped.  Using the
+	   ordinary encoded name will not work properly with the
+	   searching logic in find_name_components_bounds; nor will
+	   using the decoded name.  Furthermore, an Ada "verbatim"
+	   name (of the form "<MumBle>") must be entered without the
+	   angle brackets.  Note that the current index is unusual,
+	   see PR symtab/24820 for details.  */
+	std::string decoded = ada_decode (name);
+	if (decoded[0] == '<')
+	  name = (char *) obstack_copy0 (storage,
+					 decoded.c_str () + 1,
+					 decoded.length () - 2);
+	else
+	  name = obstack_strdup (storage, ada_encode (decoded.c_str ()));
+      }
+
+    batch->symbols.emplace_back (name, value);
+  }
+
   /* Store value of each symbol.  */
   std::unordered_map<c_str_view, std::set<symbol_value>, c_str_view_hasher>
     m_name_to_value_set;
@@ -1038,8 +1155,9 @@ class debug_names
   /* .debug_names entry pool.  */
   data_buf m_entry_pool;
 
-  /* Temporary storage for Ada names.  */
-  auto_obstack m_string_obstack;
+  /* Temporary storage for names, one obstack per worker thread that
+     computed some.  */
+  std::vector<std::unique_ptr<auto_obstack>> m_string_obstacks;
 
   cu_index_map m_cu_index_htab;
 };
@@ -1137,61 +1255,148 @@ write_gdbindex_1 (FILE *out_file,
   assert_file_size (out_file, total_len);
 }
 
-/* Write the contents of the internal "cooked" index.  */
+/* A symbol of the cooked index, ready to be entered in the .gdb_index
+   symbol table.  */
+
+struct gdb_index_symbol
+{
+  const char *name;
+  offset_type name_hash;
+  bool is_static;
+  gdb_index_symbol_kind kind;
+  offset_type cu_index;
+};
+
+/* The symbols computed by one worker thread, along with the storage
+   for the names it had to build.  */
+
+struct gdb_index_symbol_batch
+{
+  std::vector<gdb_index_symbol> symbols;
+  std::unique_ptr<auto_obstack> storage;
+};
+
+/* Compute the .gdb_index symbol for ENTRY, storing any name that has
+   to be built on STORAGE.  Return false if ENTRY does not belong in
+   the index.  This is called from worker threads.  */
+
+static bool
+compute_gdb_index_symbol (const cooked_index_entry *entry,
+			  const cu_index_map &cu_index_htab,
+			  struct obstack *storage, gdb_index_symbol *result)
+{
+  const auto it = cu_index_htab.find (entry->per_cu);
+  gdb_assert (it != cu_index_htab.cend ());
+
+  const char *name = entry->full_name (storage);
+
+  if (entry->per_cu->lang () == language_ada)
+    {
+      /* In order for the index to work when read back into
+	 gdb, it has to use the encoded name, with any
+	 suffixes stripped.  */
+      std::string encoded = ada_encode (name, false);
+      name = obstack_strdup (storage, encoded.c_str ());
+    }
+  else if (entry->per_cu->lang () == language_cplus
+	   && (entry->flags & IS_LINKAGE) != 0)
+    {
+      /* GDB never put C++ linkage names into .gdb_index.  The
+	 theory here is that a linkage name will normally be in
+	 the minimal symbols anyway, so including it in the index
+	 is usually redundant -- and the cases where it would not
+	 be redundant are rare and not worth supporting.  */
+      return false;
+    }
+  else if ((entry->flags & IS_TYPE_DECLARATION) != 0)
+    {
+      /* Don't add type declarations to the index.  */
+      return false;
+    }
+
+  gdb_index_symbol_kind kind;
+  if (entry->tag == DW_TAG_subprogram)
+    kind = GDB_INDEX_SYMBOL_KIND_FUNCTION;
+  else if (entry->tag == DW_TAG_variable
+	   || entry->tag == DW_TAG_constant
+	   || entry->tag == DW_TAG_enumerator)
+    kind = GDB_INDEX_SYMBOL_KIND_VARIABLE;
+  else if (entry->tag == DW_TAG_module
+	   || entry->tag == DW_TAG_common_block)
+    kind = GDB_INDEX_SYMBOL_KIND_OTHER;
+  else
+    kind = GDB_INDEX_SYMBOL_KIND_TYPE;
+
+  result->name = name;
+  result->name_hash = mapped_index_string_hash (INT_MAX, name);
+  result->is_static = (entry->flags & IS_STATIC) != 0;
+  result->kind = kind;
+  result->cu_index = it->second;
+  return true;
+}
+
+/* Write the contents of the internal "cooked" index.  The names and
+   their hashes are computed in parallel; the symbols are then entered
+   in SYMTAB in the order of the index, so that the output does not
+   depend on the number of threads.  */
 
 static void
 write_cooked_index (cooked_index *table,
 		    const cu_index_map &cu_index_htab,
 		    struct mapped_symtab *symtab)
 {
+  std::vector<const cooked_index_entry *> entries;
   for (const cooked_index_entry *entry : table->all_entries ())
-    {
-      const auto it = cu_index_htab.find (entry->per_cu);
-      gdb_assert (it != cu_index_htab.cend ());
+    entries.push_back (entry);
 
-      const char *name = entry->full_name (&symtab->m_string_obstack);
+  using entry_iterator = std::vector<const cooked_index_entry *>::iterator;
+  std::vector<gdb_index_symbol_batch> batches
+    = gdb::parallel_for_each (1000, entries.begin (), entries.end (),
+			      [&] (entry_iterator start, entry_iterator end)
+      {
+	gdb_index_symbol_batch batch;
+	batch.storage.reset (new auto_obstack);
+	batch.symbols.reserve (end - start);
+	for (entry_iterator it = start; it != end; ++it)
+	  {
+	    gdb_index_symbol symbol;
+	    if (compute_gdb_index_symbol (*it, cu_index_htab,
+					  batch.storage.get (), &symbol))
+	      batch.symbols.push_back (symbol);
+	  }
+	return batch;
+      });
 
-      if (entry->per_cu->lang () == language_ada)
-	{
-	  /* In order for the index to work when read back into
-	     gdb, it has to use the encoded name, with any
-	     suffixes stripped.  */
-	  std::string encoded = ada_encode (name, false);
-	  name = obstack_strdup (&symtab->m_string_obstack,
-				 encoded.c_str ());
-	}
-      else if (entry->per_cu->lang () == language_cplus
-	       && (entry->flags & IS_LINKAGE) != 0)
-	{
-	  /* GDB never put C++ linkage names into .gdb_index.  The
-	     theory here is that a linkage name will normally be in
-	     the minimal symbols anyway, so including it in the index
-	     is usually redundant -- and the cases where it would not
-	     be redundant are rare and not worth supporting.  */
-	  continue;
-	}
-      else if ((entry->flags & IS_TYPE_DECLARATION) != 0)
-	{
-	  /* Don't add type declarations to the index.  */
-	  continue;
-	}
+  for (gdb_index_symbol_batch &batch : batches)
+    {
+      for (const gdb_index_symbol &symbol : batch.symbols)
+	add_index_entry (symtab, symbol.name, symbol.name_hash,
+			 symbol.is_static, symbol.kind, symbol.cu_index);
+      symtab->m_string_obstacks.push_back (std::move (batch.storage));
+    }
+}
 
-      gdb_index_symbol_kind kind;
-      if (entry->tag == DW_TAG_subprogram)
-	kind = GDB_INDEX_SYMBOL_KIND_FUNCTION;
-      else if (entry->tag == DW_TAG_variable
-	       || entry->tag == DW_TAG_constant
-	       || entry->tag == DW_TAG_enumerator)
-	kind = GDB_INDEX_SYMBOL_KIND_VARIABLE;
-      else if (entry->tag == DW_TAG_module
-	       || entry->tag == DW_TAG_common_block)
-	kind = GDB_INDEX_SYMBOL_KIND_OTHER;
-      else
-	kind = GDB_INDEX_SYMBOL_KIND_TYPE;
+/* Fill in the unit lists of an index in parallel.  SLOTS[I] is where
+   the record of the I-th unit of PER_BFD goes, in a buffer that has
+   already been grown to its final size; WRITE_RECORD stores the
+   record of one unit there.  */
 
-      add_index_entry (symtab, name, (entry->flags & IS_STATIC) != 0,
-		       kind, it->second);
-    }
+static void
+write_unit_records
+  (dwarf2_per_bfd *per_bfd, const std::vector<gdb_byte *> &slots,
+   gdb::function_view<void (const dwarf2_per_cu_data *, gdb_byte *)>
+     write_record)
+{
+  gdb_assert (slots.size () == per_bfd->all_units.size ());
+
+  auto first = per_bfd->all_units.begin ();
+  using unit_iterator = decltype (first);
+  gdb::parallel_for_each (1000, first, per_bfd->all_units.end (),
+			  [&] (unit_iterator start, unit_iterator end)
+    {
+      for (unit_iterator it = start; it != end; ++it)
+	write_record (it->get (), slots[it - first]);
+    });
 }
 
 /* Write shortcut information.  */
@@ -1248,6 +1453,11 @@ write_gdbindex (dwarf2_per_bfd *per_bfd, cooked_index *table,
   /* The CU list is already sorted, so we don't need to do additional
      work here.  */
 
+  const size_t cu_record_size = 2 * 8;
+  const size_t tu_record_size = 3 * 8;
+  size_t n_objfile_units = 0;
+  size_t n_dwz_units = 0;
+  size_t n_type_units = 0;
   int counter = 0;
   for (int i = 0; i < per_bfd->all_units.size (); ++i)
     {
@@ -1259,28 +1469,54 @@ write_gdbindex (dwarf2_per_bfd *per_bfd, cooked_index *table,
       /* See enhancement PR symtab/30838.  */
       gdb_assert (!(per_cu->is_dwz && per_cu->is_debug_types));
 
-      /* The all_units list contains CUs read from the objfile as well as
-	 from the eventual dwz file.  We need to place the entry in the
-	 corresponding index.  */
-      data_buf &cu_list = (per_cu->is_debug_types
-			   ? types_cu_list
-			   : per_cu->is_dwz ? dwz_cu_list : objfile_cu_list);
-      cu_list.append_uint (8, BFD_ENDIAN_LITTLE,
-			   to_underlying (per_cu->sect_off));
       if (per_cu->is_debug_types)
-	{
-	  signatured_type *sig_type = (signatured_type *) per_cu;
-	  cu_list.append_uint (8, BFD_ENDIAN_LITTLE,
-			       to_underlying (sig_type->type_offset_in_tu));
-	  cu_list.append_uint (8, BFD_ENDIAN_LITTLE,
-			       sig_type->signature);
-	}
+	++n_type_units;
+      else if (per_cu->is_dwz)
+	++n_dwz_units;
       else
-	cu_list.append_uint (8, BFD_ENDIAN_LITTLE, per_cu->length ());
+	++n_objfile_units;
 
       ++counter;
     }
 
+  /* The all_units list contains CUs read from the objfile as well as
+     from the eventual dwz file.  We need to place the entry in the
+     corresponding index.  Find the place of each unit's record, then
+     fill them all in parallel.  */
+  gdb_byte *objfile_slot = objfile_cu_list.grow (n_objfile_units
+						 * cu_record_size);
+  gdb_byte *dwz_slot = dwz_cu_list.grow (n_dwz_units * cu_record_size);
+  gdb_byte *types_slot = types_cu_list.grow (n_type_units * tu_record_size);
+  std::vector<gdb_byte *> slots;
+  slots.reserve (per_bfd->all_units.size ());
+  for (const auto &per_cu : per_bfd->all_units)
+    {
+      gdb_byte *&slot = (per_cu->is_debug_types
+			 ? types_slot
+			 : per_cu->is_dwz ? dwz_slot : objfile_slot);
+      slots.push_back (slot);
+      slot += per_cu->is_debug_types ? tu_record_size : cu_record_size;
+    }
+
+  write_unit_records (per_bfd, slots,
+		      [] (const dwarf2_per_cu_data *per_cu, gdb_byte *slot)
+    {
+      store_unsigned_integer (slot, 8, BFD_ENDIAN_LITTLE,
+			      to_underlying (per_cu->sect_off));
+      if (per_cu->is_debug_types)
+	{
+	  const signatured_type *sig_type
+	    = (const signatured_type *) per_cu;
+	  store_unsigned_integer (slot + 8, 8, BFD_ENDIAN_LITTLE,
+				  to_underlying (sig_type->type_offset_in_tu));
+	  store_unsigned_integer (slot + 16, 8, BFD_ENDIAN_LITTLE,
+				  sig_type->signature);
+	}
+      else
+	store_unsigned_integer (slot + 8, 8, BFD_ENDIAN_LITTLE,
+				per_cu->length ());
+    });
+
   write_cooked_index (table, cu_index_htab, &symtab);
 
   /* Dump the address map.  */
@@ -1292,11 +1528,12 @@ write_gdbindex (dwarf2_per_bfd *per_bfd, cooked_index *table,
      lists.  */
   symtab.minimize ();
 
-  data_buf symtab_vec, constant_pool;
+  data_buf constant_pool;
   if (symtab.n_elements == 0)
     symtab.data.resize (0);
 
-  write_hash_table (&symtab, symtab_vec, constant_pool);
+  write_hash_table (&symtab, constant_pool);
+  symtab_hash_buf symtab_vec (symtab);
 
   data_buf shortcuts;
   write_shortcuts_table (table, shortcuts, constant_pool);
@@ -1331,6 +1568,7 @@ write_debug_names (dwarf2_per_bfd *per_bfd, cooked_index *table,
   data_buf cu_list;
   data_buf types_cu_list;
   debug_names nametable (per_bfd, dwarf5_is_dwarf64, dwarf5_byte_order);
+  const int offset_size = nametable.dwarf5_offset_size ();
   int counter = 0;
   int types_counter = 0;
   for (int i = 0; i < per_bfd->all_units.size (); ++i)
@@ -1338,12 +1576,8 @@ write_debug_names (dwarf2_per_bfd *per_bfd, cooked_index *table,
       dwarf2_per_cu_data *per_cu = per_bfd->all_units[i].get ();
 
       int &this_counter = per_cu->is_debug_types ? types_counter : counter;
-      data_buf &this_list = per_cu->is_debug_types ? types_cu_list : cu_list;
 
       nametable.add_cu (per_cu, this_counter);
-      this_list.append_uint (nametable.dwarf5_offset_size (),
-			     dwarf5_byte_order,
-			     to_underlying (per_cu->sect_off));
       ++this_counter;
     }
 
@@ -1351,8 +1585,27 @@ write_debug_names (dwarf2_per_bfd *per_bfd, cooked_index *table,
   gdb_assert (counter == per_bfd->all_comp_units.size ());
   gdb_assert (types_counter == per_bfd->all_type_units.size ());
 
-  for (const cooked_index_entry *entry : table->all_entries ())
-    nametable.insert (entry);
+  /* Find the place of each unit's offset, then fill them all in
+     parallel.  */
+  gdb_byte *cu_slot = cu_list.grow (counter * offset_size);
+  gdb_byte *types_slot = types_cu_list.grow (types_counter * offset_size);
+  std::vector<gdb_byte *> slots;
+  slots.reserve (per_bfd->all_units.size ());
+  for (const auto &per_cu : per_bfd->all_units)
+    {
+      gdb_byte *&slot = per_cu->is_debug_types ? types_slot : cu_slot;
+      slots.push_back (slot);
+      slot += offset_size;
+    }
+
+  write_unit_records (per_bfd, slots,
+		      [&] (const dwarf2_per_cu_data *per_cu, gdb_byte *slot)
+    {
+      store_unsigned_integer (slot, offset_size, dwarf5_byte_order,
+			      to_underlying (per_cu->sect_off));
+    });
+
+  nametable.insert (table);
 
   nametable.build ();
 
@@ -1522,6 +1775,179 @@ write_dwarf_index (dwarf2_per_bfd *per_bfd, const char *dir,
     dwz_index_wip->finalize ();
 }
 
+/* Helper struct for building the address ranges of the native cooked
+   index format.  This is like addrmap_index_data, but the ranges are
+   inclusive and kept in host order.  */
+
+struct cooked_range_data
+{
+  cooked_range_data (std::vector<cooked_index_cache_range> &ranges_)
+    : ranges (ranges_)
+  {}
+
+  std::vector<cooked_index_cache_range> &ranges;
+
+  int operator() (CORE_ADDR start_addr, const void *obj)
+  {
+    if (previous_valid && start_addr > previous_start)
+      add (start_addr - 1);
+
+    const dwarf2_per_cu_data *per_cu
+      = static_cast<const dwarf2_per_cu_data *> (obj);
+    previous_start = start_addr;
+    previous_valid = per_cu != nullptr;
+    if (previous_valid)
+      previous_unit = per_cu->index;
+
+    return 0;
+  }
+
+  /* Add the pending range, ending at END.  */
+  void add (CORE_ADDR end)
+  {
+    cooked_index_cache_range range {};
+    range.start = previous_start;
+    range.end = end;
+    range.unit = previous_unit;
+    ranges.push_back (range);
+  }
+
+  bool previous_valid = false;
+  unsigned int previous_unit = 0;
+  CORE_ADDR previous_start = 0;
+};
+
+/* See index-write.h.  */
+
+bool
+write_cooked_index_cache (dwarf2_per_bfd *per_bfd, const char *dir,
+			  const char *basename, const char *dwz_build_id)
+{
+  if (per_bfd->index_table == nullptr)
+    error (_("No debugging symbols"));
+  cooked_index *table = per_bfd->index_table->index_for_writing ();
+
+  /* Type units are only reachable through the signatured_types table,
+     and skeleton units through their DWO files.  Neither can be
+     rebuilt from the list of units alone.  */
+  if (!per_bfd->all_type_units.empty ()
+      || per_bfd->dwo_files != nullptr
+      || per_bfd->dwp_file != nullptr)
+    return false;
+
+  std::unordered_map<c_str_view, uint32_t, c_str_view_hasher> str_table;
+  data_buf strings;
+  auto add_string = [&] (const char *str) -> uint32_t
+    {
+      if (str == nullptr)
+	return cooked_index_cache_none;
+      auto insertpair = str_table.emplace (c_str_view (str),
+					   (uint32_t) strings.size ());
+      if (insertpair.second)
+	strings.append_cstr0 (str);
+      return insertpair.first->second;
+    };
+
+  cooked_index_cache_header header {};
+  memcpy (header.magic, COOKED_INDEX_CACHE_MAGIC, sizeof (header.magic));
+  header.version = COOKED_INDEX_CACHE_VERSION;
+  header.byte_order = 1;
+  header.gdb_version = add_string (version);
+  header.dwz_build_id = add_string (dwz_build_id);
+
+  std::vector<cooked_index_cache_unit> units;
+  units.reserve (per_bfd->all_units.size ());
+  for (const auto &per_cu : per_bfd->all_units)
+    {
+      cooked_index_cache_unit unit {};
+      unit.sect_off = to_underlying (per_cu->sect_off);
+      unit.length = per_cu->length ();
+      unit.lang = per_cu->lang (false);
+      unit.dw_lang = per_cu->dw_lang ();
+      unit.unit_type = per_cu->unit_type (false);
+      unit.flags = ((per_cu->is_debug_types ? 1 : 0)
+		    | (per_cu->is_dwz ? 2 : 0));
+      units.push_back (unit);
+    }
+
+  /* The entries are written in a single sorted table, so that the
+     reader does not need to sort them again.  Parents which are not
+     themselves in the table, like those made up for GNAT names, are
+     written after the sorted ones.  */
+  std::vector<const cooked_index_entry *> entries;
+  for (const cooked_index_entry *entry : table->all_entries ())
+    entries.push_back (entry);
+  std::stable_sort (entries.begin (), entries.end (),
+		    [] (const cooked_index_entry *a,
+			const cooked_index_entry *b)
+		    {
+		      return *a < *b;
+		    });
+  header.n_visible = entries.size ();
+
+  std::unordered_map<const cooked_index_entry *, uint32_t> entry_index;
+  for (const cooked_index_entry *entry : entries)
+    entry_index.emplace (entry, entry_index.size ());
+  for (size_t i = 0; i < entries.size (); ++i)
+    for (const cooked_index_entry *parent = entries[i]->parent_entry;
+	 parent != nullptr;
+	 parent = parent->parent_entry)
+      if (entry_index.emplace (parent, entries.size ()).second)
+	entries.push_back (parent);
+      else
+	break;
+
+  std::vector<cooked_index_cache_entry> out_entries;
+  out_entries.reserve (entries.size ());
+  for (const cooked_index_entry *entry : entries)
+    {
+      cooked_index_cache_entry out {};
+      out.die_offset = to_underlying (entry->die_offset);
+      out.name = add_string (entry->name);
+      out.canonical = add_string (entry->canonical);
+      out.parent = (entry->parent_entry == nullptr
+		    ? cooked_index_cache_none
+		    : entry_index.at (entry->parent_entry));
+      out.unit = entry->per_cu->index;
+      out.tag = entry->tag;
+      out.flags = entry->flags;
+      out_entries.push_back (out);
+    }
+
+  std::vector<cooked_index_cache_range> ranges;
+  for (const addrmap *map : table->get_addrmaps ())
+    {
+      cooked_range_data range_data (ranges);
+      map->foreach (range_data);
+      if (range_data.previous_valid)
+	range_data.add ((CORE_ADDR) -1);
+    }
+
+  header.n_units = units.size ();
+  header.n_entries = out_entries.size ();
+  header.n_ranges = ranges.size ();
+  header.units_offset = sizeof (header);
+  header.entries_offset = (header.units_offset
+			   + units.size () * sizeof (units[0]));
+  header.ranges_offset = (header.entries_offset
+			  + out_entries.size () * sizeof (out_entries[0]));
+  header.strings_offset = (header.ranges_offset
+			   + ranges.size () * sizeof (ranges[0]));
+  header.strings_size = strings.size ();
+
+  index_wip_file wip (dir, basename, INDEX_COOKED_SUFFIX);
+  FILE *out_file = wip.out_file.get ();
+  file_write (out_file, &header, sizeof (header));
+  file_write (out_file, units);
+  file_write (out_file, out_entries);
+  file_write (out_file, ranges);
+  strings.file_write (out_file);
+  assert_file_size (out_file, header.strings_offset + header.strings_size);
+  wip.finalize ();
+
+  return true;
+}
+
 /* Implementation of the `save gdb-index' command.
 
    Note that the .gdb_index file format used by this command is
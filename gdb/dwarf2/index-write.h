@@ -36,4 +36,14 @@ extern void write_dwarf_index
   (dwarf2_per_bfd *per_bfd, const char *dir, const char *basename,
    const char *dwz_basename, dw_index_kind index_kind);
 
+/* Write the cooked index of PER_BFD to the index cache directory DIR,
+   in the native format described by cooked_index_cache_header.
+   BASENAME is the build ID of the objfile, and DWZ_BUILD_ID is the
+   build ID of its dwz file, or NULL.  Return false, without writing
+   anything, if the index can't be represented in this format.  */
+
+extern bool write_cooked_index_cache
+  (dwarf2_per_bfd *per_bfd, const char *dir, const char *basename,
+   const char *dwz_build_id);
+
 #endif /* DWARF_INDEX_WRITE_H */
@@ -96,6 +96,12 @@
 #include "split-name.h"
 #include "gdbsupport/parallel-for.h"
 #include "gdbsupport/thread-pool.h"
+#include "gdbsupport/version.h"
+#include "inferior.h"
+#include "gdbthread.h"
+#include "regcache.h"
+#include "target.h"
+#include "observable.h"
 
 /* When == 1, print basic high level tracing messages.
    When > 1, be more verbose.
@@ -606,6 +612,15 @@ class cutu_reader : public die_reader_specs
      for dummy CUs.  */
   void keep ();
 
+  /* Release the new CU, transferring ownership to the caller instead.
+     This is used when reading a CU in a worker thread, where the
+     chain can't be used.  This cannot be done for dummy CUs.  */
+  std::unique_ptr<dwarf2_cu> release_cu ()
+  {
+    gdb_assert (!dummy_p);
+    return std::move (m_new_cu);
+  }
+
   /* Release the abbrev table, transferring ownership to the
      caller.  */
   abbrev_table_up release_abbrev_table ()
@@ -733,6 +748,19 @@ struct field_info
    sizes of up to at least twenty will improve startup time for
    typical inter-CU-reference binaries, at an obvious memory cost.  */
 static int dwarf_max_cache_age = 5;
+
+/* When true, the DIEs of the units which are likely to be expanded
+   soon are read in worker threads.  */
+static bool dwarf_background_expansion = false;
+
+/* When true, a C++ class defined identically in several units of an
+   objfile gets a single type.  */
+static bool dwarf_unify_types = true;
+
+/* The maximum number of units being read in the background for an
+   objfile.  */
+static const size_t max_read_ahead = 64;
+
 static void
 show_dwarf_max_cache_age (struct ui_file *file, int from_tty,
 			  struct cmd_list_element *c, const char *value)
@@ -753,6 +781,10 @@ static void build_type_psymtabs_reader (cutu_reader *reader,
 
 static void dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile);
 
+static void dwarf2_start_psymtabs (dwarf2_per_objfile *per_objfile);
+
+static void finish_background_psymtabs (dwarf2_per_objfile *per_objfile);
+
 static void var_decode_location (struct attribute *attr,
 				 struct symbol *sym,
 				 struct dwarf2_cu *cu);
@@ -1791,10 +1823,18 @@ dw2_instantiate_symtab (dwarf2_per_cu_data *per_cu,
 {
   if (!per_objfile->symtab_set_p (per_cu))
     {
-      free_cached_comp_units freer (per_objfile);
-      scoped_restore decrementer = increment_reading_symtab ();
-      dw2_do_instantiate_symtab (per_cu, per_objfile, skip_partial);
-      process_cu_includes (per_objfile);
+      auto start = std::chrono::steady_clock::now ();
+
+      {
+	free_cached_comp_units freer (per_objfile);
+	scoped_restore decrementer = increment_reading_symtab ();
+	dw2_do_instantiate_symtab (per_cu, per_objfile, skip_partial);
+	process_cu_includes (per_objfile);
+      }
+
+      per_objfile->expansion_stats.n_expanded++;
+      per_objfile->expansion_stats.expand_time
+	+= std::chrono::steady_clock::now () - start;
     }
 
   return per_objfile->get_symtab (per_cu);
@@ -2051,6 +2091,8 @@ dwarf2_base_index_functions::print_stats (struct objfile *objfile,
     }
   gdb_printf (_("  Number of read CUs: %d\n"), total - count);
   gdb_printf (_("  Number of unread CUs: %d\n"), count);
+  gdb_printf (_("  Number of C++ classes sharing a type: %zu\n"),
+	      per_objfile->num_unified_dies ());
 }
 
 void
@@ -2874,6 +2916,35 @@ dw2_expand_symtabs_matching_one
   return true;
 }
 
+/* Expand the units UNITS in order, as dw2_expand_symtabs_matching_one
+   does, reading the next few units in the background while each one is
+   expanded.  */
+
+static bool
+dw2_expand_units_reading_ahead
+  (gdb::array_view<dwarf2_per_cu_data * const> units,
+   dwarf2_per_objfile *per_objfile,
+   gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+{
+  size_t window = std::min (gdb::thread_pool::g_thread_pool->thread_count (),
+			    max_read_ahead / 2);
+
+  for (size_t i = 0; i < units.size (); ++i)
+    {
+      QUIT;
+
+      for (size_t j = i + 1; j <= i + window && j < units.size (); ++j)
+	per_objfile->read_ahead (units[j]);
+
+      if (!dw2_expand_symtabs_matching_one (units[i], per_objfile,
+					    file_matcher, expansion_notify))
+	return false;
+    }
+
+  return true;
+}
+
 /* See read.h.  */
 
 void
@@ -3203,6 +3274,8 @@ get_gdb_index_contents_from_cache_dwz (objfile *obj, dwz_file *dwz)
 
 static quick_symbol_functions_up make_cooked_index_funcs ();
 
+static bool dwarf2_read_cooked_index_cache (dwarf2_per_objfile *per_objfile);
+
 /* See dwarf2/public.h.  */
 
 void
@@ -3266,7 +3339,16 @@ dwarf2_initialize_objfile (struct objfile *objfile)
       return;
     }
 
-  /* ... otherwise, try to find the index in the index cache.  */
+  /* ... otherwise, try to find the index in the index cache, preferably
+     in the native format.  */
+  if (dwarf2_read_cooked_index_cache (per_objfile))
+    {
+      dwarf_read_debug_printf ("found cooked index from cache");
+      global_index_cache.hit ();
+      objfile->qf.push_front (per_bfd->index_table->make_quick_functions ());
+      return;
+    }
+
   if (dwarf2_read_gdb_index (per_objfile,
 			     get_gdb_index_contents_from_cache,
 			     get_gdb_index_contents_from_cache_dwz))
@@ -3289,8 +3371,17 @@ static void
 dwarf2_build_psymtabs (struct objfile *objfile)
 {
   dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
 
-  if (per_objfile->per_bfd->index_table != nullptr)
+  /* The index may be built in the background for this objfile, or
+     for another one sharing the BFD.  */
+  if (per_bfd->index_builder != nullptr)
+    {
+      finish_background_psymtabs (per_bfd->index_builder);
+      return;
+    }
+
+  if (per_bfd->index_table != nullptr)
     return;
 
   try
@@ -4921,11 +5012,37 @@ process_skeletonless_type_units (dwarf2_per_objfile *per_objfile,
     }
 }
 
-/* Build the partial symbol table by doing a quick pass through the
-   .debug_info and .debug_abbrev sections.  */
+/* Set the name of the main function of PER_OBJFILE from the "main"
+   entry of INDEX, if it has one.  */
 
 static void
-dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
+set_main_name_from_index (dwarf2_per_objfile *per_objfile,
+			  const cooked_index *index)
+{
+  const cooked_index_entry *main_entry = index->get_main ();
+  if (main_entry != nullptr)
+    {
+      /* We only do this for names not requiring canonicalization.  At
+	 this point in the process names have not been canonicalized.
+	 However, currently, languages that require this step also do
+	 not use DW_AT_main_subprogram.  An assert is appropriate here
+	 because this filtering is done in get_main.  */
+      enum language lang = main_entry->per_cu->lang ();
+      gdb_assert (!language_requires_canonicalization (lang));
+      const char *full_name
+	= main_entry->full_name (&per_objfile->per_bfd->obstack, true);
+      set_objfile_main_name (per_objfile->objfile, full_name, lang);
+    }
+}
+
+/* Subroutine of dwarf2_build_psymtabs_hard and
+   dwarf2_start_psymtabs.  Do the work that has to be done on the main
+   thread before the units of PER_OBJFILE are indexed: find the units,
+   and index the type units in INDEX_STORAGE.  */
+
+static void
+start_building_psymtabs (dwarf2_per_objfile *per_objfile,
+			 cooked_index_storage *index_storage)
 {
   struct objfile *objfile = per_objfile->objfile;
   dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
@@ -4935,17 +5052,106 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
 
   per_bfd->map_info_sections (objfile);
 
-  cooked_index_storage index_storage;
   create_all_units (per_objfile);
-  build_type_psymtabs (per_objfile, &index_storage);
-  std::vector<std::unique_ptr<cooked_index_shard>> indexes;
+  build_type_psymtabs (per_objfile, index_storage);
 
   per_bfd->quick_file_names_table
     = create_quick_file_names_table (per_bfd->all_units.size ());
   if (!per_bfd->debug_aranges.empty ())
     read_addrmap_from_aranges (per_objfile, &per_bfd->debug_aranges,
-			       index_storage.get_addrmap ());
+			       index_storage->get_addrmap ());
+}
+
+/* The result of indexing some units in a worker thread: a cooked index,
+   and a vector of errors that should be printed.  The latter is done
+   because GDB's I/O system is not thread-safe.  run_on_main_thread
+   could be used, but that would mean the messages are printed after
+   the prompt, which looks weird.  */
+
+using index_units_result = std::pair<std::unique_ptr<cooked_index_shard>,
+				     std::vector<gdb_exception>>;
+
+/* Index the units of PER_OBJFILE from FIRST to LAST (excluded) in
+   all_units.  This runs in a worker thread.  */
+
+static index_units_result
+index_units (dwarf2_per_objfile *per_objfile, size_t first, size_t last)
+{
+  std::vector<gdb_exception> errors;
+  cooked_index_storage thread_storage;
+  for (size_t i = first; i < last; ++i)
+    {
+      dwarf2_per_cu_data *per_cu = per_objfile->per_bfd->get_cu (i);
+      try
+	{
+	  process_psymtab_comp_unit (per_cu, per_objfile, &thread_storage);
+	}
+      catch (gdb_exception &except)
+	{
+	  errors.push_back (std::move (except));
+	}
+    }
+  return index_units_result (thread_storage.release (), std::move (errors));
+}
+
+/* Subroutine of dwarf2_build_psymtabs_hard and dwarf2_build_psymtabs.
+   Make the cooked index of PER_OBJFILE from RESULTS, the indexes of its
+   units, and INDEX_STORAGE, and print the errors found while indexing
+   them.  */
+
+static void
+finish_building_psymtabs (dwarf2_per_objfile *per_objfile,
+			  cooked_index_storage *index_storage,
+			  std::vector<index_units_result> &results)
+{
+  struct objfile *objfile = per_objfile->objfile;
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  std::vector<std::unique_ptr<cooked_index_shard>> indexes;
+
+  /* Only show a given exception a single time.  */
+  std::unordered_set<gdb_exception> seen_exceptions;
+  for (auto &one_result : results)
+    {
+      indexes.push_back (std::move (one_result.first));
+      for (auto &one_exc : one_result.second)
+	if (seen_exceptions.insert (one_exc).second)
+	  exception_print (gdb_stderr, one_exc);
+    }
+
+  /* This has to wait until we read the CUs, we need the list of DWOs.  */
+  process_skeletonless_type_units (per_objfile, index_storage);
+
+  if (dwarf_read_debug > 0)
+    print_tu_stats (per_objfile);
+
+  indexes.push_back (index_storage->release ());
+  indexes.shrink_to_fit ();
+
+  cooked_index *vec = new cooked_index (std::move (indexes));
+  per_bfd->index_table.reset (vec);
+
+  /* Cannot start writing the index entry until after the
+     'index_table' member has been set.  */
+  vec->start_writing_index (per_bfd);
+
+  set_main_name_from_index (per_objfile, vec);
 
+  dwarf_read_debug_printf ("Done building psymtabs of %s",
+			   objfile_name (objfile));
+}
+
+/* Build the partial symbol table by doing a quick pass through the
+   .debug_info and .debug_abbrev sections.  */
+
+static void
+dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+
+  cooked_index_storage index_storage;
+  start_building_psymtabs (per_objfile, &index_storage);
+
+  std::vector<index_units_result> results;
   {
     /* Ensure that complaints are handled correctly.  */
     complaint_interceptor complaint_handler;
@@ -4959,79 +5165,342 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
       };
     auto task_size = gdb::make_function_view (task_size_);
 
-    /* Each thread returns a pair holding a cooked index, and a vector
-       of errors that should be printed.  The latter is done because
-       GDB's I/O system is not thread-safe.  run_on_main_thread could be
-       used, but that would mean the messages are printed after the
-       prompt, which looks weird.  */
-    using result_type = std::pair<std::unique_ptr<cooked_index_shard>,
-				  std::vector<gdb_exception>>;
-    std::vector<result_type> results
-      = gdb::parallel_for_each (1, per_bfd->all_units.begin (),
-				per_bfd->all_units.end (),
-				[=] (iter_type iter, iter_type end)
+    iter_type first = per_bfd->all_units.begin ();
+    results = gdb::parallel_for_each (1, per_bfd->all_units.begin (),
+				      per_bfd->all_units.end (),
+				      [=] (iter_type iter, iter_type end)
       {
-	std::vector<gdb_exception> errors;
-	cooked_index_storage thread_storage;
-	for (; iter != end; ++iter)
-	  {
-	    dwarf2_per_cu_data *per_cu = iter->get ();
-	    try
-	      {
-		process_psymtab_comp_unit (per_cu, per_objfile,
-					   &thread_storage);
-	      }
-	    catch (gdb_exception &except)
-	      {
-		errors.push_back (std::move (except));
-	      }
-	  }
-	return result_type (thread_storage.release (), std::move (errors));
+	return index_units (per_objfile, iter - first, end - first);
       }, task_size);
+  }
 
-    /* Only show a given exception a single time.  */
-    std::unordered_set<gdb_exception> seen_exceptions;
-    for (auto &one_result : results)
-      {
-	indexes.push_back (std::move (one_result.first));
-	for (auto &one_exc : one_result.second)
-	  if (seen_exceptions.insert (one_exc).second)
-	    exception_print (gdb_stderr, one_exc);
-      }
+  finish_building_psymtabs (per_objfile, &index_storage, results);
+}
+
+/* The minimum size of the units indexed by one task posted by
+   dwarf2_start_psymtabs.  */
+
+static const size_t min_background_index_task_size = 256 * 1024;
+
+/* The cooked index of an objfile being built in the background, see
+   dwarf2_start_psymtabs.  */
+
+struct cooked_index_build
+{
+  /* The storage for the type units, which were indexed on the main
+     thread.  */
+  cooked_index_storage index_storage;
+
+  /* The tasks indexing the other units.  */
+  std::vector<gdb::future<index_units_result>> tasks;
+
+  /* True if finding the units failed.  The error was printed, and the
+     objfile is left without an index, as dwarf2_build_psymtabs does.  */
+  bool failed = false;
+
+  /* Wait for all the tasks to complete.  */
+  void wait () const
+  {
+    for (const auto &task : tasks)
+      task.wait ();
   }
+};
 
-  /* This has to wait until we read the CUs, we need the list of DWOs.  */
-  process_skeletonless_type_units (per_objfile, &index_storage);
+/* Start building the cooked index of PER_OBJFILE in the background:
+   find its units on this thread, then post tasks indexing them to the
+   thread pool and return.  dwarf2_build_psymtabs waits for the tasks
+   and completes the index.  Unlike dwarf2_build_psymtabs_hard, this
+   lets the units of several objfiles be indexed at the same time.  */
 
-  if (dwarf_read_debug > 0)
-    print_tu_stats (per_objfile);
+static void
+dwarf2_start_psymtabs (dwarf2_per_objfile *per_objfile)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
 
-  indexes.push_back (index_storage.release ());
-  indexes.shrink_to_fit ();
+  if (per_bfd->index_table != nullptr
+      || per_bfd->index_builder != nullptr
+      || gdb::thread_pool::g_thread_pool->thread_count () == 0)
+    return;
 
-  cooked_index *vec = new cooked_index (std::move (indexes));
-  per_bfd->index_table.reset (vec);
+  auto build = gdb::make_unique<cooked_index_build> ();
 
-  /* Cannot start writing the index entry until after the
-     'index_table' member has been set.  */
-  vec->start_writing_index (per_bfd);
+  try
+    {
+      start_building_psymtabs (per_objfile, &build->index_storage);
+    }
+  catch (const gdb_exception_error &except)
+    {
+      exception_print (gdb_stderr, except);
+      build->failed = true;
+      per_objfile->index_build = std::move (build);
+      per_bfd->index_builder = per_objfile;
+      return;
+    }
 
-  const cooked_index_entry *main_entry = vec->get_main ();
-  if (main_entry != nullptr)
+  /* Split the units in one task per worker thread, of about the same
+     size.  Small objfiles, which are most shared libraries, get a
+     single task.  */
+  size_t n_units = per_bfd->all_units.size ();
+  size_t total_size = 0;
+  for (const auto &per_cu : per_bfd->all_units)
+    total_size += per_cu->length ();
+  size_t n_threads = gdb::thread_pool::g_thread_pool->thread_count ();
+  size_t task_size = std::max (total_size / n_threads,
+			       (size_t) min_background_index_task_size);
+
+  size_t first = 0;
+  while (first < n_units)
+    {
+      size_t last = first;
+      size_t size = 0;
+      while (last < n_units && (size < task_size || last == first))
+	size += per_bfd->get_cu (last++)->length ();
+
+      build->tasks.push_back
+	(gdb::thread_pool::g_thread_pool->post_task<index_units_result>
+	   ([=] ()
+	    {
+	      return index_units (per_objfile, first, last);
+	    }));
+      first = last;
+    }
+
+  per_objfile->index_build = std::move (build);
+  per_bfd->index_builder = per_objfile;
+}
+
+/* Complete the cooked index started in the background for PER_OBJFILE
+   by dwarf2_start_psymtabs.  */
+
+static void
+finish_background_psymtabs (dwarf2_per_objfile *per_objfile)
+{
+  std::unique_ptr<cooked_index_build> build
+    = std::move (per_objfile->index_build);
+  per_objfile->per_bfd->index_builder = nullptr;
+
+  /* The tasks use the index storage of BUILD, so wait for all of them
+     before anything can throw.  */
+  build->wait ();
+  if (build->failed)
+    return;
+
+  /* The complaints issued by the tasks are handled by the
+     scoped_background_symbol_reading that started them.  This is
+     called while reading the partial symbols, so the objfile is left
+     without an index on any exception, as dwarf2_build_psymtabs does
+     on errors, rather than with an index half built.  */
+  try
     {
-      /* We only do this for names not requiring canonicalization.  At
-	 this point in the process names have not been canonicalized.
-	 However, currently, languages that require this step also do
-	 not use DW_AT_main_subprogram.  An assert is appropriate here
-	 because this filtering is done in get_main.  */
-      enum language lang = main_entry->per_cu->lang ();
-      gdb_assert (!language_requires_canonicalization (lang));
-      const char *full_name = main_entry->full_name (&per_bfd->obstack, true);
-      set_objfile_main_name (objfile, full_name, lang);
+      std::vector<index_units_result> results;
+      for (auto &task : build->tasks)
+	results.push_back (task.get ());
+      finish_building_psymtabs (per_objfile, &build->index_storage,
+				results);
+    }
+  catch (const gdb_exception &except)
+    {
+      exception_print (gdb_stderr, except);
     }
+}
 
-  dwarf_read_debug_printf ("Done building psymtabs of %s",
-			   objfile_name (objfile));
+/* Try to read the cooked index of PER_OBJFILE from the index cache,
+   in the native format written by write_cooked_index_cache.  On
+   success, set the index table of the per_bfd and return true.  The
+   mapped file is kept, as the names of the entries point into it.
+   Otherwise, leave PER_OBJFILE untouched and return false.  */
+
+static bool
+dwarf2_read_cooked_index_cache (dwarf2_per_objfile *per_objfile)
+{
+  struct objfile *objfile = per_objfile->objfile;
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+
+  const bfd_build_id *build_id = build_id_bfd_get (objfile->obfd.get ());
+  if (build_id == nullptr)
+    return false;
+
+  std::unique_ptr<index_cache_resource> resource;
+  gdb::array_view<const gdb_byte> contents
+    = global_index_cache.lookup_cooked_index (build_id, &resource);
+  if (contents.empty ())
+    return false;
+
+  auto reject = [=] (const char *why)
+    {
+      dwarf_read_debug_printf ("ignoring cached cooked index of %s: %s",
+			       objfile_name (objfile), why);
+      return false;
+    };
+
+  const gdb_byte *base = contents.data ();
+  const size_t size = contents.size ();
+  if (size < sizeof (cooked_index_cache_header))
+    return reject ("file too small");
+
+  const auto *header = (const cooked_index_cache_header *) base;
+  if (memcmp (header->magic, COOKED_INDEX_CACHE_MAGIC,
+	      sizeof (header->magic)) != 0
+      || header->version != COOKED_INDEX_CACHE_VERSION
+      || header->byte_order != 1)
+    return reject ("unsupported format");
+
+  /* Check that a table of COUNT elements of ELT_SIZE bytes at OFFSET
+     is aligned and within the file.  */
+  auto table_ok = [=] (uint64_t offset, uint64_t count, size_t elt_size)
+    {
+      return (offset % 8 == 0
+	      && offset <= size
+	      && count <= (size - offset) / elt_size);
+    };
+
+  if (!table_ok (header->units_offset, header->n_units,
+		 sizeof (cooked_index_cache_unit))
+      || !table_ok (header->entries_offset, header->n_entries,
+		    sizeof (cooked_index_cache_entry))
+      || !table_ok (header->ranges_offset, header->n_ranges,
+		    sizeof (cooked_index_cache_range))
+      || !table_ok (header->strings_offset, header->strings_size, 1)
+      || header->strings_size == 0
+      || base[header->strings_offset + header->strings_size - 1] != '\0'
+      || header->n_visible > header->n_entries)
+    return reject ("corrupt header");
+
+  const char *strings = (const char *) base + header->strings_offset;
+  auto get_string = [=] (uint32_t offset) -> const char *
+    {
+      if (offset >= header->strings_size)
+	return nullptr;
+      return strings + offset;
+    };
+
+  const char *gdb_version = get_string (header->gdb_version);
+  if (gdb_version == nullptr || strcmp (gdb_version, version) != 0)
+    return reject ("written by another version of GDB");
+
+  const char *dwz_build_id = get_string (header->dwz_build_id);
+  const dwz_file *dwz = dwarf2_get_dwz_file (per_bfd);
+  if (dwz != nullptr)
+    {
+      const bfd_build_id *id = build_id_bfd_get (dwz->dwz_bfd.get ());
+      if (id == nullptr
+	  || dwz_build_id == nullptr
+	  || build_id_to_string (id) != dwz_build_id)
+	return reject ("dwz file does not match");
+    }
+  else if (dwz_build_id != nullptr)
+    return reject ("dwz file does not match");
+
+  const auto *units
+    = (const cooked_index_cache_unit *) (base + header->units_offset);
+  const auto *entries
+    = (const cooked_index_cache_entry *) (base + header->entries_offset);
+  const auto *ranges
+    = (const cooked_index_cache_range *) (base + header->ranges_offset);
+
+  for (uint32_t i = 0; i < header->n_units; ++i)
+    if (units[i].lang >= nr_languages)
+      return reject ("corrupt unit");
+  for (uint32_t i = 0; i < header->n_entries; ++i)
+    if (entries[i].unit >= header->n_units
+	|| get_string (entries[i].name) == nullptr
+	|| (entries[i].parent != cooked_index_cache_none
+	    && entries[i].parent >= header->n_entries))
+      return reject ("corrupt entry");
+  for (uint32_t i = 0; i < header->n_ranges; ++i)
+    if (ranges[i].unit >= header->n_units
+	|| ranges[i].start > ranges[i].end)
+      return reject ("corrupt range");
+
+  /* The units are read from the objfile as usual, and only checked
+     against the file.  On a mismatch, undo this so that the objfile
+     can be indexed from scratch.  */
+  auto reset_units = [=] ()
+    {
+      per_bfd->all_units.clear ();
+      per_bfd->all_comp_units = {};
+      per_bfd->all_type_units = {};
+      per_bfd->signatured_types.reset ();
+      per_bfd->tu_stats = {};
+    };
+
+  try
+    {
+      per_bfd->map_info_sections (objfile);
+      create_all_units (per_objfile);
+    }
+  catch (const gdb_exception_error &except)
+    {
+      reset_units ();
+      return reject (except.what ());
+    }
+
+  bool match = (per_bfd->all_units.size () == header->n_units
+		&& per_bfd->tu_stats.nr_tus == 0);
+  for (uint32_t i = 0; match && i < header->n_units; ++i)
+    {
+      dwarf2_per_cu_data *per_cu = per_bfd->all_units[i].get ();
+      match = (units[i].sect_off == to_underlying (per_cu->sect_off)
+	       && units[i].length == per_cu->length ()
+	       && units[i].flags == ((per_cu->is_debug_types ? 1 : 0)
+				     | (per_cu->is_dwz ? 2 : 0)));
+    }
+  if (!match)
+    {
+      reset_units ();
+      return reject ("units do not match");
+    }
+
+  for (uint32_t i = 0; i < header->n_units; ++i)
+    {
+      dwarf2_per_cu_data *per_cu = per_bfd->all_units[i].get ();
+      if (units[i].unit_type == 0)
+	continue;
+      per_cu->set_unit_type ((dwarf_unit_type) units[i].unit_type);
+      if (units[i].lang != language_unknown)
+	per_cu->set_lang ((enum language) units[i].lang,
+			  (dwarf_source_language) units[i].dw_lang);
+    }
+
+  std::unique_ptr<cooked_index_shard> shard (new cooked_index_shard);
+  std::vector<cooked_index_entry *> new_entries (header->n_entries);
+  for (uint32_t i = 0; i < header->n_entries; ++i)
+    {
+      const cooked_index_cache_entry &entry = entries[i];
+      const char *name = get_string (entry.name);
+      const char *canonical = get_string (entry.canonical);
+      new_entries[i]
+	= shard->add_cached ((sect_offset) entry.die_offset,
+			     (dwarf_tag) entry.tag,
+			     (cooked_index_flag_enum) entry.flags,
+			     name, canonical == nullptr ? name : canonical,
+			     per_bfd->all_units[entry.unit].get (),
+			     i < header->n_visible);
+    }
+  for (uint32_t i = 0; i < header->n_entries; ++i)
+    if (entries[i].parent != cooked_index_cache_none)
+      new_entries[i]->parent_entry = new_entries[entries[i].parent];
+
+  /* Earlier ranges take precedence, which is what set_empty does when
+     they are added in order.  */
+  addrmap_mutable mutable_map;
+  for (uint32_t i = 0; i < header->n_ranges; ++i)
+    mutable_map.set_empty (ranges[i].start, ranges[i].end,
+			   per_bfd->all_units[ranges[i].unit].get ());
+  shard->install_addrmap (&mutable_map);
+
+  per_bfd->quick_file_names_table
+    = create_quick_file_names_table (per_bfd->all_units.size ());
+
+  cooked_index::vec_type indexes;
+  indexes.push_back (std::move (shard));
+  cooked_index *vec = new cooked_index (std::move (indexes));
+  per_bfd->index_table.reset (vec);
+  per_bfd->index_cache_res = std::move (resource);
+
+  set_main_name_from_index (per_objfile, vec);
+
+  return true;
 }
 
 static void
@@ -5536,28 +6005,14 @@ process_queue (dwarf2_per_objfile *per_objfile)
 			   objfile_name (per_objfile->objfile));
 }
 
-/* Load the DIEs associated with PER_CU into memory.
-
-   In some cases, the caller, while reading partial symbols, will need to load
-   the full symbols for the CU for some reason.  It will already have a
-   dwarf2_cu object for THIS_CU and pass it as EXISTING_CU, so it can be re-used
-   rather than creating a new one.  */
+/* Read all the DIEs of the unit being read by READER into its CU, and
+   prepare the CU for symbol reading.  */
 
 static void
-load_full_comp_unit (dwarf2_per_cu_data *this_cu,
-		     dwarf2_per_objfile *per_objfile,
-		     dwarf2_cu *existing_cu,
-		     bool skip_partial,
-		     enum language pretend_language)
+read_comp_unit_dies (cutu_reader *reader, enum language pretend_language)
 {
-  gdb_assert (! this_cu->is_debug_types);
-
-  cutu_reader reader (this_cu, per_objfile, NULL, existing_cu, skip_partial);
-  if (reader.dummy_p)
-    return;
-
-  struct dwarf2_cu *cu = reader.cu;
-  const gdb_byte *info_ptr = reader.info_ptr;
+  struct dwarf2_cu *cu = reader->cu;
+  const gdb_byte *info_ptr = reader->info_ptr;
 
   gdb_assert (cu->die_hash == NULL);
   cu->die_hash =
@@ -5569,11 +6024,11 @@ load_full_comp_unit (dwarf2_per_cu_data *this_cu,
 			  hashtab_obstack_allocate,
 			  dummy_obstack_deallocate);
 
-  if (reader.comp_unit_die->has_children)
-    reader.comp_unit_die->child
-      = read_die_and_siblings (&reader, reader.info_ptr,
-			       &info_ptr, reader.comp_unit_die);
-  cu->dies = reader.comp_unit_die;
+  if (reader->comp_unit_die->has_children)
+    reader->comp_unit_die->child
+      = read_die_and_siblings (reader, reader->info_ptr,
+			       &info_ptr, reader->comp_unit_die);
+  cu->dies = reader->comp_unit_die;
   /* comp_unit_die is not stored in die_hash, no need.  */
 
   /* We try not to read any attributes in this function, because not
@@ -5583,10 +6038,82 @@ load_full_comp_unit (dwarf2_per_cu_data *this_cu,
      Similarly, if we do not read the producer, we can not apply
      producer-specific interpretation.  */
   prepare_one_comp_unit (cu, cu->dies, pretend_language);
+}
+
+/* Load the DIEs associated with PER_CU into memory.
+
+   In some cases, the caller, while reading partial symbols, will need to load
+   the full symbols for the CU for some reason.  It will already have a
+   dwarf2_cu object for THIS_CU and pass it as EXISTING_CU, so it can be re-used
+   rather than creating a new one.  */
+
+static void
+load_full_comp_unit (dwarf2_per_cu_data *this_cu,
+		     dwarf2_per_objfile *per_objfile,
+		     dwarf2_cu *existing_cu,
+		     bool skip_partial,
+		     enum language pretend_language)
+{
+  gdb_assert (! this_cu->is_debug_types);
+
+  if (existing_cu == nullptr)
+    {
+      /* The DIEs may already have been read in the background.  This
+	 was done without a pretend language, which only matters if the
+	 unit does not give its own.  */
+      std::unique_ptr<dwarf2_cu> cu = per_objfile->take_read_ahead_cu (this_cu);
+      if (cu != nullptr)
+	{
+	  if (pretend_language == language_minimal
+	      || this_cu->dw_lang () != 0)
+	    {
+	      per_objfile->set_cu (this_cu, std::move (cu));
+	      per_objfile->expansion_stats.n_used++;
+	      return;
+	    }
+	  per_objfile->expansion_stats.n_discarded++;
+	}
+    }
+
+  cutu_reader reader (this_cu, per_objfile, NULL, existing_cu, skip_partial);
+  if (reader.dummy_p)
+    return;
+
+  read_comp_unit_dies (&reader, pretend_language);
 
   reader.keep ();
 }
 
+/* Read all the DIEs of PER_CU into a new CU, in a worker thread.  This
+   is what load_full_comp_unit does, except that the CU is returned
+   instead of being handed to PER_OBJFILE, which is not thread-safe.
+   Partial units are skipped, as they are read with the language of the
+   unit importing them.  Return NULL if nothing was read; the unit is
+   then read again, and any error reported, when it is needed.  */
+
+static std::unique_ptr<dwarf2_cu>
+read_comp_unit_in_background (dwarf2_per_cu_data *per_cu,
+			      dwarf2_per_objfile *per_objfile)
+{
+  try
+    {
+      /* Passing a cache tells the reader that it runs in a worker
+	 thread, so that it does not look at the CUs of PER_OBJFILE.  */
+      abbrev_cache cache;
+      cutu_reader reader (per_cu, per_objfile, nullptr, nullptr, true,
+			  &cache);
+      if (reader.dummy_p)
+	return nullptr;
+
+      read_comp_unit_dies (&reader, language_minimal);
+      return reader.release_cu ();
+    }
+  catch (const gdb_exception &except)
+    {
+      return nullptr;
+    }
+}
+
 /* Add a DIE to the delayed physname list.  */
 
 static void
@@ -6102,6 +6629,45 @@ void dwarf2_per_objfile::set_type_for_signatured_type
   this->m_type_map[sig_type] = type;
 }
 
+/* See read.h.  */
+
+struct type *
+dwarf2_per_objfile::get_unified_type (const std::string &signature) const
+{
+  auto iter = m_unified_types.find (signature);
+  if (iter == m_unified_types.end ())
+    return nullptr;
+
+  return iter->second;
+}
+
+/* See read.h.  */
+
+void
+dwarf2_per_objfile::set_unified_type (std::string &&signature,
+				      struct type *type)
+{
+  m_unified_types.emplace (std::move (signature), type);
+}
+
+/* See read.h.  */
+
+void
+dwarf2_per_objfile::note_unified_die (dwarf2_per_cu_data *per_cu,
+				      sect_offset sect_off)
+{
+  m_unified_dies.emplace (per_cu, sect_off);
+}
+
+/* See read.h.  */
+
+bool
+dwarf2_per_objfile::unified_die_p (dwarf2_per_cu_data *per_cu,
+				   sect_offset sect_off) const
+{
+  return m_unified_dies.find ({ per_cu, sect_off }) != m_unified_dies.end ();
+}
+
 /* A helper function for computing the list of all symbol tables
    included by PER_CU.  */
 
@@ -12468,61 +13034,369 @@ get_alignment (struct dwarf2_cu *cu, struct die_info *die)
 /* If the DIE has a DW_AT_alignment attribute, use its value to set
    the alignment for TYPE.  */
 
-static void
-maybe_set_alignment (struct dwarf2_cu *cu, struct die_info *die,
-		     struct type *type)
-{
-  if (!set_type_align (type, get_alignment (cu, die)))
-    complaint (_("DW_AT_alignment value too large"
-		 " - DIE at %s [in module %s]"),
-	       sect_offset_str (die->sect_off),
-	       objfile_name (cu->per_objfile->objfile));
+static void
+maybe_set_alignment (struct dwarf2_cu *cu, struct die_info *die,
+		     struct type *type)
+{
+  if (!set_type_align (type, get_alignment (cu, die)))
+    complaint (_("DW_AT_alignment value too large"
+		 " - DIE at %s [in module %s]"),
+	       sect_offset_str (die->sect_off),
+	       objfile_name (cu->per_objfile->objfile));
+}
+
+/* Check if the given VALUE is a valid enum dwarf_calling_convention
+   constant for a type, according to DWARF5 spec, Table 5.5.  */
+
+static bool
+is_valid_DW_AT_calling_convention_for_type (ULONGEST value)
+{
+  switch (value)
+    {
+    case DW_CC_normal:
+    case DW_CC_pass_by_reference:
+    case DW_CC_pass_by_value:
+      return true;
+
+    default:
+      complaint (_("unrecognized DW_AT_calling_convention value "
+		   "(%s) for a type"), pulongest (value));
+      return false;
+    }
+}
+
+/* Check if the given VALUE is a valid enum dwarf_calling_convention
+   constant for a subroutine, according to DWARF5 spec, Table 3.3, and
+   also according to GNU-specific values (see include/dwarf2.h).  */
+
+static bool
+is_valid_DW_AT_calling_convention_for_subroutine (ULONGEST value)
+{
+  switch (value)
+    {
+    case DW_CC_normal:
+    case DW_CC_program:
+    case DW_CC_nocall:
+      return true;
+
+    case DW_CC_GNU_renesas_sh:
+    case DW_CC_GNU_borland_fastcall_i386:
+    case DW_CC_GDB_IBM_OpenCL:
+      return true;
+
+    default:
+      complaint (_("unrecognized DW_AT_calling_convention value "
+		   "(%s) for a subroutine"), pulongest (value));
+      return false;
+    }
+}
+
+/* The maximum depth of the types described in a class signature.  */
+
+static const int max_class_signature_depth = 8;
+
+static bool append_members_signature (struct die_info *die,
+				      struct dwarf2_cu *cu,
+				      std::string *sig, int depth);
+
+/* Return true if the type DIE, whose qualified name is FULL_NAME,
+   names the same type in every unit: it is neither local to a
+   function nor in an anonymous namespace, either of which gives it no
+   linkage or internal linkage.  */
+
+static bool
+type_die_has_linkage (struct die_info *die, const char *full_name)
+{
+  for (die_info *parent = die->parent;
+       parent != nullptr;
+       parent = parent->parent)
+    {
+      if (parent->tag != DW_TAG_namespace
+	  && parent->tag != DW_TAG_class_type
+	  && parent->tag != DW_TAG_structure_type
+	  && parent->tag != DW_TAG_union_type
+	  && parent->tag != DW_TAG_compile_unit
+	  && parent->tag != DW_TAG_partial_unit)
+	return false;
+    }
+
+  return strstr (full_name, CP_ANONYMOUS_NAMESPACE_STR) == nullptr;
+}
+
+/* Append to *SIG the value of the attribute NAME of DIE, for
+   class_signature.  Return false if the value cannot be described
+   independently of the unit holding DIE.  */
+
+static bool
+append_attr_signature (struct die_info *die, dwarf_attribute name,
+		       struct dwarf2_cu *cu, std::string *sig)
+{
+  struct attribute *attr = dwarf2_attr (die, name, cu);
+
+  if (attr == nullptr)
+    sig->push_back ('-');
+  else if (attr->form == DW_FORM_flag || attr->form == DW_FORM_flag_present)
+    sig->push_back (attr->as_boolean () ? 't' : 'f');
+  else if (attr->form_is_constant ())
+    sig->append (plongest (attr->constant_value (0)));
+  else if (attr->form_is_block ())
+    {
+      const dwarf_block *block = attr->as_block ();
+
+      for (size_t i = 0; i < block->size; ++i)
+	string_appendf (*sig, "%02x", block->data[i]);
+    }
+  else if (attr->form_is_string ())
+    sig->append (attr->as_string ());
+  else
+    return false;
+
+  sig->push_back (';');
+  return true;
 }
 
-/* Check if the given VALUE is a valid enum dwarf_calling_convention
-   constant for a type, according to DWARF5 spec, Table 5.5.  */
+/* Append to *SIG a description of the type referred to by the
+   DW_AT_type attribute of DIE, for class_signature.  Named types are
+   described by their name, and the others by their structure.  Return
+   false if the type cannot be described independently of the unit
+   holding DIE.  */
 
 static bool
-is_valid_DW_AT_calling_convention_for_type (ULONGEST value)
+append_type_signature (struct die_info *die, struct dwarf2_cu *cu,
+		       std::string *sig, int depth)
 {
-  switch (value)
+  struct attribute *attr = dwarf2_attr (die, DW_AT_type, cu);
+  if (attr == nullptr)
     {
-    case DW_CC_normal:
-    case DW_CC_pass_by_reference:
-    case DW_CC_pass_by_value:
+      /* A void type.  */
+      sig->append ("v;");
+      return true;
+    }
+
+  if (depth > max_class_signature_depth)
+    return false;
+
+  struct dwarf2_cu *type_cu = cu;
+  struct die_info *type_die = follow_die_ref_or_sig (die, attr, &type_cu);
+  const char *name = dwarf2_name (type_die, type_cu);
+
+  string_appendf (*sig, "%x:", type_die->tag);
+  switch (type_die->tag)
+    {
+    case DW_TAG_base_type:
+    case DW_TAG_unspecified_type:
+      if (name == nullptr)
+	return false;
+      string_appendf (*sig, "%s;", name);
+      return append_attr_signature (type_die, DW_AT_byte_size, type_cu, sig);
+
+    case DW_TAG_class_type:
+    case DW_TAG_structure_type:
+    case DW_TAG_union_type:
+    case DW_TAG_enumeration_type:
+    case DW_TAG_typedef:
+      if (name != nullptr)
+	{
+	  /* A type local to a function, or to an anonymous namespace,
+	     is another type in each unit, under the same name.  */
+	  const char *full_name = dwarf2_full_name (name, type_die, type_cu);
+	  if (!type_die_has_linkage (type_die, full_name))
+	    return false;
+	  string_appendf (*sig, "%s;", full_name);
+	  return true;
+	}
+      else if (type_die->tag == DW_TAG_typedef)
+	return false;
+
+      /* An anonymous type, such as the type of an anonymous union
+	 member, is described by its members.  */
+      sig->push_back ('{');
+      if (!append_attr_signature (type_die, DW_AT_byte_size, type_cu, sig)
+	  || !append_members_signature (type_die, type_cu, sig, depth + 1))
+	return false;
+      sig->push_back ('}');
+      return true;
+
+    case DW_TAG_pointer_type:
+    case DW_TAG_reference_type:
+    case DW_TAG_rvalue_reference_type:
+    case DW_TAG_const_type:
+    case DW_TAG_volatile_type:
+    case DW_TAG_restrict_type:
+    case DW_TAG_atomic_type:
+      return append_type_signature (type_die, type_cu, sig, depth + 1);
+
+    case DW_TAG_array_type:
+      for (die_info *child = type_die->child;
+	   child != nullptr && child->tag != 0;
+	   child = child->sibling)
+	{
+	  if (child->tag != DW_TAG_subrange_type
+	      || !append_attr_signature (child, DW_AT_lower_bound, type_cu,
+					 sig)
+	      || !append_attr_signature (child, DW_AT_upper_bound, type_cu,
+					 sig)
+	      || !append_attr_signature (child, DW_AT_count, type_cu, sig))
+	    return false;
+	}
+      return append_type_signature (type_die, type_cu, sig, depth + 1);
+
+    case DW_TAG_subroutine_type:
+      if (!append_type_signature (type_die, type_cu, sig, depth + 1))
+	return false;
+      for (die_info *child = type_die->child;
+	   child != nullptr && child->tag != 0;
+	   child = child->sibling)
+	{
+	  if (child->tag == DW_TAG_unspecified_parameters)
+	    sig->append ("...;");
+	  else if (child->tag != DW_TAG_formal_parameter
+		   || !append_type_signature (child, type_cu, sig, depth + 1))
+	    return false;
+	}
       return true;
 
     default:
-      complaint (_("unrecognized DW_AT_calling_convention value "
-		   "(%s) for a type"), pulongest (value));
       return false;
     }
 }
 
-/* Check if the given VALUE is a valid enum dwarf_calling_convention
-   constant for a subroutine, according to DWARF5 spec, Table 3.3, and
-   also according to GNU-specific values (see include/dwarf2.h).  */
+/* Append to *SIG a description of the members of the class, union or
+   enumeration DIE, for class_signature.  Return false if one of them
+   cannot be described independently of the unit holding DIE.  */
 
 static bool
-is_valid_DW_AT_calling_convention_for_subroutine (ULONGEST value)
+append_members_signature (struct die_info *die, struct dwarf2_cu *cu,
+			  std::string *sig, int depth)
 {
-  switch (value)
+  for (die_info *child = die->child;
+       child != nullptr && child->tag != 0;
+       child = child->sibling)
     {
-    case DW_CC_normal:
-    case DW_CC_program:
-    case DW_CC_nocall:
-      return true;
+      const char *name = dwarf2_name (child, cu);
 
-    case DW_CC_GNU_renesas_sh:
-    case DW_CC_GNU_borland_fastcall_i386:
-    case DW_CC_GDB_IBM_OpenCL:
-      return true;
+      string_appendf (*sig, "%x:%s;", child->tag,
+		      name != nullptr ? name : "");
+      switch (child->tag)
+	{
+	case DW_TAG_member:
+	case DW_TAG_variable:
+	case DW_TAG_inheritance:
+	  if (!append_attr_signature (child, DW_AT_data_member_location, cu,
+				      sig)
+	      || !append_attr_signature (child, DW_AT_data_bit_offset, cu,
+					 sig)
+	      || !append_attr_signature (child, DW_AT_bit_size, cu, sig)
+	      || !append_attr_signature (child, DW_AT_accessibility, cu, sig)
+	      || !append_attr_signature (child, DW_AT_virtuality, cu, sig)
+	      || !append_attr_signature (child, DW_AT_external, cu, sig)
+	      || !append_type_signature (child, cu, sig, depth))
+	    return false;
+	  break;
 
-    default:
-      complaint (_("unrecognized DW_AT_calling_convention value "
-		   "(%s) for a subroutine"), pulongest (value));
-      return false;
+	case DW_TAG_subprogram:
+	  {
+	    /* The linkage name, when there is one, also describes the
+	       parameters.  */
+	    if (!append_attr_signature (child, DW_AT_linkage_name, cu, sig)
+		|| !append_attr_signature (child, DW_AT_accessibility, cu,
+					   sig)
+		|| !append_attr_signature (child, DW_AT_virtuality, cu, sig)
+		|| !append_attr_signature (child, DW_AT_vtable_elem_location,
+					   cu, sig)
+		|| !append_attr_signature (child, DW_AT_artificial, cu, sig)
+		|| !append_type_signature (child, cu, sig, depth))
+	      return false;
+
+	    for (die_info *param = child->child;
+		 param != nullptr && param->tag != 0;
+		 param = param->sibling)
+	      if (param->tag == DW_TAG_formal_parameter
+		  && !append_type_signature (param, cu, sig, depth))
+		return false;
+	  }
+	  break;
+
+	case DW_TAG_template_type_param:
+	  if (!append_type_signature (child, cu, sig, depth))
+	    return false;
+	  break;
+
+	case DW_TAG_template_value_param:
+	  /* An argument without a constant value, such as the address
+	     of an object, may refer to an object of this unit.  */
+	  if (dwarf2_attr (child, DW_AT_const_value, cu) == nullptr
+	      || !append_type_signature (child, cu, sig, depth)
+	      || !append_attr_signature (child, DW_AT_const_value, cu, sig))
+	    return false;
+	  break;
+
+	case DW_TAG_enumerator:
+	  if (!append_attr_signature (child, DW_AT_const_value, cu, sig))
+	    return false;
+	  break;
+
+	case DW_TAG_typedef:
+	case DW_TAG_class_type:
+	case DW_TAG_structure_type:
+	case DW_TAG_union_type:
+	case DW_TAG_enumeration_type:
+	  /* Nested types are described by their names above.  */
+	  break;
+
+	default:
+	  return false;
+	}
     }
+
+  return true;
+}
+
+/* If the C++ class, structure or union defined by DIE follows the one
+   definition rule, so that a class with the same name and members in
+   another unit of the objfile is the same class, set *SIG to a string
+   describing the class, and return true.  Otherwise return false.
+
+   The signature holds the qualified name and size of the class, and
+   the names, offsets and types of its members, base classes, methods
+   and template arguments.  The types are described by their names,
+   which also stand for the same types in every unit.  Classes that are
+   local to a function or to an anonymous namespace, or that refer to
+   such types, are left alone.  */
+
+static bool
+class_signature (struct die_info *die, struct dwarf2_cu *cu,
+		 std::string *sig)
+{
+  /* Naming the types of the members may read other classes, which
+     could refer back to this one before it has a type.  Only the
+     outermost class is given a signature.  */
+  static bool computing_signature = false;
+
+  if (!dwarf_unify_types
+      || computing_signature
+      || cu->lang () != language_cplus
+      || cu->per_cu->is_debug_types
+      || die->child == nullptr
+      || die_is_declaration (die, cu))
+    return false;
+
+  scoped_restore restore_computing_signature
+    = make_scoped_restore (&computing_signature, true);
+
+  const char *name = dwarf2_name (die, cu);
+  if (name == nullptr)
+    return false;
+  const char *full_name = dwarf2_full_name (name, die, cu);
+  if (!type_die_has_linkage (die, full_name))
+    return false;
+
+  sig->clear ();
+  string_appendf (*sig, "%x:%s;", die->tag, full_name);
+  return (append_attr_signature (die, DW_AT_byte_size, cu, sig)
+	  && append_attr_signature (die, DW_AT_alignment, cu, sig)
+	  && append_attr_signature (die, DW_AT_calling_convention, cu, sig)
+	  && append_members_signature (die, cu, sig, 0));
 }
 
 /* Called when we find the DIE that starts a structure or union scope
@@ -12540,7 +13414,8 @@ is_valid_DW_AT_calling_convention_for_subroutine (ULONGEST value)
 static struct type *
 read_structure_type (struct die_info *die, struct dwarf2_cu *cu)
 {
-  struct objfile *objfile = cu->per_objfile->objfile;
+  dwarf2_per_objfile *per_objfile = cu->per_objfile;
+  struct objfile *objfile = per_objfile->objfile;
   struct type *type;
   struct attribute *attr;
   const char *name;
@@ -12558,6 +13433,25 @@ read_structure_type (struct die_info *die, struct dwarf2_cu *cu)
       return set_die_type (die, type, cu);
     }
 
+  /* A C++ class defined in several units is read once, and its type
+     is shared by all of them.  */
+  std::string signature;
+  if (class_signature (die, cu, &signature))
+    {
+      /* class_signature might have already finished building the DIE's
+	 type, when computing its name.  */
+      type = get_die_type (die, cu);
+      if (type != nullptr)
+	return type;
+
+      type = per_objfile->get_unified_type (signature);
+      if (type != nullptr)
+	{
+	  per_objfile->note_unified_die (cu->per_cu, die->sect_off);
+	  return set_die_type (die, type, cu);
+	}
+    }
+
   type = type_allocator (objfile, cu->lang ()).new_type ();
   INIT_CPLUS_SPECIFIC (type);
 
@@ -12858,8 +13752,12 @@ process_structure_scope (struct die_info *die, struct dwarf2_cu *cu)
   if (type == NULL)
     type = read_structure_type (die, cu);
 
+  /* If the type is shared with the same class read from another unit,
+     it is complete already.  */
+  bool unified = cu->per_objfile->unified_die_p (cu->per_cu, die->sect_off);
+
   bool has_template_parameters = false;
-  if (die->child != NULL && ! die_is_declaration (die, cu))
+  if (die->child != NULL && ! die_is_declaration (die, cu) && !unified)
     {
       struct field_info fi;
       std::vector<struct symbol *> template_args;
@@ -12994,9 +13892,15 @@ process_structure_scope (struct die_info *die, struct dwarf2_cu *cu)
 	  for (int i = 0; i < fi.nested_types_list.size (); ++i)
 	    TYPE_NESTED_TYPES_FIELD (type, i) = fi.nested_types_list[i];
 	}
+
+      /* Let the other units defining this class use this type.  */
+      std::string signature;
+      if (class_signature (die, cu, &signature))
+	cu->per_objfile->set_unified_type (std::move (signature), type);
     }
 
-  quirk_gcc_member_function_pointer (type, objfile);
+  if (!unified)
+    quirk_gcc_member_function_pointer (type, objfile);
   if (cu->lang () == language_rust && die->tag == DW_TAG_union_type)
     cu->rust_unions.push_back (type);
   else if (cu->lang () == language_ada)
@@ -16590,6 +17494,12 @@ struct cooked_index_functions : public dwarf2_base_index_functions
     return true;
   }
 
+  void start_reading_partial_symbols (struct objfile *objfile) override
+  {
+    if (dwarf2_has_info (objfile, nullptr))
+      dwarf2_start_psymtabs (get_dwarf2_per_objfile (objfile));
+  }
+
   void read_partial_symbols (struct objfile *objfile) override
   {
     if (dwarf2_has_info (objfile, nullptr))
@@ -16732,26 +17642,27 @@ cooked_index_functions::expand_symtabs_matching
 
   dw_expand_symtabs_matching_file_matcher (per_objfile, file_matcher);
 
+  /* The units to expand are found first, so that the next ones can be
+     read in the background while one is expanded.  */
+  std::vector<dwarf2_per_cu_data *> units;
+
   /* This invariant is documented in quick-functions.h.  */
   gdb_assert (lookup_name != nullptr || symbol_matcher == nullptr);
   if (lookup_name == nullptr)
     {
       for (dwarf2_per_cu_data *per_cu
 	     : all_units_range (per_objfile->per_bfd))
-	{
-	  QUIT;
+	if (file_matcher == nullptr || per_cu->mark)
+	  units.push_back (per_cu);
 
-	  if (!dw2_expand_symtabs_matching_one (per_cu, per_objfile,
-						file_matcher,
-						expansion_notify))
-	    return false;
-	}
-      return true;
+      return dw2_expand_units_reading_ahead (units, per_objfile,
+					     file_matcher, expansion_notify);
     }
 
   lookup_name_info lookup_name_without_params
     = lookup_name->make_ignore_params ();
   bool completing = lookup_name->completion_mode ();
+  std::unordered_set<dwarf2_per_cu_data *> seen_units;
 
   /* Unique styles of language splitting.  */
   static const enum language unique_styles[] =
@@ -16776,8 +17687,10 @@ cooked_index_functions::expand_symtabs_matching
 	{
 	  QUIT;
 
-	  /* No need to consider symbols from expanded CUs.  */
-	  if (per_objfile->symtab_set_p (entry->per_cu))
+	  /* No need to consider symbols from expanded CUs, or from CUs
+	     that will be expanded anyway.  */
+	  if (per_objfile->symtab_set_p (entry->per_cu)
+	      || seen_units.count (entry->per_cu) != 0)
 	    continue;
 
 	  /* If file-matching was done, we don't need to consider
@@ -16835,14 +17748,13 @@ cooked_index_functions::expand_symtabs_matching
 		continue;
 	    }
 
-	  if (!dw2_expand_symtabs_matching_one (entry->per_cu, per_objfile,
-						file_matcher,
-						expansion_notify))
-	    return false;
+	  seen_units.insert (entry->per_cu);
+	  units.push_back (entry->per_cu);
 	}
     }
 
-  return true;
+  return dw2_expand_units_reading_ahead (units, per_objfile, file_matcher,
+					 expansion_notify);
 }
 
 /* Return a new cooked_index_functions object.  */
@@ -21759,8 +22671,106 @@ dwarf2_per_objfile::remove_cu (dwarf2_per_cu_data *per_cu)
   m_dwarf2_cus.erase (it);
 }
 
+/* See read.h.  */
+
+void
+dwarf2_per_objfile::read_ahead (dwarf2_per_cu_data *per_cu)
+{
+  if (!dwarf_background_expansion
+      || gdb::thread_pool::g_thread_pool->thread_count () == 0
+      || per_cu->is_debug_types
+      || per_cu->unit_type (false) == DW_UT_partial
+      || per_bfd->dwo_files != nullptr
+      || per_bfd->dwp_file != nullptr
+      || symtab_set_p (per_cu)
+      || get_cu (per_cu) != nullptr)
+    return;
+
+  for (const auto &item : m_read_ahead)
+    if (item.first == per_cu)
+      return;
+
+  /* The worker threads must not read sections lazily, as this thread
+     could be reading them at the same time.  This is cheap if they are
+     already read in.  */
+  per_bfd->map_info_sections (objfile);
+  dwz_file *dwz = dwarf2_get_dwz_file (per_bfd);
+  if (dwz != nullptr)
+    {
+      dwz->info.read (objfile);
+      dwz->abbrev.read (objfile);
+      dwz->str.read (objfile);
+      dwz->line.read (objfile);
+    }
+
+  if (m_read_ahead.size () >= max_read_ahead)
+    discard_read_ahead_cu ();
+
+  dwarf2_per_objfile *per_objfile = this;
+  m_read_ahead.emplace_back
+    (per_cu,
+     gdb::thread_pool::g_thread_pool->post_task<std::unique_ptr<dwarf2_cu>>
+       ([=] ()
+	{
+	  return read_comp_unit_in_background (per_cu, per_objfile);
+	}));
+  expansion_stats.n_read_ahead++;
+}
+
+/* See read.h.  */
+
+std::unique_ptr<dwarf2_cu>
+dwarf2_per_objfile::take_read_ahead_cu (dwarf2_per_cu_data *per_cu)
+{
+  for (auto iter = m_read_ahead.begin (); iter != m_read_ahead.end (); ++iter)
+    if (iter->first == per_cu)
+      {
+	gdb::future<std::unique_ptr<dwarf2_cu>> result
+	  = std::move (iter->second);
+	m_read_ahead.erase (iter);
+
+	if (result.wait_for (std::chrono::seconds (0))
+	    != gdb::future_status::ready)
+	  expansion_stats.n_waited++;
+	std::unique_ptr<dwarf2_cu> cu = result.get ();
+	if (cu == nullptr)
+	  expansion_stats.n_discarded++;
+	return cu;
+      }
+
+  return nullptr;
+}
+
+/* See read.h.  */
+
+void
+dwarf2_per_objfile::discard_read_ahead_cu ()
+{
+  /* The task refers to this object, so it must be finished before the
+     future can be dropped.  */
+  m_read_ahead.front ().second.wait ();
+  m_read_ahead.pop_front ();
+  expansion_stats.n_discarded++;
+}
+
+dwarf2_per_objfile::dwarf2_per_objfile (struct objfile *objfile,
+					dwarf2_per_bfd *per_bfd)
+  : objfile (objfile), per_bfd (per_bfd)
+{
+}
+
 dwarf2_per_objfile::~dwarf2_per_objfile ()
 {
+  /* The tasks building the index in the background use this object.  */
+  if (index_build != nullptr)
+    {
+      index_build->wait ();
+      index_build.reset ();
+      per_bfd->index_builder = nullptr;
+    }
+
+  while (!m_read_ahead.empty ())
+    discard_read_ahead_cu ();
   remove_all_cus ();
 }
 
@@ -21955,6 +22965,140 @@ show_check_physname (struct ui_file *file, int from_tty,
 	      value);
 }
 
+static void
+show_dwarf_unify_types (struct ui_file *file, int from_tty,
+			struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file,
+	      _("Sharing the types of C++ classes between DWARF units "
+		"is %s.\n"),
+	      value);
+}
+
+static void
+show_dwarf_background_expansion (struct ui_file *file, int from_tty,
+				 struct cmd_list_element *c,
+				 const char *value)
+{
+  gdb_printf (file,
+	      _("Reading DWARF units in the background is %s.\n"),
+	      value);
+}
+
+/* Return the unit of PER_BFD covering ADJUSTED_PC according to its
+   index, or NULL if there is none.  */
+
+static dwarf2_per_cu_data *
+find_per_cu_by_address (dwarf2_per_bfd *per_bfd, CORE_ADDR adjusted_pc)
+{
+  if (per_bfd->index_addrmap != nullptr)
+    return static_cast<dwarf2_per_cu_data *>
+      (per_bfd->index_addrmap->find (adjusted_pc));
+
+  cooked_index *table
+    = dynamic_cast<cooked_index *> (per_bfd->index_table.get ());
+  if (table != nullptr)
+    return table->lookup (adjusted_pc);
+
+  return nullptr;
+}
+
+/* The number of words at the top of the stack in which
+   dwarf2_read_ahead_on_stop looks for code addresses.  */
+static const int read_ahead_stack_words = 64;
+
+/* A normal_stop observer that reads ahead the units likely to be
+   needed to show where the inferior stopped: the unit of the PC, and
+   the units of the code addresses found at the top of the stack, most
+   of which are return addresses of the callers.  The callers can't be
+   found exactly, as unwinding needs the symbols being prepared
+   here.  */
+
+static void
+dwarf2_read_ahead_on_stop (struct bpstat *bs, int print_frame)
+{
+  if (!dwarf_background_expansion
+      || inferior_ptid == null_ptid
+      || !target_has_registers ())
+    return;
+
+  std::vector<CORE_ADDR> addrs;
+  try
+    {
+      regcache *regcache = get_thread_regcache (inferior_thread ());
+      gdbarch *gdbarch = regcache->arch ();
+      addrs.push_back (regcache_read_pc (regcache));
+
+      int sp_regnum = gdbarch_sp_regnum (gdbarch);
+      ULONGEST sp;
+      if (sp_regnum >= 0
+	  && (regcache_cooked_read_unsigned (regcache, sp_regnum, &sp)
+	      == REG_VALID))
+	{
+	  int ptr_size = gdbarch_ptr_bit (gdbarch) / TARGET_CHAR_BIT;
+	  gdb::byte_vector buf (read_ahead_stack_words * ptr_size);
+	  if (target_read_memory (sp, buf.data (), buf.size ()) == 0)
+	    for (size_t i = 0; i < buf.size (); i += ptr_size)
+	      addrs.push_back
+		(extract_unsigned_integer (&buf[i], ptr_size,
+					   gdbarch_byte_order (gdbarch)));
+	}
+    }
+  catch (const gdb_exception_error &except)
+    {
+      /* This is only a hint, so just use what was found.  */
+    }
+
+  for (CORE_ADDR addr : addrs)
+    {
+      obj_section *section = find_pc_section (addr);
+      if (section == nullptr
+	  || (section->the_bfd_section->flags & SEC_CODE) == 0)
+	continue;
+
+      struct objfile *objfile = section->objfile;
+      dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
+      if (per_objfile == nullptr)
+	continue;
+
+      dwarf2_per_cu_data *per_cu
+	= find_per_cu_by_address (per_objfile->per_bfd,
+				  addr - objfile->text_section_offset ());
+      if (per_cu != nullptr)
+	per_objfile->read_ahead (per_cu);
+    }
+}
+
+/* The "maintenance info expansion" command.  */
+
+static void
+maintenance_info_expansion (const char *arg, int from_tty)
+{
+  for (objfile *objfile : current_program_space->objfiles ())
+    {
+      dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
+      if (per_objfile == nullptr)
+	continue;
+
+      const auto &stats = per_objfile->expansion_stats;
+      if (stats.n_expanded == 0 && stats.n_read_ahead == 0)
+	continue;
+
+      std::chrono::duration<double> seconds = stats.expand_time;
+      gdb_printf (_("Symtab expansion for '%s':\n"),
+		  objfile_name (objfile));
+      gdb_printf (_("  Units expanded: %u, in %.3f seconds\n"),
+		  stats.n_expanded, seconds.count ());
+      gdb_printf (_("  Units read in the background: %u\n"),
+		  stats.n_read_ahead);
+      gdb_printf (_("  Units read in the background and used: %u\n"),
+		  stats.n_used);
+      gdb_printf (_("  Units waited for: %u\n"), stats.n_waited);
+      gdb_printf (_("  Units read in the background and discarded: %u\n"),
+		  stats.n_discarded);
+    }
+}
+
 void _initialize_dwarf2_read ();
 void
 _initialize_dwarf2_read ()
@@ -21981,6 +23125,41 @@ caching, which can slow down startup."),
 			    &set_dwarf_cmdlist,
 			    &show_dwarf_cmdlist);
 
+  add_setshow_boolean_cmd ("background-expansion", class_obscure,
+			   &dwarf_background_expansion, _("\
+Set whether DWARF units are read ahead in worker threads."), _("\
+Show whether DWARF units are read ahead in worker threads."), _("\
+When on, the DIEs of the units which are likely to be expanded soon are\n\
+read in worker threads: the units of the code around where the inferior\n\
+stopped, and the next units matching a symbol lookup.  Their symbols are\n\
+still made in the main thread, when they are needed."),
+			   NULL,
+			   show_dwarf_background_expansion,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
+  add_setshow_boolean_cmd ("unify-types", class_obscure,
+			   &dwarf_unify_types, _("\
+Set whether C++ classes defined in several DWARF units share a type."), _("\
+Show whether C++ classes defined in several DWARF units share a type."), _("\
+When on, a C++ class which is defined with the same name, size and members\n\
+in several units of an objfile, such as a class defined in a header file,\n\
+is read once, and its type is used by all of these units.\n\
+This only affects the symbol tables read after the setting is changed."),
+			   NULL,
+			   show_dwarf_unify_types,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
+  add_cmd ("expansion", class_maintenance, maintenance_info_expansion, _("\
+Print statistics about the expansion of DWARF symbol tables.\n\
+For each objfile, this shows the number of units expanded, the time\n\
+spent doing it, and how units read in the background were used."),
+	   &maintenanceinfolist);
+
+  gdb::observers::normal_stop.attach (dwarf2_read_ahead_on_stop,
+				      "dwarf2-read");
+
   add_setshow_zuinteger_cmd ("dwarf-read", no_class, &dwarf_read_debug, _("\
 Set debugging of the DWARF reader."), _("\
 Show debugging of the DWARF reader."), _("\
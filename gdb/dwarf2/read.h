@@ -20,7 +20,10 @@
 #ifndef DWARF2READ_H
 #define DWARF2READ_H
 
+#include <chrono>
+#include <deque>
 #include <queue>
+#include <set>
 #include <unordered_map>
 #include "dwarf2/comp-unit-head.h"
 #include "dwarf2/file-and-dir.h"
@@ -33,6 +36,7 @@
 #include "gdbsupport/hash_enum.h"
 #include "gdbsupport/function-view.h"
 #include "gdbsupport/packed.h"
+#include "gdbsupport/thread-pool.h"
 
 /* Hold 'maintenance (set|show) dwarf' commands.  */
 extern struct cmd_list_element *set_dwarf_cmdlist;
@@ -51,6 +55,7 @@ struct tu_stats
 struct dwarf2_cu;
 struct dwarf2_debug_sections;
 struct dwarf2_per_bfd;
+struct cooked_index_build;
 struct dwarf2_per_cu_data;
 struct mapped_index;
 struct mapped_debug_names;
@@ -560,6 +565,10 @@ struct dwarf2_per_bfd
 
   /* The address map that is used by the DWARF index code.  */
   struct addrmap *index_addrmap = nullptr;
+
+  /* The objfile whose cooked index of this BFD is being built in the
+     background, if any.  See dwarf2_per_objfile::index_build.  */
+  dwarf2_per_objfile *index_builder = nullptr;
 };
 
 /* An iterator for all_units that is based on index.  This
@@ -661,9 +670,7 @@ struct type_unit_group_unshareable
 
 struct dwarf2_per_objfile
 {
-  dwarf2_per_objfile (struct objfile *objfile, dwarf2_per_bfd *per_bfd)
-    : objfile (objfile), per_bfd (per_bfd)
-  {}
+  dwarf2_per_objfile (struct objfile *objfile, dwarf2_per_bfd *per_bfd);
 
   ~dwarf2_per_objfile ();
 
@@ -699,6 +706,31 @@ struct dwarf2_per_objfile
   void set_type_for_signatured_type (signatured_type *sig_type,
 				     struct type *type);
 
+  /* Return the type of the C++ class with SIGNATURE, as computed by
+     class_signature, read from another unit.  Return NULL if there is
+     none.  */
+  struct type *get_unified_type (const std::string &signature) const;
+
+  /* Record TYPE, fully read, as the type of the C++ classes with
+     SIGNATURE.  */
+  void set_unified_type (std::string &&signature, struct type *type);
+
+  /* Record that the class DIE at SECT_OFF in PER_CU uses a type read
+     from another unit, which must not be filled in again.  */
+  void note_unified_die (dwarf2_per_cu_data *per_cu, sect_offset sect_off);
+
+  /* Return true if the class DIE at SECT_OFF in PER_CU uses a type
+     read from another unit.  */
+  bool unified_die_p (dwarf2_per_cu_data *per_cu,
+		      sect_offset sect_off) const;
+
+  /* Return the number of class DIEs using a type read from another
+     unit.  */
+  size_t num_unified_dies () const
+  {
+    return m_unified_dies.size ();
+  }
+
   /* Get the dwarf2_cu matching PER_CU for this objfile.  */
   dwarf2_cu *get_cu (dwarf2_per_cu_data *per_cu);
 
@@ -715,6 +747,19 @@ struct dwarf2_per_objfile
      any that are too old.  */
   void age_comp_units ();
 
+  /* Start reading the DIEs of PER_CU in a worker thread, if background
+     expansion is enabled.  This is only a hint: when PER_CU is loaded
+     later on, the DIEs read here are used instead of being read
+     again.  */
+  void read_ahead (dwarf2_per_cu_data *per_cu);
+
+  /* If the DIEs of PER_CU are being read in the background, wait for
+     them, and return the CU holding them.  Otherwise, or if the DIEs
+     could not be read, return NULL.  The caller counts the CU in
+     EXPANSION_STATS as used or discarded, depending on whether it
+     adopts it.  */
+  std::unique_ptr<dwarf2_cu> take_read_ahead_cu (dwarf2_per_cu_data *per_cu);
+
   /* Apply any needed adjustments to ADDR, returning an adjusted but
      still unrelocated address.  */
   unrelocated_addr adjust (unrelocated_addr addr);
@@ -745,7 +790,38 @@ struct dwarf2_per_objfile
   /* CUs that are queued to be read.  */
   gdb::optional<std::queue<dwarf2_queue_item>> queue;
 
+  /* The cooked index of PER_BFD being built in the background for this
+     objfile, if any.  It is completed when the partial symbols are
+     read, and its tasks are waited for when this object is
+     destroyed.  */
+  std::unique_ptr<cooked_index_build> index_build;
+
+  /* Statistics about symtab expansion, shown by "maint info
+     expansion".  */
+  struct
+  {
+    /* The number of requests to expand a unit, and the time spent on
+       them.  */
+    unsigned int n_expanded = 0;
+    std::chrono::steady_clock::duration expand_time {};
+
+    /* The number of units read in the background, and how many of
+       them were used, had to be waited for, or were thrown away.  */
+    unsigned int n_read_ahead = 0;
+    unsigned int n_used = 0;
+    unsigned int n_waited = 0;
+    unsigned int n_discarded = 0;
+  } expansion_stats;
+
 private:
+  /* Discard the oldest unit being read in the background.  */
+  void discard_read_ahead_cu ();
+
+  /* The units being read in the background, oldest first, with the
+     futures that hold their CUs.  */
+  std::deque<std::pair<dwarf2_per_cu_data *,
+		       gdb::future<std::unique_ptr<dwarf2_cu>>>> m_read_ahead;
+
   /* Hold the corresponding compunit_symtab for each CU or TU.  This
      is indexed by dwarf2_per_cu_data::index.  A NULL value means
      that the CU/TU has not been expanded yet.  */
@@ -762,6 +838,12 @@ struct dwarf2_per_objfile
   /* Map from signatured types to the corresponding struct type.  */
   std::unordered_map<signatured_type *, struct type *> m_type_map;
 
+  /* Map from the signatures of C++ classes to their types.  */
+  std::unordered_map<std::string, struct type *> m_unified_types;
+
+  /* The class DIEs whose type was found in M_UNIFIED_TYPES.  */
+  std::set<std::pair<dwarf2_per_cu_data *, sect_offset>> m_unified_dies;
+
   /* Map from the objfile-independent dwarf2_per_cu_data instances to the
      corresponding objfile-dependent dwarf2_cu instances.  */
   std::unordered_map<dwarf2_per_cu_data *,
@@ -33,6 +33,7 @@
 #include "gdbsupport/fileio.h"
 #include "inferior.h"
 #include "cli/cli-style.h"
+#include "target-file-cache.h"
 #include <unordered_map>
 
 /* An object of this type is stored in the section's user data when
@@ -339,10 +340,85 @@ struct target_fileio_stream : public gdb_bfd_iovec_base
   int m_fd;
 };
 
+/* An object that manages the underlying stream for a BFD, using the
+   local copy of a target file kept by the target file cache.  */
+
+struct cached_target_file_stream : public gdb_bfd_iovec_base
+{
+  cached_target_file_stream (scoped_fd fd, const struct stat &st)
+    : m_fd (std::move (fd)),
+      m_stat (st)
+  {
+  }
+
+  file_ptr read (bfd *abfd, void *buffer, file_ptr nbytes,
+		 file_ptr offset) override;
+
+  int stat (struct bfd *abfd, struct stat *sb) override;
+
+private:
+
+  /* The file descriptor of the local copy.  */
+  scoped_fd m_fd;
+
+  /* The status of the file on the target.  */
+  struct stat m_stat;
+};
+
+/* Wrapper for pread, or lseek and read if pread is missing.  */
+
+file_ptr
+cached_target_file_stream::read (struct bfd *abfd, void *buf,
+				 file_ptr nbytes, file_ptr offset)
+{
+  file_ptr pos = 0;
+
+#ifndef HAVE_PREAD
+  if (lseek (m_fd.get (), offset, SEEK_SET) == -1)
+    {
+      bfd_set_error (bfd_error_system_call);
+      return -1;
+    }
+#endif
+
+  while (nbytes > pos)
+    {
+#ifdef HAVE_PREAD
+      ssize_t bytes = pread (m_fd.get (), (gdb_byte *) buf + pos,
+			     nbytes - pos, offset + pos);
+#else
+      ssize_t bytes = ::read (m_fd.get (), (gdb_byte *) buf + pos,
+			      nbytes - pos);
+#endif
+      if (bytes == 0)
+	break;
+      if (bytes == -1)
+	{
+	  bfd_set_error (bfd_error_system_call);
+	  return -1;
+	}
+
+      pos += bytes;
+    }
+
+  return pos;
+}
+
+/* Return the status of the file on the target, so that the BFD looks
+   the same whether it is read from the cache or not.  */
+
+int
+cached_target_file_stream::stat (struct bfd *abfd, struct stat *sb)
+{
+  *sb = m_stat;
+  return 0;
+}
+
 /* Wrapper for target_fileio_open suitable for use as a helper
-   function for gdb_bfd_openr_iovec.  */
+   function for gdb_bfd_openr_iovec.  The file is read from the target
+   file cache if possible.  */
 
-static target_fileio_stream *
+static gdb_bfd_iovec_base *
 gdb_bfd_iovec_fileio_open (struct bfd *abfd, inferior *inf, bool warn_if_slow)
 {
   const char *filename = bfd_get_filename (abfd);
@@ -362,6 +438,16 @@ gdb_bfd_iovec_fileio_open (struct bfd *abfd, inferior *inf, bool warn_if_slow)
       return NULL;
     }
 
+  struct stat st;
+  scoped_fd cached_fd
+    = target_file_cache_open (fd, filename + strlen (TARGET_SYSROOT_PREFIX),
+			      &st);
+  if (cached_fd.get () != -1)
+    {
+      target_fileio_close (fd, &target_errno);
+      return new cached_target_file_stream (std::move (cached_fd), st);
+    }
+
   return new target_fileio_stream (abfd, fd);
 }
 
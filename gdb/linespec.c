@@ -150,6 +150,10 @@ struct linespec_state
      space.  */
   struct program_space *search_pspace;
 
+  /* If not NULL, the search is restricted to just this objfile, and
+     its separate debug objfiles.  */
+  struct objfile *search_objfile;
+
   /* The default symtab to use, if no other symtab is specified.  */
   struct symtab *default_symtab;
 
@@ -363,7 +367,7 @@ static std::vector<symtab_and_line> decode_objc (struct linespec_state *self,
 						 const char *arg);
 
 static std::vector<symtab *> symtabs_from_filename
-  (const char *, struct program_space *pspace);
+  (const char *, struct program_space *pspace, struct objfile *objfile);
 
 static std::vector<block_symbol> find_label_symbols
   (struct linespec_state *self,
@@ -397,7 +401,8 @@ static void add_all_symbol_names_from_pspace
 
 static std::vector<symtab *>
   collect_symtabs_from_filename (const char *file,
-				 struct program_space *pspace);
+				 struct program_space *pspace,
+				 struct objfile *objfile);
 
 static std::vector<symtab_and_line> decode_digits_ordinary
   (struct linespec_state *self,
@@ -1144,10 +1149,26 @@ maybe_add_address (htab_t set, struct program_space *pspace, CORE_ADDR addr)
   return 1;
 }
 
+/* Return true if the searches of STATE skip OBJFILE, because they are
+   restricted to another objfile.  */
+
+static bool
+objfile_excluded_p (const struct linespec_state *state,
+		    struct objfile *objfile)
+{
+  if (state->search_objfile == NULL)
+    return false;
+
+  if (objfile->separate_debug_objfile_backlink != NULL)
+    objfile = objfile->separate_debug_objfile_backlink;
+  return objfile != state->search_objfile;
+}
+
 /* A helper that walks over all matching symtabs in all objfiles and
    calls CALLBACK for each symbol matching NAME.  If SEARCH_PSPACE is
    not NULL, then the search is restricted to just that program
-   space.  If INCLUDE_INLINE is true then symbols representing
+   space.  If STATE's search is restricted to an objfile, so is this
+   one.  If INCLUDE_INLINE is true then symbols representing
    inlined instances of functions will be included in the result.  */
 
 static void
@@ -1170,6 +1191,9 @@ iterate_over_all_matching_symtabs
 
       for (objfile *objfile : current_program_space->objfiles ())
 	{
+	  if (objfile_excluded_p (state, objfile))
+	    continue;
+
 	  objfile->expand_symtabs_matching (NULL, &lookup_name, NULL, NULL,
 					    (SEARCH_GLOBAL_BLOCK
 					     | SEARCH_STATIC_BLOCK),
@@ -2046,7 +2070,8 @@ create_sals_line_offset (struct linespec_state *self,
       initialize_defaults (&self->default_symtab, &self->default_line);
       ls->file_symtabs
 	= collect_symtabs_from_filename (self->default_symtab->filename,
-					 self->search_pspace);
+					 self->search_pspace,
+					 self->search_objfile);
       use_default = 1;
     }
 
@@ -2328,7 +2353,8 @@ convert_explicit_location_spec_to_linespec
       try
 	{
 	  result->file_symtabs
-	    = symtabs_from_filename (source_filename, self->search_pspace);
+	    = symtabs_from_filename (source_filename, self->search_pspace,
+				     self->search_objfile);
 	}
       catch (const gdb_exception_error &except)
 	{
@@ -2555,7 +2581,8 @@ parse_linespec (linespec_parser *parser, const char *arg,
 	{
 	  PARSER_RESULT (parser)->file_symtabs
 	    = symtabs_from_filename (user_filename.get (),
-				     PARSER_STATE (parser)->search_pspace);
+				     PARSER_STATE (parser)->search_pspace,
+				     PARSER_STATE (parser)->search_objfile);
 	}
       catch (gdb_exception_error &ex)
 	{
@@ -3127,7 +3154,8 @@ decode_line_full (struct location_spec *locspec, int flags,
 		  struct symtab *default_symtab,
 		  int default_line, struct linespec_result *canonical,
 		  const char *select_mode,
-		  const char *filter)
+		  const char *filter,
+		  struct objfile *search_objfile)
 {
   std::vector<const char *> filters;
   struct linespec_state *state;
@@ -3144,6 +3172,7 @@ decode_line_full (struct location_spec *locspec, int flags,
   linespec_parser parser (flags, current_language,
 			  search_pspace, default_symtab,
 			  default_line, canonical);
+  PARSER_STATE (&parser)->search_objfile = search_objfile;
 
   scoped_restore_current_program_space restore_pspace;
 
@@ -3689,11 +3718,13 @@ symtab_collector::operator () (struct symtab *symtab)
 
 /* Given a file name, return a list of all matching symtabs.  If
    SEARCH_PSPACE is not NULL, the search is restricted to just that
-   program space.  */
+   program space.  If SEARCH_OBJFILE is not NULL, it is restricted to
+   just that objfile.  */
 
 static std::vector<symtab *>
 collect_symtabs_from_filename (const char *file,
-			       struct program_space *search_pspace)
+			       struct program_space *search_pspace,
+			       struct objfile *search_objfile)
 {
   symtab_collector collector;
 
@@ -3706,27 +3737,30 @@ collect_symtabs_from_filename (const char *file,
 	    continue;
 
 	  set_current_program_space (pspace);
-	  iterate_over_symtabs (file, collector);
+	  iterate_over_symtabs (file, collector, search_objfile);
 	}
     }
   else
     {
       set_current_program_space (search_pspace);
-      iterate_over_symtabs (file, collector);
+      iterate_over_symtabs (file, collector, search_objfile);
     }
 
   return collector.release_symtabs ();
 }
 
 /* Return all the symtabs associated to the FILENAME.  If SEARCH_PSPACE is
-   not NULL, the search is restricted to just that program space.  */
+   not NULL, the search is restricted to just that program space.  If
+   SEARCH_OBJFILE is not NULL, it is restricted to just that objfile.  */
 
 static std::vector<symtab *>
 symtabs_from_filename (const char *filename,
-		       struct program_space *search_pspace)
+		       struct program_space *search_pspace,
+		       struct objfile *search_objfile)
 {
   std::vector<symtab *> result
-    = collect_symtabs_from_filename (filename, search_pspace);
+    = collect_symtabs_from_filename (filename, search_pspace,
+				     search_objfile);
 
   if (result.empty ())
     {
@@ -4200,8 +4234,8 @@ add_minsym (struct minimal_symbol *minsym, struct objfile *objfile,
    is not NULL, the search is restricted to just that program
    space.
 
-   If SYMTAB is NULL, search all objfiles, otherwise
-   restrict results to the given SYMTAB.  */
+   If SYMTAB is NULL, search all objfiles, or the one INFO's search
+   is restricted to, otherwise restrict results to the given SYMTAB.  */
 
 static void
 search_minsyms_for_name (struct collect_info *info,
@@ -4224,6 +4258,9 @@ search_minsyms_for_name (struct collect_info *info,
 
 	  for (objfile *objfile : current_program_space->objfiles ())
 	    {
+	      if (objfile_excluded_p (info->state, objfile))
+		continue;
+
 	      iterate_over_minimal_symbols (objfile, name,
 					    [&] (struct minimal_symbol *msym)
 					    {
@@ -18,6 +18,7 @@
 #define LINESPEC_H 1
 
 struct symtab;
+struct objfile;
 
 #include "location.h"
 
@@ -93,7 +94,10 @@ extern std::vector<symtab_and_line>
    valid for this function.
 
    If SEARCH_PSPACE is not NULL, symbol search is restricted to just
-   that program space.
+   that program space.  If SEARCH_OBJFILE is not NULL, it is mostly
+   restricted to that objfile and its separate debug objfiles: the
+   results may still include locations elsewhere, for instance those
+   found through DEFAULT_SYMTAB.
 
    DEFAULT_SYMTAB and DEFAULT_LINE describe the default location.
    DEFAULT_SYMTAB can be NULL, in which case the current symtab and
@@ -129,7 +133,8 @@ extern void decode_line_full (struct location_spec *locspec, int flags,
 			      struct symtab *default_symtab, int default_line,
 			      struct linespec_result *canonical,
 			      const char *select_mode,
-			      const char *filter);
+			      const char *filter,
+			      struct objfile *search_objfile = nullptr);
 
 /* Given a string, return the line specified by it, using the current
    source symtab and line as defaults.
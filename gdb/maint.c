@@ -1100,6 +1100,43 @@ scoped_command_stats::print_time (const char *msg)
   gdb_printf (gdb_stdlog, "%s.%03d - %s\n", out, (int) millis, msg);
 }
 
+/* See maint.h.  */
+
+scoped_time_it::scoped_time_it (const char *what)
+  : m_enabled (per_command_time),
+    m_what (what)
+{
+  if (m_enabled)
+    {
+      m_start_wall = std::chrono::steady_clock::now ();
+      run_time_clock::now (m_start_user, m_start_sys);
+    }
+}
+
+/* See maint.h.  */
+
+scoped_time_it::~scoped_time_it ()
+{
+  if (!m_enabled)
+    return;
+
+  using namespace std::chrono;
+
+  user_cpu_time_clock::time_point end_user;
+  system_cpu_time_clock::time_point end_sys;
+  run_time_clock::now (end_user, end_sys);
+
+  auto wall = steady_clock::now () - m_start_wall;
+  auto user = end_user - m_start_user;
+  auto sys = end_sys - m_start_sys;
+
+  gdb_printf (gdb_stdlog,
+	      _("Time for \"%s\": wall %.6f, user %.6f, sys %.6f\n"),
+	      m_what, duration<double> (wall).count (),
+	      duration<double> (user).count (),
+	      duration<double> (sys).count ());
+}
+
 /* Handle unknown "mt set per-command" arguments.
    In this case have "mt set per-command on|off" affect every setting.  */
 
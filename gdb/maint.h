@@ -63,6 +63,29 @@ class scoped_command_stats
   int m_start_nr_blocks;
 };
 
+/* Measures the time spent in a scope, and reports it when the scope
+   is left, if "maintenance set per-command time" is on.  */
+
+class scoped_time_it
+{
+ public:
+
+  /* WHAT describes what is being timed in the report.  */
+  explicit scoped_time_it (const char *what);
+  ~scoped_time_it ();
+
+ private:
+
+  DISABLE_COPY_AND_ASSIGN (scoped_time_it);
+
+  /* Whether the time is reported, decided on entry.  */
+  bool m_enabled;
+  const char *m_what;
+  std::chrono::steady_clock::time_point m_start_wall;
+  user_cpu_time_clock::time_point m_start_user;
+  system_cpu_time_clock::time_point m_start_sys;
+};
+
 extern obj_section *maint_obj_section_from_bfd_section (bfd *abfd,
 							asection *asection,
 							objfile *ofile);
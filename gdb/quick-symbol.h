@@ -220,6 +220,14 @@ struct quick_symbol_functions
     return false;
   }
 
+  /* Start reading the partial symbols for OBJFILE in the background,
+     if this class can do so.  read_partial_symbols is still called
+     later, and waits for the reading to complete.  This will only ever
+     be called if can_lazily_read_symbols returns true.  */
+  virtual void start_reading_partial_symbols (struct objfile *objfile)
+  {
+  }
+
   /* Read the partial symbols for OBJFILE.  This will only ever be
      called if can_lazily_read_symbols returns true.  */
   virtual void read_partial_symbols (struct objfile *objfile)
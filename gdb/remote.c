@@ -75,10 +75,17 @@
 #include "gdbsupport/byte-vector.h"
 #include "gdbsupport/search.h"
 #include <algorithm>
+#include <deque>
 #include <iterator>
+#include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include "async-event.h"
 #include "gdbsupport/selftest.h"
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 
 /* The remote target.  */
 
@@ -98,6 +105,7 @@ typedef unsigned char threadref[OPAQUETHREADBYTES];
 
 struct gdb_ext_thread_info;
 struct threads_listing_context;
+struct threads_delta_context;
 typedef int (*rmt_thread_action) (threadref *ref, void *context);
 struct protocol_feature;
 struct packet_reg;
@@ -185,6 +193,7 @@ enum {
   PACKET_qXfer_memory_map,
   PACKET_qXfer_osdata,
   PACKET_qXfer_threads,
+  PACKET_qXfer_threads_delta,
   PACKET_qXfer_statictrace_read,
   PACKET_qXfer_traceframe_info,
   PACKET_qXfer_uib,
@@ -219,6 +228,9 @@ enum {
   /* Support for target-side breakpoint commands.  */
   PACKET_BreakpointCommands,
 
+  /* Support for replacing conditional breakpoints with jumps.  */
+  PACKET_FastBreakpoints,
+
   /* Support for fast tracepoints.  */
   PACKET_FastTracepoints,
 
@@ -305,6 +317,15 @@ enum {
      packets and the tag violation stop replies.  */
   PACKET_memory_tagging_feature,
 
+  /* Support for several memory-read packets in flight.  */
+  PACKET_memory_read_pipeline_feature,
+
+  /* Support for several vFile:pread packets in flight.  */
+  PACKET_vFile_pread_pipeline_feature,
+
+  /* Support for compressed replies.  */
+  PACKET_compression_feature,
+
   PACKET_MAX
 };
 
@@ -402,6 +423,29 @@ struct remote_arch_state
   long remote_packet_size;
 };
 
+/* The algorithms the remote target may compress large replies
+   with.  */
+
+enum class remote_compression
+{
+  none,
+  zlib,
+  zstd,
+};
+
+/* Statistics of the replies to one kind of packet.  */
+
+struct remote_packet_stats
+{
+  /* The number of replies, and how many of them were compressed.  */
+  ULONGEST replies = 0;
+  ULONGEST compressed = 0;
+
+  /* The size of the replies as received, and once expanded.  */
+  ULONGEST wire_bytes = 0;
+  ULONGEST bytes = 0;
+};
+
 /* Description of the remote protocol state for the currently
    connected target.  This is per-target state, and independent of the
    selected architecture.  */
@@ -603,6 +647,21 @@ class remote_state
      qSupported.  */
   gdb_thread_options supported_thread_options = 0;
 
+  /* The algorithm the target compresses large replies with, as
+     negotiated via qSupported.  */
+  remote_compression compression = remote_compression::none;
+
+  /* The kind of the last packet sent, see remote_packet_kind.  The
+     replies received are counted under it in PACKET_STATS.  */
+  std::string last_packet_kind;
+
+  /* Statistics of the replies received, by kind of packet.  */
+  std::map<std::string, remote_packet_stats> packet_stats;
+
+  /* The generation of the thread list last read with
+     qXfer:threads-delta, or 0 to read the whole list.  */
+  ULONGEST thread_list_generation = 0;
+
 private:
   /* Asynchronous signal handle registered as event loop source for
      when we have pending events ready to be passed to the core.  */
@@ -1069,6 +1128,9 @@ class remote_target : public process_stratum_target
 			    ULONGEST offset, fileio_error *remote_errno);
   int remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
 				 ULONGEST offset, fileio_error *remote_errno);
+  int remote_hostio_pread_pipelined (int fd, gdb_byte *read_buf, int len,
+				     ULONGEST offset, int block_len,
+				     fileio_error *remote_errno);
 
   int remote_hostio_send_command (int command_bytes, int which_packet,
 				  fileio_error *remote_errno, const char **attachment,
@@ -1146,7 +1208,7 @@ class remote_target : public process_stratum_target
   void remote_interrupt_as ();
   void remote_interrupt_ns ();
 
-  char *remote_get_noisy_reply ();
+  char *remote_get_noisy_reply (bool return_errors = false);
   int remote_query_attached (int pid);
   inferior *remote_add_inferior (bool fake_pid_p, int pid, int attached,
 				 int try_open_exec);
@@ -1180,6 +1242,9 @@ class remote_target : public process_stratum_target
   int remote_get_threads_with_ql (threads_listing_context *context);
   int remote_get_threads_with_qxfer (threads_listing_context *context);
   int remote_get_threads_with_qthreadinfo (threads_listing_context *context);
+  int remote_get_threads_delta (threads_delta_context *delta);
+  void remote_add_listed_threads (threads_listing_context *context);
+  void remote_apply_threads_delta (threads_delta_context *delta);
 
   void extended_remote_restart ();
 
@@ -1198,6 +1263,9 @@ class remote_target : public process_stratum_target
   void remote_supported_thread_options (const protocol_feature *feature,
 					enum packet_support support,
 					const char *value);
+  void remote_supported_compression (const protocol_feature *feature,
+				     enum packet_support support,
+				     const char *value);
 
   void remote_serial_quit_handler ();
 
@@ -1243,6 +1311,15 @@ class remote_target : public process_stratum_target
 					  ULONGEST len_units,
 					  int unit_size, ULONGEST *xfered_len_units);
 
+  target_xfer_status remote_read_bytes_pipelined (CORE_ADDR memaddr,
+						  gdb_byte *myaddr,
+						  ULONGEST len_units,
+						  ULONGEST packet_units,
+						  int unit_size,
+						  ULONGEST *xfered_len_units);
+
+  void discard_pipelined_replies (size_t count);
+
   target_xfer_status remote_xfer_live_readonly_partial (gdb_byte *readbuf,
 							ULONGEST memaddr,
 							ULONGEST len,
@@ -1606,10 +1683,12 @@ trace_error (char *buf)
     }
 }
 
-/* Utility: wait for reply from stub, while accepting "O" packets.  */
+/* Utility: wait for reply from stub, while accepting "O" packets.
+   Error replies are reported with trace_error, unless RETURN_ERRORS,
+   in which case they are returned like the others.  */
 
 char *
-remote_target::remote_get_noisy_reply ()
+remote_target::remote_get_noisy_reply (bool return_errors)
 {
   struct remote_state *rs = get_remote_state ();
 
@@ -1620,7 +1699,7 @@ remote_target::remote_get_noisy_reply ()
       QUIT;			/* Allow user to bail out with ^C.  */
       getpkt (&rs->buf);
       buf = rs->buf.data ();
-      if (buf[0] == 'E')
+      if (buf[0] == 'E' && !return_errors)
 	trace_error (buf);
       else if (startswith (buf, "qRelocInsn:"))
 	{
@@ -2227,6 +2306,22 @@ show_hardware_breakpoint_limit (struct ui_file *file, int from_tty,
 		      "breakpoints is %s.\n"), value);
 }
 
+/* The number of memory-read packets kept in flight when reading memory
+   spanning several packets.  Zero or one disable pipelining.  */
+
+static unsigned int remote_memory_read_window = 8;
+
+/* Show the number of memory-read packets kept in flight.  */
+
+static void
+show_remote_memory_read_window (struct ui_file *file, int from_tty,
+				struct cmd_list_element *c,
+				const char *value)
+{
+  gdb_printf (file, _("The number of memory-read packets kept "
+		      "in flight is %s.\n"), value);
+}
+
 /* Controls the maximum number of characters to display in the debug output
    for each remote packet.  The remaining characters are omitted.  */
 
@@ -3925,23 +4020,6 @@ struct thread_item
 
 struct threads_listing_context
 {
-  /* Return true if this object contains an entry for a thread with ptid
-     PTID.  */
-
-  bool contains_thread (ptid_t ptid) const
-  {
-    auto match_ptid = [&] (const thread_item &item)
-      {
-	return item.ptid == ptid;
-      };
-
-    auto it = std::find_if (this->items.begin (),
-			    this->items.end (),
-			    match_ptid);
-
-    return it != this->items.end ();
-  }
-
   /* Remove the thread with ptid PTID.  */
 
   void remove_thread (ptid_t ptid)
@@ -3963,6 +4041,28 @@ struct threads_listing_context
   std::vector<thread_item> items;
 };
 
+/* The changes to the remote thread list read with
+   qXfer:threads-delta.  */
+
+struct threads_delta_context
+{
+  /* The generation of the thread list, once changed.  */
+  ULONGEST generation = 0;
+
+  /* True if CREATED holds the whole thread list, rather than the
+     threads created since the generation GDB asked about.  */
+  bool full = false;
+
+  /* The threads created, or all the threads if FULL.  */
+  threads_listing_context created;
+
+  /* The threads that exited.  */
+  std::vector<ptid_t> exited;
+
+  /* The threads whose name changed, with their new name.  */
+  std::vector<std::pair<ptid_t, std::string>> renamed;
+};
+
 static int
 remote_newthread_step (threadref *ref, void *data)
 {
@@ -4081,6 +4181,111 @@ const struct gdb_xml_element threads_elements[] = {
   { NULL, NULL, NULL, GDB_XML_EF_NONE, NULL, NULL }
 };
 
+static void
+start_threads_delta (struct gdb_xml_parser *parser,
+		     const struct gdb_xml_element *element,
+		     void *user_data,
+		     std::vector<gdb_xml_value> &attributes)
+{
+  struct threads_delta_context *data
+    = (struct threads_delta_context *) user_data;
+  struct gdb_xml_value *attr;
+
+  data->generation
+    = *(ULONGEST *) xml_find_attribute (attributes, "generation")->value.get ();
+
+  attr = xml_find_attribute (attributes, "full");
+  if (attr != NULL)
+    data->full = *(ULONGEST *) attr->value.get () != 0;
+}
+
+static void
+start_delta_thread (struct gdb_xml_parser *parser,
+		    const struct gdb_xml_element *element,
+		    void *user_data,
+		    std::vector<gdb_xml_value> &attributes)
+{
+  struct threads_delta_context *data
+    = (struct threads_delta_context *) user_data;
+
+  start_thread (parser, element, &data->created, attributes);
+}
+
+static void
+end_delta_thread (struct gdb_xml_parser *parser,
+		  const struct gdb_xml_element *element,
+		  void *user_data, const char *body_text)
+{
+  struct threads_delta_context *data
+    = (struct threads_delta_context *) user_data;
+
+  end_thread (parser, element, &data->created, body_text);
+}
+
+static void
+start_exited_thread (struct gdb_xml_parser *parser,
+		     const struct gdb_xml_element *element,
+		     void *user_data,
+		     std::vector<gdb_xml_value> &attributes)
+{
+  struct threads_delta_context *data
+    = (struct threads_delta_context *) user_data;
+
+  char *id = (char *) xml_find_attribute (attributes, "id")->value.get ();
+  data->exited.push_back (read_ptid (id, NULL));
+}
+
+static void
+start_renamed_thread (struct gdb_xml_parser *parser,
+		      const struct gdb_xml_element *element,
+		      void *user_data,
+		      std::vector<gdb_xml_value> &attributes)
+{
+  struct threads_delta_context *data
+    = (struct threads_delta_context *) user_data;
+
+  char *id = (char *) xml_find_attribute (attributes, "id")->value.get ();
+  char *name = (char *) xml_find_attribute (attributes, "name")->value.get ();
+  data->renamed.emplace_back (read_ptid (id, NULL), name);
+}
+
+const struct gdb_xml_attribute threads_delta_attributes[] = {
+  { "generation", GDB_XML_AF_NONE, gdb_xml_parse_attr_ulongest, NULL },
+  { "full", GDB_XML_AF_OPTIONAL, gdb_xml_parse_attr_enum,
+    gdb_xml_enums_boolean },
+  { NULL, GDB_XML_AF_NONE, NULL, NULL }
+};
+
+const struct gdb_xml_attribute exited_thread_attributes[] = {
+  { "id", GDB_XML_AF_NONE, NULL, NULL },
+  { NULL, GDB_XML_AF_NONE, NULL, NULL }
+};
+
+const struct gdb_xml_attribute renamed_thread_attributes[] = {
+  { "id", GDB_XML_AF_NONE, NULL, NULL },
+  { "name", GDB_XML_AF_NONE, NULL, NULL },
+  { NULL, GDB_XML_AF_NONE, NULL, NULL }
+};
+
+const struct gdb_xml_element threads_delta_children[] = {
+  { "thread", thread_attributes, thread_children,
+    GDB_XML_EF_REPEATABLE | GDB_XML_EF_OPTIONAL,
+    start_delta_thread, end_delta_thread },
+  { "exited", exited_thread_attributes, NULL,
+    GDB_XML_EF_REPEATABLE | GDB_XML_EF_OPTIONAL,
+    start_exited_thread, NULL },
+  { "renamed", renamed_thread_attributes, NULL,
+    GDB_XML_EF_REPEATABLE | GDB_XML_EF_OPTIONAL,
+    start_renamed_thread, NULL },
+  { NULL, NULL, NULL, GDB_XML_EF_NONE, NULL, NULL }
+};
+
+const struct gdb_xml_element threads_delta_elements[] = {
+  { "threads-delta", threads_delta_attributes, threads_delta_children,
+    GDB_XML_EF_NONE, start_threads_delta, NULL },
+  { NULL, NULL, NULL, GDB_XML_EF_NONE, NULL, NULL }
+};
+
 #endif
 
 /* List remote threads using qXfer:threads:read.  */
@@ -4107,6 +4312,48 @@ remote_target::remote_get_threads_with_qxfer (threads_listing_context *context)
   return 0;
 }
 
+/* Read the changes to the remote thread list since the last time
+   with qXfer:threads-delta:read.  The target may send the whole list
+   instead, see threads_delta_context.  Return 1 if the changes were
+   read, and 0 if the whole list must be read another way.  */
+
+int
+remote_target::remote_get_threads_delta (threads_delta_context *delta)
+{
+  struct remote_state *rs = get_remote_state ();
+
+#if defined(HAVE_LIBEXPAT)
+  if (m_features.packet_support (PACKET_qXfer_threads_delta) == PACKET_ENABLE)
+    {
+      std::string annex = phex_nz (rs->thread_list_generation,
+				   sizeof (ULONGEST));
+      gdb::optional<gdb::char_vector> xml
+	= target_read_stralloc (this, TARGET_OBJECT_THREADS_DELTA,
+				annex.c_str ());
+
+      if (xml && (*xml)[0] != '\0'
+	  && gdb_xml_parse_quick (_("threads delta"), "threads-delta.dtd",
+				  threads_delta_elements, xml->data (),
+				  delta) == 0)
+	{
+	  remote_debug_printf ("thread list generation %s: %s, "
+			       "%zu created, %zu exited, %zu renamed",
+			       pulongest (delta->generation),
+			       delta->full ? "full" : "delta",
+			       delta->created.items.size (),
+			       delta->exited.size (), delta->renamed.size ());
+	  rs->thread_list_generation = delta->generation;
+	  return 1;
+	}
+    }
+#endif
+
+  /* Whatever GDB reads instead is newer than what the target last
+     reported.  */
+  rs->thread_list_generation = 0;
+  return 0;
+}
+
 /* List remote threads using qfThreadInfo/qsThreadInfo.  */
 
 int
@@ -4159,6 +4406,91 @@ has_single_non_exited_thread (inferior *inf)
   return count == 1;
 }
 
+/* Return true if TP, a thread the remote target no longer lists, can
+   be deleted.  */
+
+static bool
+remote_thread_may_be_pruned (thread_info *tp)
+{
+  /* Do not remove the thread if it is the last thread in the
+     inferior.  This situation happens when we have a pending exit
+     process status to process.  Otherwise we may end up with a
+     seemingly live inferior (i.e.  pid != 0) that has no threads.  */
+  if (has_single_non_exited_thread (tp->inf))
+    return false;
+
+  /* Do not remove the thread if we've requested to be notified of its
+     exit.  For example, the thread may be displaced stepping, infrun
+     will need to handle the exit event, and displaced stepping info is
+     recorded in the thread object.  If we deleted the thread now, we'd
+     lose that info.  */
+  if ((tp->thread_options () & GDB_THREAD_OPTION_EXIT) != 0)
+    return false;
+
+  return true;
+}
+
+/* Add the threads of CONTEXT that GDB doesn't know about yet, and
+   update the remote information of the others.  */
+
+void
+remote_target::remote_add_listed_threads (threads_listing_context *context)
+{
+  /* Remove any unreported fork/vfork/clone child threads from CONTEXT
+     so that we don't interfere with follow fork/vfork/clone, which is
+     where creation of such threads is handled.  */
+  remove_new_children (context);
+
+  for (thread_item &item : context->items)
+    {
+      if (item.ptid != null_ptid)
+	{
+	  /* In non-stop mode, we assume new found threads are
+	     executing until proven otherwise with a stop reply.  In
+	     all-stop, we can only get here if all threads are
+	     stopped.  */
+	  bool executing = target_is_non_stop_p ();
+
+	  remote_notice_new_inferior (item.ptid, executing);
+
+	  thread_info *tp = this->find_thread (item.ptid);
+	  remote_thread_info *info = get_remote_thread_info (tp);
+	  info->core = item.core;
+	  info->extra = std::move (item.extra);
+	  info->name = std::move (item.name);
+	  info->thread_handle = std::move (item.thread_handle);
+	}
+    }
+}
+
+/* Apply the changes to the remote thread list in DELTA, which only
+   touches the threads that changed, rather than reconciling GDB's
+   whole list with the target's.  */
+
+void
+remote_target::remote_apply_threads_delta (threads_delta_context *delta)
+{
+  for (ptid_t ptid : delta->exited)
+    {
+      thread_info *tp = this->find_thread (ptid);
+
+      /* GDB may not know about the thread, or may have already deleted
+	 it on an exit event.  */
+      if (tp != nullptr && remote_thread_may_be_pruned (tp))
+	delete_thread (tp);
+    }
+
+  for (auto &renamed : delta->renamed)
+    {
+      thread_info *tp = this->find_thread (renamed.first);
+
+      if (tp != nullptr)
+	get_remote_thread_info (tp)->name = std::move (renamed.second);
+    }
+
+  remote_add_listed_threads (&delta->created);
+}
+
 /* Implement the to_update_thread_list function for the remote
    targets.  */
 
@@ -4166,12 +4498,26 @@ void
 remote_target::update_thread_list ()
 {
   struct threads_listing_context context;
+  struct threads_delta_context delta;
   int got_list = 0;
 
+  /* If the target reports the changes to its thread list, only apply
+     those.  It may send the whole list instead, for instance the
+     first time.  */
+  bool got_delta = remote_get_threads_delta (&delta);
+  if (got_delta && !delta.full)
+    {
+      remote_apply_threads_delta (&delta);
+      return;
+    }
+  if (got_delta)
+    context = std::move (delta.created);
+
   /* We have a few different mechanisms to fetch the thread list.  Try
      them all, starting with the most preferred one first, falling
      back to older methods.  */
-  if (remote_get_threads_with_qxfer (&context)
+  if (got_delta
+      || remote_get_threads_with_qxfer (&context)
       || remote_get_threads_with_qthreadinfo (&context)
       || remote_get_threads_with_ql (&context))
     {
@@ -4191,62 +4537,23 @@ remote_target::update_thread_list ()
       /* CONTEXT now holds the current thread list on the remote
 	 target end.  Delete GDB-side threads no longer found on the
 	 target.  */
+      std::unordered_set<ptid_t> listed;
+      for (const thread_item &item : context.items)
+	listed.insert (item.ptid);
+
       for (thread_info *tp : all_threads_safe ())
 	{
 	  if (tp->inf->process_target () != this)
 	    continue;
 
-	  if (!context.contains_thread (tp->ptid))
-	    {
-	      /* Do not remove the thread if it is the last thread in
-		 the inferior.  This situation happens when we have a
-		 pending exit process status to process.  Otherwise we
-		 may end up with a seemingly live inferior (i.e.  pid
-		 != 0) that has no threads.  */
-	      if (has_single_non_exited_thread (tp->inf))
-		continue;
-
-	      /* Do not remove the thread if we've requested to be
-		 notified of its exit.  For example, the thread may be
-		 displaced stepping, infrun will need to handle the
-		 exit event, and displaced stepping info is recorded
-		 in the thread object.  If we deleted the thread now,
-		 we'd lose that info.  */
-	      if ((tp->thread_options () & GDB_THREAD_OPTION_EXIT) != 0)
-		continue;
-
-	      /* Not found.  */
-	      delete_thread (tp);
-	    }
+	  /* Not found.  */
+	  if (listed.find (tp->ptid) == listed.end ()
+	      && remote_thread_may_be_pruned (tp))
+	    delete_thread (tp);
 	}
 
-      /* Remove any unreported fork/vfork/clone child threads from
-	 CONTEXT so that we don't interfere with follow
-	 fork/vfork/clone, which is where creation of such threads is
-	 handled.  */
-      remove_new_children (&context);
-
       /* And now add threads we don't know about yet to our list.  */
-      for (thread_item &item : context.items)
-	{
-	  if (item.ptid != null_ptid)
-	    {
-	      /* In non-stop mode, we assume new found threads are
-		 executing until proven otherwise with a stop reply.
-		 In all-stop, we can only get here if all threads are
-		 stopped.  */
-	      bool executing = target_is_non_stop_p ();
-
-	      remote_notice_new_inferior (item.ptid, executing);
-
-	      thread_info *tp = this->find_thread (item.ptid);
-	      remote_thread_info *info = get_remote_thread_info (tp);
-	      info->core = item.core;
-	      info->extra = std::move (item.extra);
-	      info->name = std::move (item.name);
-	      info->thread_handle = std::move (item.thread_handle);
-	    }
-	}
+      remote_add_listed_threads (&context);
     }
 
   if (!got_list)
@@ -5610,6 +5917,44 @@ remote_supported_thread_options (remote_target *remote,
   remote->remote_supported_thread_options (feature, support, value);
 }
 
+void
+remote_target::remote_supported_compression (const protocol_feature *feature,
+					     enum packet_support support,
+					     const char *value)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  m_features.m_protocol_packets[feature->packet].support = support;
+  rs->compression = remote_compression::none;
+
+  if (support != PACKET_ENABLE)
+    return;
+
+  if (value != nullptr && strcmp (value, "zlib") == 0)
+    rs->compression = remote_compression::zlib;
+#ifdef HAVE_ZSTD
+  else if (value != nullptr && strcmp (value, "zstd") == 0)
+    rs->compression = remote_compression::zstd;
+#endif
+  else
+    {
+      warning (_("Remote target reported \"%s\" with "
+		 "an unexpected algorithm: \"%s\"."),
+	       feature->name, value == nullptr ? "" : value);
+      m_features.m_protocol_packets[feature->packet].support
+	= PACKET_DISABLE;
+    }
+}
+
+static void
+remote_supported_compression (remote_target *remote,
+			      const protocol_feature *feature,
+			      enum packet_support support,
+			      const char *value)
+{
+  remote->remote_supported_compression (feature, support, value);
+}
+
 static const struct protocol_feature remote_protocol_features[] = {
   { "PacketSize", PACKET_DISABLE, remote_packet_size, -1 },
   { "qXfer:auxv:read", PACKET_DISABLE, remote_supported_packet,
@@ -5630,6 +5975,8 @@ static const struct protocol_feature remote_protocol_features[] = {
     PACKET_qXfer_osdata },
   { "qXfer:threads:read", PACKET_DISABLE, remote_supported_packet,
     PACKET_qXfer_threads },
+  { "qXfer:threads-delta:read", PACKET_DISABLE, remote_supported_packet,
+    PACKET_qXfer_threads_delta },
   { "qXfer:traceframe-info:read", PACKET_DISABLE, remote_supported_packet,
     PACKET_qXfer_traceframe_info },
   { "QPassSignals", PACKET_DISABLE, remote_supported_packet,
@@ -5663,6 +6010,8 @@ static const struct protocol_feature remote_protocol_features[] = {
     PACKET_ConditionalBreakpoints },
   { "BreakpointCommands", PACKET_DISABLE, remote_supported_packet,
     PACKET_BreakpointCommands },
+  { "FastBreakpoints", PACKET_DISABLE, remote_supported_packet,
+    PACKET_FastBreakpoints },
   { "FastTracepoints", PACKET_DISABLE, remote_supported_packet,
     PACKET_FastTracepoints },
   { "StaticTracepoints", PACKET_DISABLE, remote_supported_packet,
@@ -5717,6 +6066,12 @@ static const struct protocol_feature remote_protocol_features[] = {
   { "no-resumed", PACKET_DISABLE, remote_supported_packet, PACKET_no_resumed },
   { "memory-tagging", PACKET_DISABLE, remote_supported_packet,
     PACKET_memory_tagging_feature },
+  { "memory-read-pipeline", PACKET_DISABLE, remote_supported_packet,
+    PACKET_memory_read_pipeline_feature },
+  { "vFile-pread-pipeline", PACKET_DISABLE, remote_supported_packet,
+    PACKET_vFile_pread_pipeline_feature },
+  { "compression", PACKET_DISABLE, remote_supported_compression,
+    PACKET_compression_feature },
 };
 
 static char *remote_support_xml;
@@ -5828,6 +6183,23 @@ remote_target::remote_query_supported ()
 	  != AUTO_BOOLEAN_FALSE)
 	remote_query_supported_append (&q, "memory-tagging+");
 
+      if (m_features.packet_set_cmd_state (PACKET_memory_read_pipeline_feature)
+	  != AUTO_BOOLEAN_FALSE)
+	remote_query_supported_append (&q, "memory-read-pipeline+");
+
+      if (m_features.packet_set_cmd_state (PACKET_vFile_pread_pipeline_feature)
+	  != AUTO_BOOLEAN_FALSE)
+	remote_query_supported_append (&q, "vFile-pread-pipeline+");
+
+      /* The algorithms we can expand, the preferred one first.  */
+      if (m_features.packet_set_cmd_state (PACKET_compression_feature)
+	  != AUTO_BOOLEAN_FALSE)
+#ifdef HAVE_ZSTD
+	remote_query_supported_append (&q, "compression=zstd,zlib");
+#else
+	remote_query_supported_append (&q, "compression=zlib");
+#endif
+
       /* Keep this one last to work around a gdbserver <= 7.10 bug in
 	 the qSupported:xmlRegisters=i386 handling.  */
       if (remote_support_xml != NULL
@@ -9545,6 +9917,18 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   todo_units = std::min (len_units,
 			 (ULONGEST) (buf_size_bytes / unit_size) / 2);
 
+  /* If the read needs several packets, keep some of them in flight.
+     This needs no-ack mode, as otherwise the acks of the packets
+     would be interleaved with the replies.  */
+  if (todo_units < len_units
+      && remote_memory_read_window > 1
+      && rs->noack_mode
+      && (m_features.packet_support (PACKET_memory_read_pipeline_feature)
+	  == PACKET_ENABLE))
+    return remote_read_bytes_pipelined (memaddr, myaddr, len_units,
+					todo_units, unit_size,
+					xfered_len_units);
+
   /* Construct "m"<memaddr>","<len>".  */
   memaddr = remote_address_masked (memaddr);
   p = rs->buf.data ();
@@ -9568,6 +9952,124 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
 }
 
+/* Read LEN_UNITS units of memory at MEMADDR into MYADDR, with "m"
+   packets of at most PACKET_UNITS units, of which up to
+   remote_memory_read_window are sent before waiting for their replies.
+   The stub replies to them in order; reading stops at the first error
+   or short reply, and the replies still in flight are then discarded.
+   They are discarded as well before an exception thrown while reading
+   a reply is propagated.
+
+   Arguments and return value are like remote_read_bytes_1.  */
+
+target_xfer_status
+remote_target::remote_read_bytes_pipelined (CORE_ADDR memaddr,
+					    gdb_byte *myaddr,
+					    ULONGEST len_units,
+					    ULONGEST packet_units,
+					    int unit_size,
+					    ULONGEST *xfered_len_units)
+{
+  struct remote_state *rs = get_remote_state ();
+  /* The size in units of each packet in flight, oldest first.  */
+  std::deque<ULONGEST> in_flight;
+  ULONGEST sent_units = 0;
+  ULONGEST received_units = 0;
+  bool stopped = false;
+  bool error_reply = false;
+
+  while (in_flight.size () > 0 || (!stopped && sent_units < len_units))
+    {
+      while (!stopped
+	     && sent_units < len_units
+	     && in_flight.size () < remote_memory_read_window)
+	{
+	  ULONGEST todo_units = std::min (len_units - sent_units,
+					  packet_units);
+	  /* 'm', two hex numbers and a ','.  */
+	  char packet[2 + 2 * 2 * sizeof (ULONGEST) + 1];
+	  char *p = packet;
+
+	  /* Construct "m"<memaddr>","<len>".  */
+	  *p++ = 'm';
+	  p += hexnumstr (p, (ULONGEST) remote_address_masked (memaddr
+							       + sent_units));
+	  *p++ = ',';
+	  p += hexnumstr (p, todo_units);
+	  *p = '\0';
+	  putpkt (packet);
+
+	  in_flight.push_back (todo_units);
+	  sent_units += todo_units;
+	}
+
+      ULONGEST todo_units = in_flight.front ();
+      in_flight.pop_front ();
+      try
+	{
+	  getpkt (&rs->buf);
+	}
+      catch (const gdb_exception &ex)
+	{
+	  discard_pipelined_replies (in_flight.size ());
+	  throw;
+	}
+      if (stopped)
+	continue;
+
+      if (rs->buf[0] == 'E'
+	  && isxdigit (rs->buf[1]) && isxdigit (rs->buf[2])
+	  && rs->buf[3] == '\0')
+	{
+	  error_reply = received_units == 0;
+	  stopped = true;
+	  continue;
+	}
+
+      /* Reply describes memory byte by byte, each byte encoded as two
+	 hex characters.  */
+      int decoded_bytes = hex2bin (rs->buf.data (),
+				   myaddr + received_units * unit_size,
+				   todo_units * unit_size);
+      received_units += decoded_bytes / unit_size;
+      if (decoded_bytes / unit_size < todo_units)
+	stopped = true;
+    }
+
+  if (error_reply)
+    return TARGET_XFER_E_IO;
+
+  /* Return what we have.  Let higher layers handle partial reads.  */
+  *xfered_len_units = received_units;
+  return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
+}
+
+/* Read and discard the replies to the COUNT packets still in flight
+   when an error interrupted a pipelined read, so that they are not
+   taken for the replies to the packets sent next.  */
+
+void
+remote_target::discard_pipelined_replies (size_t count)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  for (; count > 0; count--)
+    {
+      /* If the error closed the connection, nothing is left to read.  */
+      if (rs->remote_desc == nullptr)
+	return;
+
+      try
+	{
+	  getpkt (&rs->buf);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  /* The reply is consumed even if it is bad.  */
+	}
+    }
+}
+
 /* Using the set of read-only target sections of remote, read live
    read-only memory.
 
@@ -9877,6 +10379,118 @@ escape_buffer (const char *buf, int n)
   return stb.release ();
 }
 
+/* Return the kind of the packet of LEN bytes in BUF, under which the
+   statistics of its replies are kept: the object and operation of a
+   "qXfer" packet, the operation of a "vFile" packet, the name of the
+   other 'q', 'Q' and 'v' packets, and the first character of the
+   others.  */
+
+static std::string
+remote_packet_kind (const char *buf, int len)
+{
+  if (len == 0)
+    return {};
+
+  int fields;
+  if (startswith (buf, "qXfer:"))
+    fields = 3;
+  else if (startswith (buf, "vFile:"))
+    fields = 2;
+  else if (buf[0] == 'q' || buf[0] == 'Q' || buf[0] == 'v')
+    fields = 1;
+  else
+    return std::string (buf, 1);
+
+  int end;
+  for (end = 0; end < len; end++)
+    if (buf[end] == ';' || buf[end] == ','
+	|| (buf[end] == ':' && --fields == 0))
+      break;
+
+  return std::string (buf, end);
+}
+
+/* Return true if the target may compress the replies to the packets
+   of KIND, see remote_packet_kind.  These are the large replies to
+   memory and register reads, qXfer objects and target file reads.
+   Other replies starting with 'Z' are left alone.  */
+
+static bool
+remote_reply_compressible (const std::string &kind)
+{
+  return (kind == "m" || kind == "g"
+	  || startswith (kind, "qXfer:")
+	  || kind == "vFile:pread");
+}
+
+/* The original reply of a compressed reply is at most this many times
+   the size of the remote packets.  Each byte of the data read is sent
+   as two characters at most, in hex or escaped.  */
+
+#define REMOTE_DECOMPRESS_MAX_FACTOR 4
+
+/* Expand the compressed reply of LEN bytes in *BUF, which the target
+   compressed with ALGORITHM.  A compressed reply is 'Z', the length
+   of the original reply in hex, ':', and the original reply
+   compressed and then escaped like binary data.  The original reply
+   must be shorter than MAX_SIZE.  Return the length of the original
+   reply, which replaces the compressed one in *BUF.  */
+
+static int
+remote_decompress_packet (remote_compression algorithm,
+			  gdb::char_vector *buf, int len, long max_size)
+{
+  ULONGEST size;
+  const char *p = unpack_varlen_hex (buf->data () + 1, &size);
+
+  if (*p != ':' || size >= max_size)
+    error (_("Malformed compressed reply from the remote target."));
+  p++;
+
+  int escaped_len = len - (p - buf->data ());
+  gdb::byte_vector packed (escaped_len);
+  int packed_len = remote_unescape_input ((const gdb_byte *) p, escaped_len,
+					  packed.data (), escaped_len);
+
+  if (buf->size () < size + 1)
+    buf->resize (size + 1);
+
+  bool ok = false;
+  switch (algorithm)
+    {
+    case remote_compression::zlib:
+      {
+	uLongf out_len = size;
+
+	ok = (uncompress ((Bytef *) buf->data (), &out_len,
+			  packed.data (), packed_len) == Z_OK
+	      && out_len == size);
+      }
+      break;
+
+#ifdef HAVE_ZSTD
+    case remote_compression::zstd:
+      {
+	size_t out_len = ZSTD_decompress (buf->data (), size,
+					  packed.data (), packed_len);
+
+	ok = !ZSTD_isError (out_len) && out_len == size;
+      }
+      break;
+#endif
+
+    default:
+      gdb_assert_not_reached ("unexpected compression algorithm");
+    }
+
+  if (!ok)
+    error (_("Could not expand a compressed reply "
+	     "from the remote target."));
+
+  (*buf)[size] = '\0';
+  return size;
+}
+
 int
 remote_target::putpkt (const char *buf)
 {
@@ -9927,6 +10541,9 @@ remote_target::putpkt_binary (const char *buf, int cnt)
 	       "and then try again."));
     }
 
+  /* Count the replies under the kind of this packet.  */
+  rs->last_packet_kind = remote_packet_kind (buf, cnt);
+
   /* Copy the packet into buffer BUF2, encapsulating it
      and giving it a checksum.  */
 
@@ -10347,6 +10964,24 @@ remote_target::getpkt (gdb::char_vector *buf, bool forever, bool *is_notif)
 	  /* Skip the ack char if we're in no-ack mode.  */
 	  if (!rs->noack_mode)
 	    remote_serial_write ("+", 1);
+
+	  remote_packet_stats &stats
+	    = rs->packet_stats[rs->last_packet_kind];
+	  stats.replies++;
+	  stats.wire_bytes += val;
+	  if (rs->compression != remote_compression::none
+	      && val > 0 && (*buf)[0] == 'Z'
+	      && remote_reply_compressible (rs->last_packet_kind))
+	    {
+	      long max_size = (REMOTE_DECOMPRESS_MAX_FACTOR
+			       * get_remote_packet_size ());
+	      val = remote_decompress_packet (rs->compression, buf, val,
+					      max_size);
+	      stats.compressed++;
+	      remote_debug_printf_nofunc ("Expanded to %d bytes", val);
+	    }
+	  stats.bytes += val;
+
 	  if (is_notif != NULL)
 	    *is_notif = false;
 	  return val;
@@ -10873,6 +11508,32 @@ remote_add_target_side_commands (struct gdbarch *gdbarch,
     }
 }
 
+/* Return the length of the instruction at the location whose target
+   info is BP_TGT, for the option letting the target replace the
+   breakpoint with a jump to code evaluating the breakpoint's condition
+   in the inferior, or 0 if the breakpoint doesn't qualify.  Only
+   breakpoints with conditions and without commands do.  This reads
+   memory, so it must be called before the packet is put in the
+   packet buffer.  */
+
+static int
+remote_fast_breakpoint_insn_length (struct gdbarch *gdbarch,
+				    struct bp_target_info *bp_tgt)
+{
+  if (bp_tgt->conditions.empty () || !bp_tgt->tcommands.empty ())
+    return 0;
+
+  try
+    {
+      return gdb_insn_length (gdbarch, bp_tgt->reqstd_address);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      /* Let the target use a plain breakpoint.  */
+      return 0;
+    }
+}
+
 /* Insert a breakpoint.  On targets that have software breakpoint
    support, we ask the remote target to do the work; on targets
    which don't, we insert a traditional memory breakpoint.  */
@@ -10891,12 +11552,18 @@ remote_target::insert_breakpoint (struct gdbarch *gdbarch,
       CORE_ADDR addr = bp_tgt->reqstd_address;
       struct remote_state *rs;
       char *p, *endbuf;
+      int fast_insn_len = 0;
 
       /* Make sure the remote is pointing at the right process, if
 	 necessary.  */
       if (!gdbarch_has_global_breakpoints (current_inferior ()->arch ()))
 	set_general_process ();
 
+      if (supports_evaluation_of_breakpoint_conditions ()
+	  && (m_features.packet_support (PACKET_FastBreakpoints)
+	      == PACKET_ENABLE))
+	fast_insn_len = remote_fast_breakpoint_insn_length (gdbarch, bp_tgt);
+
       rs = get_remote_state ();
       p = rs->buf.data ();
       endbuf = p + get_remote_packet_size ();
@@ -10914,8 +11581,17 @@ remote_target::insert_breakpoint (struct gdbarch *gdbarch,
       if (can_run_breakpoint_commands ())
 	remote_add_target_side_commands (gdbarch, bp_tgt, p);
 
+      if (fast_insn_len > 0)
+	{
+	  p += strlen (p);
+	  xsnprintf (p, endbuf - p, ";F%x", fast_insn_len);
+	}
+
       putpkt (rs->buf);
-      getpkt (&rs->buf);
+
+      /* The target may ask us to relocate the instruction at the
+	 breakpoint while it installs a fast breakpoint.  */
+      remote_get_noisy_reply (true);
 
       switch (m_features.packet_ok (rs->buf, PACKET_Z0))
 	{
@@ -11657,6 +12333,11 @@ remote_target::xfer_partial (enum target_object object,
 	("threads", annex, readbuf, offset, len, xfered_len,
 	 PACKET_qXfer_threads);
 
+    case TARGET_OBJECT_THREADS_DELTA:
+      return remote_read_qxfer
+	("threads-delta", annex, readbuf, offset, len, xfered_len,
+	 PACKET_qXfer_threads_delta);
+
     case TARGET_OBJECT_TRACEFRAME_INFO:
       gdb_assert (annex == NULL);
       return remote_read_qxfer
@@ -12004,6 +12685,56 @@ cli_packet_command (const char *args, int from_tty)
   send_remote_packet (view, &cb);
 }
 
+/* Entry point for the 'maint print remote-stats' command.  */
+
+static void
+maint_print_remote_stats (const char *args, int from_tty)
+{
+  remote_target *remote = get_current_remote_target ();
+  if (remote == nullptr)
+    error (_("No remote target."));
+
+  remote_state *rs = remote->get_remote_state ();
+  const char *algorithm = "none";
+  if (rs->compression == remote_compression::zlib)
+    algorithm = "zlib";
+  else if (rs->compression == remote_compression::zstd)
+    algorithm = "zstd";
+  gdb_printf (_("Reply compression: %s\n"), algorithm);
+
+  int width = strlen ("Packet");
+  for (const auto &entry : rs->packet_stats)
+    width = std::max (width, (int) entry.first.size ());
+
+  ui_out_emit_table table_emitter (current_uiout, 6,
+				   rs->packet_stats.size (), "remote-stats");
+  current_uiout->table_header (width, ui_left, "packet", "Packet");
+  current_uiout->table_header (10, ui_right, "replies", "Replies");
+  current_uiout->table_header (10, ui_right, "compressed", "Compressed");
+  current_uiout->table_header (12, ui_right, "wire-bytes", "Wire bytes");
+  current_uiout->table_header (12, ui_right, "bytes", "Bytes");
+  current_uiout->table_header (6, ui_right, "ratio", "Ratio");
+  current_uiout->table_body ();
+
+  for (const auto &entry : rs->packet_stats)
+    {
+      const remote_packet_stats &stats = entry.second;
+      ui_out_emit_tuple tuple_emitter (current_uiout, nullptr);
+
+      current_uiout->field_string ("packet", entry.first.c_str ());
+      current_uiout->field_unsigned ("replies", stats.replies);
+      current_uiout->field_unsigned ("compressed", stats.compressed);
+      current_uiout->field_unsigned ("wire-bytes", stats.wire_bytes);
+      current_uiout->field_unsigned ("bytes", stats.bytes);
+      if (stats.wire_bytes > 0)
+	current_uiout->field_fmt ("ratio", "%.2f",
+				  (double) stats.bytes / stats.wire_bytes);
+      else
+	current_uiout->field_skip ("ratio");
+      current_uiout->text ("\n");
+    }
+}
+
 #if 0
 /* --------- UNIT_TEST for THREAD oriented PACKETS ------------------- */
 
@@ -12749,6 +13480,119 @@ remote_target::remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
   return ret;
 }
 
+/* Helper for the implementation of to_fileio_pread.  Read LEN bytes
+   of the file at OFFSET with "vFile:pread" packets of at most
+   BLOCK_LEN bytes, of which up to remote_memory_read_window are sent
+   before waiting for their replies, like remote_read_bytes_pipelined
+   does for memory.  Reading stops at the first error or short reply,
+   and the replies still in flight are then discarded, as they are
+   before any exception is thrown.  Return the number of bytes read,
+   or -1 with *REMOTE_ERRNO set if the first request failed.  */
+
+int
+remote_target::remote_hostio_pread_pipelined (int fd, gdb_byte *read_buf,
+					      int len, ULONGEST offset,
+					      int block_len,
+					      fileio_error *remote_errno)
+{
+  struct remote_state *rs = get_remote_state ();
+  /* The size of each request in flight, oldest first.  */
+  std::deque<int> in_flight;
+  int sent = 0;
+  int received = 0;
+  bool stopped = false;
+  bool error_reply = false;
+  /* The length of a reply whose data did not match it, and the length
+     of its data, if there was one.  */
+  int bad_reply_ret = -1;
+  int bad_reply_len = 0;
+
+  while (in_flight.size () > 0 || (!stopped && sent < len))
+    {
+      while (!stopped
+	     && sent < len
+	     && in_flight.size () < remote_memory_read_window)
+	{
+	  int todo = std::min (len - sent, block_len);
+	  char packet[64];
+
+	  xsnprintf (packet, sizeof (packet), "vFile:pread:%x,%x,%s",
+		     fd, todo, phex_nz (offset + sent, sizeof (ULONGEST)));
+	  putpkt (packet);
+
+	  in_flight.push_back (todo);
+	  sent += todo;
+	}
+
+      int todo = in_flight.front ();
+      in_flight.pop_front ();
+      int bytes_read;
+      try
+	{
+	  bytes_read = getpkt (&rs->buf);
+	}
+      catch (const gdb_exception &ex)
+	{
+	  discard_pipelined_replies (in_flight.size ());
+	  throw;
+	}
+      if (stopped)
+	continue;
+
+      int ret = -1;
+      const char *attachment = NULL;
+      fileio_error reply_errno = FILEIO_EINVAL;
+      bool parsed = (bytes_read >= 0
+		     && (m_features.packet_ok (rs->buf, PACKET_vFile_pread)
+			 == PACKET_OK)
+		     && remote_hostio_parse_result (rs->buf.data (), &ret,
+						    &reply_errno,
+						    &attachment) == 0);
+      if (parsed && ret == 0)
+	{
+	  /* End of file.  */
+	  stopped = true;
+	  continue;
+	}
+      if (!parsed || ret < 0 || attachment == NULL)
+	{
+	  if (received == 0)
+	    {
+	      error_reply = true;
+	      *remote_errno = parsed && ret < 0 ? reply_errno : FILEIO_EINVAL;
+	    }
+	  stopped = true;
+	  continue;
+	}
+
+      int attachment_len = bytes_read - (attachment - rs->buf.data ());
+      int read_len = remote_unescape_input ((gdb_byte *) attachment,
+					    attachment_len,
+					    read_buf + received, todo);
+      if (read_len != ret)
+	{
+	  /* Report the bad reply once the others have been read.  */
+	  bad_reply_ret = ret;
+	  bad_reply_len = read_len;
+	  stopped = true;
+	  continue;
+	}
+
+      received += ret;
+      if (ret < todo)
+	stopped = true;
+    }
+
+  if (bad_reply_ret != -1)
+    error (_("Read returned %d, but %d bytes."), bad_reply_ret,
+	   bad_reply_len);
+
+  if (error_reply)
+    return -1;
+
+  return received;
+}
+
 /* See declaration.h.  */
 
 int
@@ -12791,6 +13635,23 @@ remote_target::remote_hostio_pread (int fd, gdb_byte *read_buf, int len,
       return ret;
     }
 
+  /* A read larger than a packet is split into requests that are kept
+     in flight, as for memory reads.  Ask for few enough bytes that the
+     stub never has to shorten a reply to fit the escaped data.  */
+  int block_len = (get_remote_packet_size () - 32) / 2;
+  if (len > block_len
+      && block_len > 0
+      && remote_memory_read_window > 1
+      && rs->noack_mode
+      && (m_features.packet_support (PACKET_vFile_pread_pipeline_feature)
+	  == PACKET_ENABLE)
+      && m_features.packet_support (PACKET_vFile_pread) != PACKET_DISABLE)
+    {
+      remote_debug_printf ("pipelined read of %d bytes", len);
+      return remote_hostio_pread_pipelined (fd, read_buf, len, offset,
+					    block_len, remote_errno);
+    }
+
   cache->miss_count++;
 
   remote_debug_printf ("readahead cache miss %s",
@@ -15669,6 +16530,13 @@ response packet.  GDB supplies the initial `$' character, and the\n\
 terminating `#' character and checksum."),
 	   &maintenancelist);
 
+  add_cmd ("remote-stats", class_maintenance, maint_print_remote_stats, _("\
+Print statistics of the replies of the remote target.\n\
+For each kind of packet, show the number of replies, how many of them\n\
+were compressed, their size as received and once expanded, and the\n\
+ratio of the two."),
+	   &maintenanceprintlist);
+
   set_show_commands remotebreak_cmds
     = add_setshow_boolean_cmd ("remotebreak", no_class, &remote_break, _("\
 Set whether to send break if interrupted."), _("\
@@ -15754,6 +16622,17 @@ Specify \"unlimited\" for unlimited hardware breakpoints."),
 			    NULL, show_hardware_breakpoint_limit,
 			    &remote_set_cmdlist, &remote_show_cmdlist);
 
+  add_setshow_zuinteger_cmd ("memory-read-window", no_class,
+			     &remote_memory_read_window, _("\
+Set the number of memory-read packets kept in flight."), _("\
+Show the number of memory-read packets kept in flight."), _("\
+When reading memory spanning several packets, send this many\n\
+memory-read packets before waiting for their replies.  This needs\n\
+no-ack mode and a remote stub supporting it.  Zero or one disable\n\
+sending several packets at a time."),
+			     NULL, show_remote_memory_read_window,
+			     &remote_set_cmdlist, &remote_show_cmdlist);
+
   add_setshow_zuinteger_cmd ("remoteaddresssize", class_obscure,
 			     &remote_address_size, _("\
 Set the maximum size of the address (in bits) in a memory packet."), _("\
@@ -15831,6 +16710,9 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (PACKET_qXfer_threads, "qXfer:threads:read", "threads",
 			 0);
 
+  add_packet_config_cmd (PACKET_qXfer_threads_delta, "qXfer:threads-delta:read",
+			 "threads-delta", 0);
+
   add_packet_config_cmd (PACKET_qXfer_siginfo_read, "qXfer:siginfo:read",
 			 "read-siginfo-object", 0);
 
@@ -15901,6 +16783,9 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (PACKET_BreakpointCommands, "BreakpointCommands",
 			 "breakpoint-commands", 0);
 
+  add_packet_config_cmd (PACKET_FastBreakpoints, "FastBreakpoints",
+			 "fast-breakpoints", 0);
+
   add_packet_config_cmd (PACKET_FastTracepoints, "FastTracepoints",
 			 "fast-tracepoints", 0);
 
@@ -15984,6 +16869,17 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (PACKET_memory_tagging_feature,
 			 "memory-tagging-feature", "memory-tagging-feature", 0);
 
+  add_packet_config_cmd (PACKET_memory_read_pipeline_feature,
+			 "memory-read-pipeline-feature",
+			 "memory-read-pipeline-feature", 0);
+
+  add_packet_config_cmd (PACKET_vFile_pread_pipeline_feature,
+			 "vFile-pread-pipeline-feature",
+			 "hostio-pread-pipeline-feature", 0);
+
+  add_packet_config_cmd (PACKET_compression_feature,
+			 "compression-feature", "compression-feature", 0);
+
   /* Assert that we've registered "set remote foo-packet" commands
      for all packet configs.  */
   {
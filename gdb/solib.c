@@ -986,10 +986,18 @@ solib_add (const char *pattern, int from_tty, int readsyms)
     bool any_matches = false;
     bool loaded_any_symbols = false;
     symfile_add_flags add_flags = SYMFILE_DEFER_BP_RESET;
+    std::vector<objfile *> new_objfiles;
 
     if (from_tty)
 	add_flags |= SYMFILE_VERBOSE;
 
+    /* Read the debug info of the libraries in the background, so that
+       the debug info of one library is indexed while the next ones are
+       opened and their minimal symbols read.  This waits for all of it
+       before the breakpoints are re-set below.  */
+    gdb::optional<scoped_background_symbol_reading> background_reading;
+    background_reading.emplace (from_tty);
+
     for (shobj &gdb : current_program_space->solibs ())
       if (! pattern || re_exec (gdb.so_name.c_str ()))
 	{
@@ -1013,12 +1021,18 @@ solib_add (const char *pattern, int from_tty, int readsyms)
 				gdb.so_name.c_str ());
 		}
 	      else if (solib_read_symbols (gdb, add_flags))
-		loaded_any_symbols = true;
+		{
+		  loaded_any_symbols = true;
+		  if (gdb.objfile != nullptr)
+		    new_objfiles.push_back (gdb.objfile);
+		}
 	    }
 	}
 
+    background_reading.reset ();
+
     if (loaded_any_symbols)
-      breakpoint_re_set ();
+      breakpoint_re_set_objfiles (new_objfiles);
 
     if (from_tty && pattern && ! any_matches)
       gdb_printf
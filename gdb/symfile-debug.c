@@ -531,6 +531,17 @@ objfile::lookup_global_symbol_language (const char *name,
   return result;
 }
 
+void
+objfile::start_reading_partial_symbols ()
+{
+  if ((flags & OBJF_PSYMTABS_READ) == 0)
+    {
+      for (const auto &iter : qf)
+	if (iter->can_lazily_read_symbols ())
+	  iter->start_reading_partial_symbols (this);
+    }
+}
+
 void
 objfile::require_partial_symbols (bool verbose)
 {
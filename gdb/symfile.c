@@ -68,6 +68,7 @@
 #include <ctype.h>
 #include <chrono>
 #include <algorithm>
+#include <unordered_set>
 
 int (*deprecated_ui_load_progress_hook) (const char *section,
 					 unsigned long num);
@@ -790,10 +791,80 @@ read_symbols (struct objfile *objfile, symfile_add_flags add_flags)
 				    add_flags | SYMFILE_NOT_FILENAME, objfile);
 	}
     }
-  if ((add_flags & SYMFILE_NO_READ) == 0)
+  if ((add_flags & SYMFILE_NO_READ) == 0
+      && !scoped_background_symbol_reading::start (objfile))
     objfile->require_partial_symbols (false);
 }
 
+/* The active scoped_background_symbol_reading, if any.  */
+
+static scoped_background_symbol_reading *background_symbol_reading;
+
+scoped_background_symbol_reading::scoped_background_symbol_reading
+     (int from_tty)
+  : m_from_tty (from_tty),
+    m_pspace (current_program_space)
+{
+  if (background_symbol_reading == nullptr)
+    {
+      background_symbol_reading = this;
+      m_active = true;
+      m_complaint_handler.emplace ();
+    }
+}
+
+scoped_background_symbol_reading::~scoped_background_symbol_reading ()
+{
+  if (!m_active)
+    return;
+
+  background_symbol_reading = nullptr;
+
+  /* Some of the objfiles may have been freed meanwhile, so only read
+     those still in the program space.  */
+  std::unordered_set<objfile *> started (m_objfiles.begin (),
+					 m_objfiles.end ());
+  gdb::optional<ui_out::progress_update> progress;
+  if (started.size () > 1 && print_symbol_loading_p (m_from_tty, 0, 1))
+    progress.emplace ();
+
+  std::string message
+    = string_printf (_("Reading symbols of %zu objfiles"), started.size ());
+  size_t n_read = 0;
+  for (objfile *objfile : m_pspace->objfiles ())
+    {
+      if (started.find (objfile) == started.end ())
+	continue;
+
+      try
+	{
+	  if (progress.has_value ())
+	    progress->update_progress (message, _("objfiles"),
+				       (double) n_read / started.size (),
+				       started.size ());
+	  objfile->require_partial_symbols (false);
+	}
+      catch (const gdb_exception &except)
+	{
+	  exception_print (gdb_stderr, except);
+	}
+      ++n_read;
+    }
+}
+
+/* See symfile.h.  */
+
+bool
+scoped_background_symbol_reading::start (struct objfile *objfile)
+{
+  if (background_symbol_reading == nullptr)
+    return false;
+
+  objfile->start_reading_partial_symbols ();
+  background_symbol_reading->m_objfiles.push_back (objfile);
+  return true;
+}
+
 /* Initialize entry point information for this objfile.  */
 
 static void
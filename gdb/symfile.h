@@ -29,6 +29,8 @@
 #include "gdbsupport/function-view.h"
 #include "target-section.h"
 #include "quick-symbol.h"
+#include "complaints.h"
+#include "gdbsupport/gdb_optional.h"
 
 /* Opaque declarations.  */
 struct target_section;
@@ -241,6 +243,42 @@ extern struct objfile *symbol_file_add_from_bfd (const gdb_bfd_ref_ptr &,
 extern void symbol_file_add_separate (const gdb_bfd_ref_ptr &, const char *,
 				      symfile_add_flags, struct objfile *);
 
+/* While an instance of this class exists, the partial symbols of the
+   objfiles that are added are read in the background, rather than
+   before symbol_file_add returns, so that those of several objfiles
+   are read at the same time.  When the instance is destroyed, it waits
+   for the reading to complete, and reports progress if FROM_TTY
+   requests it.  Instances do not nest: an inner one does nothing.  */
+
+class scoped_background_symbol_reading
+{
+public:
+  explicit scoped_background_symbol_reading (int from_tty);
+  ~scoped_background_symbol_reading ();
+
+  DISABLE_COPY_AND_ASSIGN (scoped_background_symbol_reading);
+
+  /* Start reading the partial symbols of OBJFILE, if an instance of
+     this class exists, and return true.  Otherwise return false.  */
+  static bool start (struct objfile *objfile);
+
+private:
+  /* True if this is the active instance.  */
+  bool m_active = false;
+
+  int m_from_tty;
+
+  /* The program space of the objfiles.  */
+  struct program_space *m_pspace;
+
+  /* The objfiles whose partial symbols are being read.  */
+  std::vector<struct objfile *> m_objfiles;
+
+  /* The complaints issued in the background are held until the reading
+     is complete.  */
+  gdb::optional<complaint_interceptor> m_complaint_handler;
+};
+
 /* Find separate debuginfo for OBJFILE (using .gnu_debuglink section).
    Returns pathname, or an empty string.
 
@@ -633,12 +633,22 @@ iterate_over_some_symtabs (const char *name,
    in the symtab filename will also work.
 
    Calls CALLBACK with each symtab that is found.  If CALLBACK returns
-   true, the search stops.  */
+   true, the search stops.  If SEARCH_OBJFILE is not NULL, only the
+   symtabs of SEARCH_OBJFILE and of its separate debug objfiles are
+   searched.  */
 
 void
 iterate_over_symtabs (const char *name,
-		      gdb::function_view<bool (symtab *)> callback)
+		      gdb::function_view<bool (symtab *)> callback,
+		      struct objfile *search_objfile)
 {
+  auto skip = [=] (objfile *objfile)
+    {
+      if (objfile->separate_debug_objfile_backlink != nullptr)
+	objfile = objfile->separate_debug_objfile_backlink;
+      return search_objfile != nullptr && objfile != search_objfile;
+    };
+
   gdb::unique_xmalloc_ptr<char> real_path;
 
   /* Here we are interested in canonicalizing an absolute path, not
@@ -651,6 +661,8 @@ iterate_over_symtabs (const char *name,
 
   for (objfile *objfile : current_program_space->objfiles ())
     {
+      if (skip (objfile))
+	continue;
       if (iterate_over_some_symtabs (name, real_path.get (),
 				     objfile->compunit_symtabs, NULL,
 				     callback))
@@ -662,6 +674,8 @@ iterate_over_symtabs (const char *name,
 
   for (objfile *objfile : current_program_space->objfiles ())
     {
+      if (skip (objfile))
+	continue;
       if (objfile->map_symtabs_matching_filename (name, real_path.get (),
 						  callback))
 	return;
@@ -2736,7 +2736,8 @@ bool iterate_over_some_symtabs (const char *name,
 				gdb::function_view<bool (symtab *)> callback);
 
 void iterate_over_symtabs (const char *name,
-			   gdb::function_view<bool (symtab *)> callback);
+			   gdb::function_view<bool (symtab *)> callback,
+			   struct objfile *search_objfile = nullptr);
 
 
 std::vector<CORE_ADDR> find_pcs_for_symtab_line
@@ -0,0 +1,412 @@
+/* Caching of files read from the target.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "target-file-cache.h"
+
+#include "cli/cli-cmds.h"
+#include "command.h"
+#include "gdbcmd.h"
+#include "target.h"
+#include "elf/common.h"
+#include "elf/external.h"
+#include "filenames.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/pathstuff.h"
+#include "gdbsupport/rsp-low.h"
+#include "gdbsupport/byte-vector.h"
+#include "gdbsupport/fileio.h"
+#include <sys/stat.h>
+
+/* When set to true, show debug messages about the target file
+   cache.  */
+static bool debug_target_file_cache = false;
+
+#define target_file_cache_debug(FMT, ...)				\
+  debug_prefixed_printf_cond_nofunc (debug_target_file_cache,		\
+				     "target-file-cache", FMT, ## __VA_ARGS__)
+
+/* Whether the cache is used, for "set/show target-file-cache
+   enabled".  */
+static bool target_file_cache_enabled = false;
+
+/* The cache directory, for "set/show target-file-cache directory".  */
+static std::string target_file_cache_directory;
+
+/* The number of files found in the cache, the number of files copied
+   to it, and the number of bytes copied, in this session.  */
+static unsigned int target_file_cache_hits;
+static unsigned int target_file_cache_misses;
+static ULONGEST target_file_cache_bytes_fetched;
+
+/* The number of bytes at the start of a file read to find its build
+   ID.  ELF linkers put the notes right after the program headers, so
+   this is usually enough.  */
+#define HEAD_SIZE 4096
+
+/* The number of bytes asked to the target at once when copying a
+   file.  Targets that can keep several requests in flight, like the
+   remote target, use them for such a large read.  */
+#define FETCH_BLOCK_SIZE (1024 * 1024)
+
+/* Read LEN bytes of the target file FD at OFFSET into BUF.  Return the
+   number of bytes read, which is less than LEN only at the end of the
+   file, or -1 on error.  */
+
+static LONGEST
+read_target_file (int fd, gdb_byte *buf, ULONGEST len, ULONGEST offset)
+{
+  ULONGEST pos = 0;
+
+  while (pos < len)
+    {
+      QUIT;
+
+      fileio_error target_errno;
+      int bytes = target_fileio_pread (fd, buf + pos,
+				       std::min<ULONGEST> (len - pos, INT_MAX),
+				       offset + pos, &target_errno);
+      if (bytes == 0)
+	break;
+      if (bytes == -1)
+	return -1;
+
+      pos += bytes;
+    }
+
+  return pos;
+}
+
+/* Return the build ID of an ELF file whose first bytes are HEAD, in
+   hex, or an empty string if HEAD is not the start of an ELF file or
+   the build ID is not in it.  */
+
+static std::string
+build_id_from_elf_head (gdb::array_view<const gdb_byte> head)
+{
+  if (head.size () < sizeof (Elf32_External_Ehdr)
+      || head[EI_MAG0] != ELFMAG0
+      || head[EI_MAG1] != ELFMAG1
+      || head[EI_MAG2] != ELFMAG2
+      || head[EI_MAG3] != ELFMAG3)
+    return {};
+
+  bool is_64;
+  if (head[EI_CLASS] == ELFCLASS64)
+    is_64 = true;
+  else if (head[EI_CLASS] == ELFCLASS32)
+    is_64 = false;
+  else
+    return {};
+
+  bfd_endian byte_order;
+  if (head[EI_DATA] == ELFDATA2LSB)
+    byte_order = BFD_ENDIAN_LITTLE;
+  else if (head[EI_DATA] == ELFDATA2MSB)
+    byte_order = BFD_ENDIAN_BIG;
+  else
+    return {};
+
+  /* Read the LEN bytes integer at OFFSET in HEAD into *VALUE, if it is
+     in HEAD.  */
+  auto get = [&] (ULONGEST offset, int len, ULONGEST *value)
+    {
+      if (offset > head.size () || head.size () - offset < len)
+	return false;
+      *value = extract_unsigned_integer (head.data () + offset, len,
+					 byte_order);
+      return true;
+    };
+
+  const int addr_size = is_64 ? 8 : 4;
+  ULONGEST phoff, phentsize, phnum;
+  if (!get (is_64 ? 32 : 28, addr_size, &phoff)
+      || !get (is_64 ? 54 : 42, 2, &phentsize)
+      || !get (is_64 ? 56 : 44, 2, &phnum))
+    return {};
+
+  for (ULONGEST i = 0; i < phnum; ++i)
+    {
+      ULONGEST phdr = phoff + i * phentsize;
+      ULONGEST type, offset, size;
+
+      if (!get (phdr, 4, &type)
+	  || !get (phdr + (is_64 ? 8 : 4), addr_size, &offset)
+	  || !get (phdr + (is_64 ? 32 : 16), addr_size, &size))
+	return {};
+      if (type != PT_NOTE)
+	continue;
+
+      /* Walk the notes of this segment.  */
+      ULONGEST note = offset;
+      while (note + 12 <= offset + size)
+	{
+	  ULONGEST namesz, descsz, note_type;
+
+	  if (!get (note, 4, &namesz)
+	      || !get (note + 4, 4, &descsz)
+	      || !get (note + 8, 4, &note_type))
+	    break;
+
+	  ULONGEST name = note + 12;
+	  ULONGEST desc = name + align_up (namesz, 4);
+	  if (desc + descsz > head.size ())
+	    break;
+
+	  if (note_type == NT_GNU_BUILD_ID
+	      && namesz == 4
+	      && memcmp (head.data () + name, "GNU", 4) == 0
+	      && descsz > 0)
+	    return bin2hex (head.data () + desc, descsz);
+
+	  note = desc + align_up (descsz, 4);
+	}
+    }
+
+  return {};
+}
+
+/* Return the name of the cached copy of FILENAME, a target file of
+   SIZE bytes modified at MTIME and with build ID BUILD_ID, or an empty
+   string if the file can't be cached.  A file with a build ID is
+   cached under it, with its size, as a file and its separate debug
+   info file have the same build ID, and with its modification time,
+   as a file rebuilt without a change to its build ID may differ.  */
+
+static std::string
+cached_file_name (const char *filename, const std::string &build_id,
+		  ULONGEST size, LONGEST mtime)
+{
+  if (!build_id.empty ())
+    return string_printf ("%s/build-id/%s/%s-%s-%s",
+			  target_file_cache_directory.c_str (),
+			  build_id.substr (0, 2).c_str (),
+			  build_id.substr (2).c_str (), pulongest (size),
+			  plongest (mtime));
+
+  /* Otherwise keep the copy under the name of the file, which must not
+     lead out of the cache.  */
+  if (!IS_ABSOLUTE_PATH (filename) || strstr (filename, "/..") != nullptr)
+    return {};
+
+  return string_printf ("%s/files%s@%s-%s",
+			target_file_cache_directory.c_str (), filename,
+			pulongest (size), plongest (mtime));
+}
+
+/* Copy the SIZE bytes of FILENAME, a file the target opened as
+   TARGET_FD, to CACHED, and return a file descriptor open on the
+   copy.  Throw an error on failure.  */
+
+static scoped_fd
+fetch_target_file (int target_fd, const char *filename, ULONGEST size,
+		   const std::string &cached)
+{
+  std::string dir = ldirname (cached.c_str ());
+  if (!mkdir_recursive (dir.c_str ()))
+    error (_("could not make directory %s: %s"), dir.c_str (),
+	   safe_strerror (errno));
+
+  /* Copy to a temporary file, renamed once complete, so that a GDB
+     reading the cache at the same time never sees a partial copy.  */
+  std::string temp = cached + ".XXXXXX";
+  scoped_fd out = gdb_mkostemp_cloexec (&temp[0]);
+  if (out.get () == -1)
+    error (_("could not create %s: %s"), temp.c_str (),
+	   safe_strerror (errno));
+  gdb::unlinker unlink_temp (temp.c_str ());
+
+  gdb::byte_vector buf (std::min<ULONGEST> (size, FETCH_BLOCK_SIZE));
+  ULONGEST offset = 0;
+  while (offset < size)
+    {
+      ULONGEST todo = std::min<ULONGEST> (size - offset, buf.size ());
+      LONGEST bytes = read_target_file (target_fd, buf.data (), todo, offset);
+
+      if (bytes != todo)
+	error (_("could not read %s from the target"), filename);
+      if (write (out.get (), buf.data (), bytes) != bytes)
+	error (_("could not write %s: %s"), temp.c_str (),
+	       safe_strerror (errno));
+
+      offset += bytes;
+      target_file_cache_bytes_fetched += bytes;
+    }
+
+  if (rename (temp.c_str (), cached.c_str ()) != 0)
+    error (_("could not rename %s to %s: %s"), temp.c_str (),
+	   cached.c_str (), safe_strerror (errno));
+  unlink_temp.keep ();
+
+  target_file_cache_debug ("copied %s to %s", filename, cached.c_str ());
+  return out;
+}
+
+/* See target-file-cache.h.  */
+
+scoped_fd
+target_file_cache_open (int target_fd, const char *filename,
+			struct stat *st)
+{
+  if (!target_file_cache_enabled)
+    return scoped_fd ();
+
+  if (target_file_cache_directory.empty ())
+    {
+      warning (_("The target file cache directory name is empty, "
+		 "skipping cache lookup."));
+      return scoped_fd ();
+    }
+
+  fileio_error target_errno;
+  if (target_fileio_fstat (target_fd, st, &target_errno) != 0
+      || !S_ISREG (st->st_mode))
+    return scoped_fd ();
+
+  try
+    {
+      gdb::byte_vector head (std::min<ULONGEST> (st->st_size, HEAD_SIZE));
+      if (read_target_file (target_fd, head.data (), head.size (), 0)
+	  != head.size ())
+	return scoped_fd ();
+
+      std::string build_id = build_id_from_elf_head (head);
+      std::string cached = cached_file_name (filename, build_id,
+					     st->st_size, st->st_mtime);
+      if (cached.empty ())
+	{
+	  target_file_cache_debug ("can't cache %s", filename);
+	  return scoped_fd ();
+	}
+
+      struct stat cached_st;
+      if (stat (cached.c_str (), &cached_st) == 0
+	  && cached_st.st_size == st->st_size)
+	{
+	  scoped_fd fd = gdb_open_cloexec (cached, O_RDONLY | O_BINARY, 0);
+	  if (fd.get () != -1)
+	    {
+	      target_file_cache_debug ("using %s for %s", cached.c_str (),
+				       filename);
+	      ++target_file_cache_hits;
+	      return fd;
+	    }
+	}
+
+      ++target_file_cache_misses;
+      return fetch_target_file (target_fd, filename, st->st_size, cached);
+    }
+  catch (const gdb_exception_error &except)
+    {
+      target_file_cache_debug ("couldn't cache %s: %s", filename,
+			       except.what ());
+    }
+
+  return scoped_fd ();
+}
+
+/* set/show target-file-cache commands.  */
+static cmd_list_element *set_target_file_cache_prefix_list;
+static cmd_list_element *show_target_file_cache_prefix_list;
+
+/* "show target-file-cache enabled" show callback.  */
+
+static void
+show_target_file_cache_enabled (ui_file *stream, int from_tty,
+				cmd_list_element *cmd, const char *value)
+{
+  gdb_printf (stream, _("The target file cache is %s.\n"), value);
+}
+
+/* "set target-file-cache directory" handler.  */
+
+static void
+set_target_file_cache_directory (const char *arg, int from_tty,
+				 cmd_list_element *element)
+{
+  /* Make sure the directory is absolute and tilde-expanded.  */
+  target_file_cache_directory
+    = gdb_abspath (target_file_cache_directory.c_str ());
+}
+
+/* "show target-file-cache stats" handler.  */
+
+static void
+show_target_file_cache_stats (const char *arg, int from_tty)
+{
+  gdb_printf (_("  Cache hits (this session): %u\n"),
+	      target_file_cache_hits);
+  gdb_printf (_("Cache misses (this session): %u\n"),
+	      target_file_cache_misses);
+  gdb_printf (_("Bytes copied (this session): %s\n"),
+	      pulongest (target_file_cache_bytes_fetched));
+}
+
+void _initialize_target_file_cache ();
+void
+_initialize_target_file_cache ()
+{
+  /* Set the default cache directory.  */
+  std::string cache_dir = get_standard_cache_dir ();
+  if (!cache_dir.empty ())
+    target_file_cache_directory = cache_dir + SLASH_STRING + "target-files";
+
+  add_basic_prefix_cmd ("target-file-cache", class_files,
+			_("Set target file cache options."),
+			&set_target_file_cache_prefix_list,
+			false, &setlist);
+  add_show_prefix_cmd ("target-file-cache", class_files,
+		       _("Show target file cache options."),
+		       &show_target_file_cache_prefix_list,
+		       false, &showlist);
+
+  add_setshow_boolean_cmd ("enabled", class_files,
+			   &target_file_cache_enabled,
+			   _("Enable the target file cache."),
+			   _("Show whether the target file cache is enabled."),
+			   _("\
+When on, GDB keeps local copies of the files it reads from the target,\n\
+and uses them instead of reading the files again."),
+			   nullptr, show_target_file_cache_enabled,
+			   &set_target_file_cache_prefix_list,
+			   &show_target_file_cache_prefix_list);
+
+  add_setshow_filename_cmd ("directory", class_files,
+			    &target_file_cache_directory,
+			    _("Set the directory of the target file cache."),
+			    _("Show the directory of the target file cache."),
+			    nullptr,
+			    set_target_file_cache_directory, nullptr,
+			    &set_target_file_cache_prefix_list,
+			    &show_target_file_cache_prefix_list);
+
+  add_cmd ("stats", class_files, show_target_file_cache_stats,
+	   _("Show some stats about the target file cache."),
+	   &show_target_file_cache_prefix_list);
+
+  add_setshow_boolean_cmd ("target-file-cache", class_maintenance,
+			   &debug_target_file_cache,
+			   _("Set display of target file cache debug messages."),
+			   _("Show display of target file cache debug messages."),
+			   _("\
+When on, debugging output for the target file cache is displayed."),
+			   nullptr, nullptr,
+			   &setdebuglist, &showdebuglist);
+}
@@ -0,0 +1,41 @@
+/* Caching of files read from the target.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef TARGET_FILE_CACHE_H
+#define TARGET_FILE_CACHE_H
+
+#include "gdbsupport/scoped_fd.h"
+
+/* The target file cache keeps local copies of the files GDB reads from
+   the target with the target file I/O functions, for instance when the
+   sysroot is "target:".  A file is found in the cache by its build ID,
+   or else by its name, along with its size and modification time on
+   the target, so the copies survive from one session to the next.  */
+
+/* Return a file descriptor open on the local copy of FILENAME, a file
+   the target opened as TARGET_FD, and set *ST to the status of the
+   file on the target.  The file is copied from the target to the cache
+   first if needed.  Return an invalid file descriptor if the cache is
+   disabled, or if the file can't be cached; the caller should then
+   read the file from the target.  */
+
+extern scoped_fd target_file_cache_open (int target_fd, const char *filename,
+					 struct stat *st);
+
+#endif /* TARGET_FILE_CACHE_H */
@@ -187,6 +187,9 @@ enum target_object
   TARGET_OBJECT_SIGNAL_INFO,
   /* The list of threads that are being debugged.  */
   TARGET_OBJECT_THREADS,
+  /* The changes to the list of threads since the generation of the
+     list given as annex.  */
+  TARGET_OBJECT_THREADS_DELTA,
   /* Collected static trace data.  */
   TARGET_OBJECT_STATIC_TRACE_DATA,
   /* Traceframe info, in XML format.  */
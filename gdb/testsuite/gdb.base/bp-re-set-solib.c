@@ -0,0 +1,76 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <assert.h>
+#include <stddef.h>
+
+int
+common_func (int x)
+{
+  return x - 1;
+}
+
+int
+main_func (int x)
+{
+  return x + 2;
+}
+
+static void
+lib1_loaded (void)
+{
+}
+
+static void
+lib1_unloaded (void)
+{
+}
+
+static void
+lib2_loaded (void)
+{
+}
+
+int
+main (void)
+{
+  void *handle;
+  int (*func) (int);
+  int result = 0;
+
+  handle = dlopen (LIB1_PATH, RTLD_LAZY);
+  assert (handle != NULL);
+  func = (int (*) (int)) dlsym (handle, "lib1_func");
+  assert (func != NULL);
+  lib1_loaded ();
+  result += func (1);
+  dlclose (handle);
+  lib1_unloaded ();
+
+  handle = dlopen (LIB2_PATH, RTLD_LAZY);
+  assert (handle != NULL);
+  func = (int (*) (int)) dlsym (handle, "lib2_func");
+  assert (func != NULL);
+  lib2_loaded ();
+  result += func (2);
+  dlclose (handle);
+
+  result += common_func (3);
+  result += main_func (4);
+  return result == 0;
+}
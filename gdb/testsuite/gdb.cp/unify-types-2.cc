@@ -0,0 +1,33 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "unify-types.h"
+
+static int
+local_box ()
+{
+  struct L { int b; };
+  ns::box<L> lb = { { 8 }, 3 };
+
+  return lb.count - 3;		/* break in local_box */
+}
+
+int
+use_types (ns::box<int> *b, ns::point *p)
+{
+  return b->get () + p->x - 6 + local_box ();	/* break here */
+}
@@ -0,0 +1,40 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "unify-types.h"
+
+/* The other unit has a function of the same name, with another class
+   L of the same layout.  The two box<local_box()::L> are different
+   classes.  */
+
+static int
+local_box ()
+{
+  struct L { int a; };
+  ns::box<L> lb = { { 7 }, 2 };
+
+  return lb.count - 2;
+}
+
+int
+main ()
+{
+  ns::box<int> b = { 5, 1 };
+  ns::point p = { 1, 2, { 3 } };
+
+  return use_types (&b, &p) + local_box ();
+}
@@ -0,0 +1,34 @@
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+
+class ConditionalBreakpoint(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self):
+        super(ConditionalBreakpoint, self).__init__("conditional-breakpoint")
+
+    def warm_up(self):
+        self._run(1)
+
+    def _run(self, count):
+        for _ in range(0, count):
+            gdb.execute("continue", False, True)
+
+    def execute_test(self):
+        for compile in [0, 1]:
+            gdb.execute("monitor set compile-conditions %d" % compile, False, True)
+            func = lambda: self._run(4)
+            self.measure.measure(func, compile)
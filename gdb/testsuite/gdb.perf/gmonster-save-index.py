@@ -0,0 +1,80 @@
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Measure speed of writing a .gdb_index and a .debug_names index with
+# "save gdb-index", and the size of the files written.
+
+import os
+import shutil
+import tempfile
+
+from perftest import perftest
+from perftest import measure
+from perftest import testresult
+from perftest import utils
+
+
+class MeasurementOutputSize(measure.Measurement):
+    """Measurement of the total size of the files in a directory."""
+
+    def __init__(self, result, directory):
+        super(MeasurementOutputSize, self).__init__("output_size", result)
+        self.directory = directory
+
+    def start(self, id):
+        pass
+
+    def stop(self, id):
+        size = 0
+        for name in os.listdir(self.directory):
+            size += os.path.getsize(os.path.join(self.directory, name))
+        self.result.record(id, size)
+
+
+class GmonsterSaveIndex(perftest.TestCase):
+    def __init__(self, name, run_names, binfile):
+        self.directory = tempfile.mkdtemp()
+        result_factory = testresult.SingleStatisticResultFactory()
+        measurements = [
+            measure.MeasurementWallTime(result_factory.create_result()),
+            measure.MeasurementProcessTime(result_factory.create_result()),
+            MeasurementOutputSize(result_factory.create_result(), self.directory),
+        ]
+        super(GmonsterSaveIndex, self).__init__(name, measure.Measure(measurements))
+        self.run_names = run_names
+        self.binfile = binfile
+
+    def warm_up(self):
+        pass
+
+    def _clear_directory(self):
+        for name in os.listdir(self.directory):
+            os.remove(os.path.join(self.directory, name))
+
+    def _doit(self, option):
+        utils.safe_execute("save gdb-index %s%s" % (option, self.directory))
+
+    def execute_test(self):
+        for run in self.run_names:
+            this_run_binfile = "%s-%s" % (self.binfile, utils.convert_spaces(run))
+            utils.select_file(this_run_binfile)
+            for kind, option in [("gdb-index", ""), ("debug-names", "-dwarf-5 ")]:
+                iteration = 5
+                while iteration > 0:
+                    self._clear_directory()
+                    func = lambda: self._doit(option)
+                    self.measure.measure(func, "%s %s" % (run, kind))
+                    iteration -= 1
+        shutil.rmtree(self.directory)
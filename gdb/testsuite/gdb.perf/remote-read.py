@@ -0,0 +1,40 @@
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+
+class RemoteRead(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, size):
+        super(RemoteRead, self).__init__("remote-read")
+        self.size = size
+
+    def warm_up(self):
+        self._read()
+
+    def _read(self):
+        address = int(gdb.parse_and_eval("&buffer"))
+        gdb.selected_inferior().read_memory(address, self.size)
+
+    def _run(self, count):
+        for _ in range(0, count):
+            gdb.execute("maint flush dcache", False, True)
+            self._read()
+
+    def execute_test(self):
+        for window in [1, 2, 4, 8, 16, 32]:
+            gdb.execute("set remote memory-read-window %d" % window)
+            func = lambda: self._run(4)
+            self.measure.measure(func, window)
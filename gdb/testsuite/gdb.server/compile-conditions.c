@@ -0,0 +1,45 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#define N 100
+
+/* For each I, the value the condition of the test compares with.  It
+   matches for the even values of I only.  */
+int expected[N];
+int *expected_ptr = expected;
+
+volatile int counter;
+
+static void
+done (void)
+{
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < N; i++)
+    expected[i] = (i % 2 == 0) ? ((i * 3) << 2) >> 1 : -1;
+
+  for (i = 0; i < N; i++)
+    counter += i;		/* condition line */
+
+  done ();
+  return 0;
+}
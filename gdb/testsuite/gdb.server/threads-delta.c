@@ -0,0 +1,93 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <unistd.h>
+
+#define NUM_THREADS 3
+
+static pthread_t threads[NUM_THREADS];
+static volatile int done[NUM_THREADS];
+
+/* Set to ask a thread to rename itself, and cleared by the thread
+   once it has.  */
+static volatile int rename_thread = -1;
+
+static void
+renamed (void)
+{
+}
+
+static void *
+thread_func (void *arg)
+{
+  int i = (int) (long) arg;
+
+  while (!done[i])
+    {
+      if (rename_thread == i)
+	{
+	  /* GDBserver looks for new names of the threads that report
+	     a stop, so the thread stops after renaming itself.  */
+	  pthread_setname_np (pthread_self (), "renamed-thread");
+	  renamed ();
+	  rename_thread = -1;
+	}
+      usleep (1000);
+    }
+
+  return NULL;
+}
+
+static void
+created (void)
+{
+}
+
+static void
+exited (void)
+{
+}
+
+int
+main (void)
+{
+  int i;
+
+  alarm (60);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_create (&threads[i], NULL, thread_func, (void *) (long) i);
+  created ();
+
+  rename_thread = 1;
+  while (rename_thread != -1)
+    usleep (1000);
+
+  done[2] = 1;
+  pthread_join (threads[2], NULL);
+  exited ();
+
+  for (i = 0; i < NUM_THREADS - 1; i++)
+    {
+      done[i] = 1;
+      pthread_join (threads[i], NULL);
+    }
+
+  return 0;
+}
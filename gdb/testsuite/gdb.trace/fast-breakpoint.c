@@ -0,0 +1,78 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "trace-common.h"
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+int child_ok;
+
+/* Read by the conditions of the breakpoints.  */
+int64_t limit = 100;
+int64_t *bad_ptr;
+
+static void
+end (void)
+{
+}
+
+static void
+marker (int64_t arg)
+{
+  FAST_TRACEPOINT_LABEL(set_point);
+}
+
+static void
+loop (void)
+{
+  int64_t i;
+
+  for (i = 0; i < 10; ++i)
+    marker (i);
+}
+
+int
+main ()
+{
+  pid_t pid;
+  int status;
+
+  loop ();
+  end ();
+
+  loop ();
+  end ();
+
+  loop ();
+  end ();
+
+  pid = fork ();
+  if (pid == 0)
+    {
+      loop ();
+      _exit (0);
+    }
+
+  if (waitpid (pid, &status, 0) == pid)
+    child_ok = WIFEXITED (status) && WEXITSTATUS (status) == 0;
+
+  loop ();
+  end ();
+  return 0;
+}
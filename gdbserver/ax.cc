@@ -21,6 +21,9 @@
 #include "gdbsupport/format.h"
 #include "tracepoint.h"
 #include "gdbsupport/rsp-low.h"
+#ifndef USE_WIN32API
+#include <sys/mman.h>
+#endif
 
 static void ax_vdebug (const char *, ...) ATTRIBUTE_PRINTF (1, 2);
 
@@ -76,6 +79,22 @@ static const unsigned char gdb_agent_op_sizes [gdb_agent_op_last] =
     0
 #define DEFOP(NAME, SIZE, DATA_SIZE, CONSUMED, PRODUCED, VALUE)  , SIZE
 #include "gdbsupport/ax.def"
+#undef DEFOP
+  };
+
+static const unsigned char gdb_agent_op_consumed [gdb_agent_op_last] =
+  {
+    0
+#define DEFOP(NAME, SIZE, DATA_SIZE, CONSUMED, PRODUCED, VALUE)  , CONSUMED
+#include "gdbsupport/ax.def"
+#undef DEFOP
+  };
+
+static const unsigned char gdb_agent_op_produced [gdb_agent_op_last] =
+  {
+    0
+#define DEFOP(NAME, SIZE, DATA_SIZE, CONSUMED, PRODUCED, VALUE)  , PRODUCED
+#include "gdbsupport/ax.def"
 #undef DEFOP
   };
 #endif
@@ -137,6 +156,41 @@ gdb_unparse_agent_expr (struct agent_expr *aexpr)
   return rslt;
 }
 
+/* See ax.h.  */
+
+bool
+gdb_agent_expr_reads_memory (const struct agent_expr *aexpr)
+{
+  int pc = 0;
+
+  while (pc < aexpr->length)
+    {
+      unsigned char op = aexpr->bytes[pc];
+
+      switch (op)
+	{
+	case gdb_agent_op_ref8:
+	case gdb_agent_op_ref16:
+	case gdb_agent_op_ref32:
+	case gdb_agent_op_ref64:
+	case gdb_agent_op_trace:
+	case gdb_agent_op_trace_quick:
+	case gdb_agent_op_trace16:
+	case gdb_agent_op_tracenz:
+	case gdb_agent_op_printf:
+	  return true;
+	}
+
+      /* Be conservative about what we can't decode.  */
+      if (op == 0 || op >= gdb_agent_op_last)
+	return true;
+
+      pc += 1 + gdb_agent_op_sizes[op];
+    }
+
+  return false;
+}
+
 /* Bytecode compilation.  */
 
 CORE_ADDR current_insn_ptr;
@@ -153,172 +207,238 @@ static struct bytecode_address
   struct bytecode_address *next;
 } *bytecode_address_table;
 
+/* The bounds of the GDBserver memory gdb_compile_agent_expr is writing
+   code to.  Both are nullptr when code is compiled for the
+   inferior.  */
+static gdb_byte *host_code_start;
+static gdb_byte *host_code_end;
+
+/* Set if the code compiled for GDBserver didn't fit between
+   host_code_start and host_code_end.  */
+static bool host_code_overflow;
+
+/* Return true if the code being compiled is for GDBserver itself.  */
+
+static bool
+compiling_for_host (void)
+{
+  return host_code_start != nullptr;
+}
+
+/* Return the code generator in use: the target's, or the host's while
+   compiling code for GDBserver itself.  */
+
+static struct emit_ops *
+current_emit_ops (void)
+{
+  if (compiling_for_host ())
+    return target_host_emit_ops ();
+  return target_emit_ops ();
+}
+
+/* See ax.h.  */
+
+void
+write_compiled_code (CORE_ADDR to, const unsigned char *buf, size_t len)
+{
+  if (!compiling_for_host ())
+    {
+      target_write_memory (to, buf, len);
+      return;
+    }
+
+  uintptr_t start = (uintptr_t) host_code_start;
+  uintptr_t end = (uintptr_t) host_code_end;
+
+  if (to < start || to > end || len > end - to)
+    {
+      host_code_overflow = true;
+      return;
+    }
+
+  memcpy ((void *) (uintptr_t) to, buf, len);
+}
+
+/* Release the entries of bytecode_address_table.  */
+
+static void
+free_bytecode_address_table (void)
+{
+  while (bytecode_address_table != NULL)
+    {
+      struct bytecode_address *next = bytecode_address_table->next;
+
+      xfree (bytecode_address_table);
+      bytecode_address_table = next;
+    }
+}
+
 void
 emit_prologue (void)
 {
-  target_emit_ops ()->emit_prologue ();
+  current_emit_ops ()->emit_prologue ();
 }
 
 void
 emit_epilogue (void)
 {
-  target_emit_ops ()->emit_epilogue ();
+  current_emit_ops ()->emit_epilogue ();
 }
 
 static void
 emit_add (void)
 {
-  target_emit_ops ()->emit_add ();
+  current_emit_ops ()->emit_add ();
 }
 
 static void
 emit_sub (void)
 {
-  target_emit_ops ()->emit_sub ();
+  current_emit_ops ()->emit_sub ();
 }
 
 static void
 emit_mul (void)
 {
-  target_emit_ops ()->emit_mul ();
+  current_emit_ops ()->emit_mul ();
 }
 
 static void
 emit_lsh (void)
 {
-  target_emit_ops ()->emit_lsh ();
+  current_emit_ops ()->emit_lsh ();
 }
 
 static void
 emit_rsh_signed (void)
 {
-  target_emit_ops ()->emit_rsh_signed ();
+  current_emit_ops ()->emit_rsh_signed ();
 }
 
 static void
 emit_rsh_unsigned (void)
 {
-  target_emit_ops ()->emit_rsh_unsigned ();
+  current_emit_ops ()->emit_rsh_unsigned ();
 }
 
 static void
 emit_ext (int arg)
 {
-  target_emit_ops ()->emit_ext (arg);
+  current_emit_ops ()->emit_ext (arg);
 }
 
 static void
 emit_log_not (void)
 {
-  target_emit_ops ()->emit_log_not ();
+  current_emit_ops ()->emit_log_not ();
 }
 
 static void
 emit_bit_and (void)
 {
-  target_emit_ops ()->emit_bit_and ();
+  current_emit_ops ()->emit_bit_and ();
 }
 
 static void
 emit_bit_or (void)
 {
-  target_emit_ops ()->emit_bit_or ();
+  current_emit_ops ()->emit_bit_or ();
 }
 
 static void
 emit_bit_xor (void)
 {
-  target_emit_ops ()->emit_bit_xor ();
+  current_emit_ops ()->emit_bit_xor ();
 }
 
 static void
 emit_bit_not (void)
 {
-  target_emit_ops ()->emit_bit_not ();
+  current_emit_ops ()->emit_bit_not ();
 }
 
 static void
 emit_equal (void)
 {
-  target_emit_ops ()->emit_equal ();
+  current_emit_ops ()->emit_equal ();
 }
 
 static void
 emit_less_signed (void)
 {
-  target_emit_ops ()->emit_less_signed ();
+  current_emit_ops ()->emit_less_signed ();
 }
 
 static void
 emit_less_unsigned (void)
 {
-  target_emit_ops ()->emit_less_unsigned ();
+  current_emit_ops ()->emit_less_unsigned ();
 }
 
 static void
 emit_ref (int size)
 {
-  target_emit_ops ()->emit_ref (size);
+  current_emit_ops ()->emit_ref (size);
 }
 
 static void
 emit_if_goto (int *offset_p, int *size_p)
 {
-  target_emit_ops ()->emit_if_goto (offset_p, size_p);
+  current_emit_ops ()->emit_if_goto (offset_p, size_p);
 }
 
 static void
 emit_goto (int *offset_p, int *size_p)
 {
-  target_emit_ops ()->emit_goto (offset_p, size_p);
+  current_emit_ops ()->emit_goto (offset_p, size_p);
 }
 
 static void
 write_goto_address (CORE_ADDR from, CORE_ADDR to, int size)
 {
-  target_emit_ops ()->write_goto_address (from, to, size);
+  current_emit_ops ()->write_goto_address (from, to, size);
 }
 
 static void
 emit_const (LONGEST num)
 {
-  target_emit_ops ()->emit_const (num);
+  current_emit_ops ()->emit_const (num);
 }
 
 static void
 emit_reg (int reg)
 {
-  target_emit_ops ()->emit_reg (reg);
+  current_emit_ops ()->emit_reg (reg);
 }
 
 static void
 emit_pop (void)
 {
-  target_emit_ops ()->emit_pop ();
+  current_emit_ops ()->emit_pop ();
 }
 
 static void
 emit_stack_flush (void)
 {
-  target_emit_ops ()->emit_stack_flush ();
+  current_emit_ops ()->emit_stack_flush ();
 }
 
 static void
 emit_zero_ext (int arg)
 {
-  target_emit_ops ()->emit_zero_ext (arg);
+  current_emit_ops ()->emit_zero_ext (arg);
 }
 
 static void
 emit_swap (void)
 {
-  target_emit_ops ()->emit_swap ();
+  current_emit_ops ()->emit_swap ();
 }
 
 static void
 emit_stack_adjust (int n)
 {
-  target_emit_ops ()->emit_stack_adjust (n);
+  current_emit_ops ()->emit_stack_adjust (n);
 }
 
 /* FN's prototype is `LONGEST(*fn)(int)'.  */
@@ -326,7 +446,7 @@ emit_stack_adjust (int n)
 static void
 emit_int_call_1 (CORE_ADDR fn, int arg1)
 {
-  target_emit_ops ()->emit_int_call_1 (fn, arg1);
+  current_emit_ops ()->emit_int_call_1 (fn, arg1);
 }
 
 /* FN's prototype is `void(*fn)(int,LONGEST)'.  */
@@ -334,43 +454,43 @@ emit_int_call_1 (CORE_ADDR fn, int arg1)
 static void
 emit_void_call_2 (CORE_ADDR fn, int arg1)
 {
-  target_emit_ops ()->emit_void_call_2 (fn, arg1);
+  current_emit_ops ()->emit_void_call_2 (fn, arg1);
 }
 
 static void
 emit_eq_goto (int *offset_p, int *size_p)
 {
-  target_emit_ops ()->emit_eq_goto (offset_p, size_p);
+  current_emit_ops ()->emit_eq_goto (offset_p, size_p);
 }
 
 static void
 emit_ne_goto (int *offset_p, int *size_p)
 {
-  target_emit_ops ()->emit_ne_goto (offset_p, size_p);
+  current_emit_ops ()->emit_ne_goto (offset_p, size_p);
 }
 
 static void
 emit_lt_goto (int *offset_p, int *size_p)
 {
-  target_emit_ops ()->emit_lt_goto (offset_p, size_p);
+  current_emit_ops ()->emit_lt_goto (offset_p, size_p);
 }
 
 static void
 emit_ge_goto (int *offset_p, int *size_p)
 {
-  target_emit_ops ()->emit_ge_goto (offset_p, size_p);
+  current_emit_ops ()->emit_ge_goto (offset_p, size_p);
 }
 
 static void
 emit_gt_goto (int *offset_p, int *size_p)
 {
-  target_emit_ops ()->emit_gt_goto (offset_p, size_p);
+  current_emit_ops ()->emit_gt_goto (offset_p, size_p);
 }
 
 static void
 emit_le_goto (int *offset_p, int *size_p)
 {
-  target_emit_ops ()->emit_le_goto (offset_p, size_p);
+  current_emit_ops ()->emit_le_goto (offset_p, size_p);
 }
 
 /* Scan an agent expression for any evidence that the given PC is the
@@ -397,6 +517,281 @@ is_goto_target (struct agent_expr *aexpr, int pc)
   return 0;
 }
 
+/* Compilation for GDBserver itself.
+
+   The code gdb_compile_agent_expr generates runs in GDBserver, so it
+   can't get at the inferior's registers and memory directly, and
+   calls back into GDBserver through the target's emit_int_call_1 and
+   emit_void_call_2 methods for the bytecodes that need them.  The
+   functions below are the targets of those calls.  They are only
+   used while a single expression runs, and get its context from
+   these variables.  */
+
+/* The context of the compiled expression being run.  */
+static struct eval_agent_expr_context *host_eval_ctx;
+
+/* The result of the compiled expression being run, so far.  Once it
+   is an error, the functions below no longer have any effect.  */
+static enum eval_result_type host_eval_result;
+
+/* The address of the memory host_ref reads.  */
+static CORE_ADDR host_ref_addr;
+
+/* The function, channel and arguments of a printf bytecode, in the
+   order they are popped off the stack.  */
+static ULONGEST host_printf_args[2 + UCHAR_MAX];
+
+static void ax_printf (CORE_ADDR fn, CORE_ADDR chan, const char *format,
+		       int nargs, ULONGEST *args);
+
+/* Return the address of FN, a function the compiled code calls.  */
+
+#define HOST_FUNCTION_ADDR(FN) ((CORE_ADDR) (uintptr_t) (FN))
+
+/* Return the value of register REGNUM.  */
+
+static LONGEST
+host_get_reg (int regnum)
+{
+  struct regcache *regcache = host_eval_ctx->regcache;
+
+  switch (register_size (regcache->tdesc, regnum))
+    {
+    case 8:
+      {
+	uint64_t val;
+
+	collect_register (regcache, regnum, &val);
+	return val;
+      }
+    case 4:
+      {
+	uint32_t val;
+
+	collect_register (regcache, regnum, &val);
+	return val;
+      }
+    case 2:
+      {
+	uint16_t val;
+
+	collect_register (regcache, regnum, &val);
+	return val;
+      }
+    case 1:
+      {
+	uint8_t val;
+
+	collect_register (regcache, regnum, &val);
+	return val;
+      }
+    default:
+      internal_error ("unhandled register size");
+    }
+}
+
+/* Set the address of the memory the next host_ref reads to ADDR.  */
+
+static void
+host_set_ref_addr (int unused, LONGEST addr)
+{
+  host_ref_addr = addr;
+}
+
+/* Return the SIZE bytes of memory at host_ref_addr.  */
+
+static LONGEST
+host_ref (int size)
+{
+  gdb_byte buf[8];
+
+  if (host_eval_result != expr_eval_no_error)
+    return 0;
+
+  if (agent_mem_read (host_eval_ctx, buf, host_ref_addr, size) != 0)
+    {
+      host_eval_result = expr_eval_invalid_memory_access;
+      return 0;
+    }
+
+  switch (size)
+    {
+    case 1:
+      return buf[0];
+    case 2:
+      {
+	uint16_t val;
+
+	memcpy (&val, buf, sizeof (val));
+	return val;
+      }
+    case 4:
+      {
+	uint32_t val;
+
+	memcpy (&val, buf, sizeof (val));
+	return val;
+      }
+    default:
+      {
+	uint64_t val;
+
+	memcpy (&val, buf, sizeof (val));
+	return val;
+      }
+    }
+}
+
+/* Set trace state variable NUM to VAL.  */
+
+static void
+host_setv (int num, LONGEST val)
+{
+  if (host_eval_result == expr_eval_no_error)
+    agent_set_trace_state_variable_value (num, val);
+}
+
+/* Save VAL as the I'th value popped by a printf bytecode.  */
+
+static void
+host_printf_arg (int i, LONGEST val)
+{
+  host_printf_args[i] = val;
+}
+
+/* Print the NARGS arguments saved by host_printf_arg with the format
+   string at FORMAT.  */
+
+static void
+host_printf (int nargs, LONGEST format)
+{
+  if (host_eval_result != expr_eval_no_error)
+    return;
+
+  /* An exception can't unwind through the compiled code.  */
+  try
+    {
+      ax_printf (host_printf_args[0], host_printf_args[1],
+		 (const char *) (uintptr_t) format, nargs,
+		 host_printf_args + 2);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      ax_debug ("Printf failed: %s", ex.what ());
+      host_eval_result = expr_eval_unhandled_opcode;
+    }
+}
+
+/* Return true if ax_printf can print NARGS arguments with FORMAT.  */
+
+static bool
+host_printf_format_ok (const char *format, int nargs)
+{
+  int nargs_wanted = 0;
+
+  try
+    {
+      format_pieces fpieces (&format);
+
+      for (auto &&piece : fpieces)
+	switch (piece.argclass)
+	  {
+	  case literal_piece:
+	    break;
+	  case string_arg:
+#if defined (PRINTF_HAS_LONG_LONG)
+	  case long_long_arg:
+#endif
+	  case int_arg:
+	  case long_arg:
+	  case size_t_arg:
+	    ++nargs_wanted;
+	    break;
+	  default:
+	    return false;
+	  }
+    }
+  catch (const gdb_exception_error &)
+    {
+      return false;
+    }
+
+  return nargs == nargs_wanted;
+}
+
+/* Emit code to push the value of register REG.  */
+
+static void
+emit_register (int reg)
+{
+  if (compiling_for_host ())
+    emit_int_call_1 (HOST_FUNCTION_ADDR (host_get_reg), reg);
+  else
+    emit_reg (reg);
+}
+
+/* Emit code to replace the top of the stack with the SIZE bytes of
+   memory it points to.  */
+
+static void
+emit_memory_ref (int size)
+{
+  if (compiling_for_host ())
+    {
+      emit_void_call_2 (HOST_FUNCTION_ADDR (host_set_ref_addr), 0);
+      emit_int_call_1 (HOST_FUNCTION_ADDR (host_ref), size);
+    }
+  else
+    emit_ref (size);
+}
+
+/* Emit code for a printf bytecode with NARGS arguments, and the format
+   string at FORMAT, SLEN bytes long.  Return false if the bytecode
+   can't be compiled.  */
+
+static bool
+emit_printf (const char *format, int slen, int nargs)
+{
+  if (slen == 0 || format[slen - 1] != '\0'
+      || !host_printf_format_ok (format, nargs))
+    return false;
+
+  /* Pop the function, the channel and the arguments.  */
+  for (int i = 0; i < nargs + 2; i++)
+    {
+      emit_void_call_2 (HOST_FUNCTION_ADDR (host_printf_arg), i);
+      emit_pop ();
+    }
+
+  /* Pass the format string as the top of the stack.  */
+  emit_stack_flush ();
+  emit_const ((LONGEST) (uintptr_t) format);
+  emit_void_call_2 (HOST_FUNCTION_ADDR (host_printf), nargs);
+  emit_pop ();
+  return true;
+}
+
+/* Return the address of the function the compiled code calls to get
+   a trace state variable.  */
+
+static CORE_ADDR
+get_tsv_func_addr (void)
+{
+  if (compiling_for_host ())
+    return HOST_FUNCTION_ADDR (agent_get_trace_state_variable_value);
+  return get_get_tsv_func_addr ();
+}
+
+/* Likewise, to set a trace state variable.  */
+
+static CORE_ADDR
+set_tsv_func_addr (void)
+{
+  if (compiling_for_host ())
+    return HOST_FUNCTION_ADDR (host_setv);
+  return get_set_tsv_func_addr ();
+}
+
 /* Given an agent expression, turn it into native code.  */
 
 enum eval_result_type
@@ -423,7 +818,7 @@ compile_bytecodes (struct agent_expr *aexpr)
       return expr_eval_empty_expression;
     }
 
-  bytecode_address_table = NULL;
+  free_bytecode_address_table ();
 
   while (!done)
     {
@@ -519,7 +914,7 @@ compile_bytecodes (struct agent_expr *aexpr)
 	  next_op = aexpr->bytes[pc];
 	  if (next_op == gdb_agent_op_if_goto
 	      && !is_goto_target (aexpr, pc)
-	      && target_emit_ops ()->emit_eq_goto)
+	      && current_emit_ops ()->emit_eq_goto)
 	    {
 	      ax_debug ("Combining equal & if_goto");
 	      pc += 1;
@@ -532,7 +927,7 @@ compile_bytecodes (struct agent_expr *aexpr)
 	  else if (next_op == gdb_agent_op_log_not
 		   && (aexpr->bytes[pc + 1] == gdb_agent_op_if_goto)
 		   && !is_goto_target (aexpr, pc + 1)
-		   && target_emit_ops ()->emit_ne_goto)
+		   && current_emit_ops ()->emit_ne_goto)
 	    {
 	      ax_debug ("Combining equal & log_not & if_goto");
 	      pc += 2;
@@ -587,19 +982,19 @@ compile_bytecodes (struct agent_expr *aexpr)
 	  break;
 
 	case gdb_agent_op_ref8:
-	  emit_ref (1);
+	  emit_memory_ref (1);
 	  break;
 
 	case gdb_agent_op_ref16:
-	  emit_ref (2);
+	  emit_memory_ref (2);
 	  break;
 
 	case gdb_agent_op_ref32:
-	  emit_ref (4);
+	  emit_memory_ref (4);
 	  break;
 
 	case gdb_agent_op_ref64:
-	  emit_ref (8);
+	  emit_memory_ref (8);
 	  break;
 
 	case gdb_agent_op_if_goto:
@@ -655,7 +1050,7 @@ compile_bytecodes (struct agent_expr *aexpr)
 	  emit_stack_flush ();
 	  arg = aexpr->bytes[pc++];
 	  arg = (arg << 8) + aexpr->bytes[pc++];
-	  emit_reg (arg);
+	  emit_register (arg);
 	  break;
 
 	case gdb_agent_op_end:
@@ -722,21 +1117,36 @@ compile_bytecodes (struct agent_expr *aexpr)
 	  emit_stack_flush ();
 	  arg = aexpr->bytes[pc++];
 	  arg = (arg << 8) + aexpr->bytes[pc++];
-	  emit_int_call_1 (get_get_tsv_func_addr (),
-			   arg);
+	  emit_int_call_1 (get_tsv_func_addr (), arg);
 	  break;
 
 	case gdb_agent_op_setv:
 	  arg = aexpr->bytes[pc++];
 	  arg = (arg << 8) + aexpr->bytes[pc++];
-	  emit_void_call_2 (get_set_tsv_func_addr (),
-			    arg);
+	  emit_void_call_2 (set_tsv_func_addr (), arg);
 	  break;
 
 	case gdb_agent_op_tracev:
 	  UNHANDLED;
 	  break;
 
+	case gdb_agent_op_printf:
+	  {
+	    int nargs, slen;
+
+	    /* Only GDBserver itself can print.  */
+	    if (!compiling_for_host ())
+	      UNHANDLED;
+
+	    nargs = aexpr->bytes[pc++];
+	    slen = aexpr->bytes[pc++];
+	    slen = (slen << 8) + aexpr->bytes[pc++];
+	    if (!emit_printf ((const char *) &aexpr->bytes[pc], slen, nargs))
+	      UNHANDLED;
+	    pc += slen;
+	  }
+	  break;
+
 	  /* GDB never (currently) generates any of these ops.  */
 	case gdb_agent_op_float:
 	case gdb_agent_op_ref_float:
@@ -803,6 +1213,194 @@ compile_bytecodes (struct agent_expr *aexpr)
   return expr_eval_no_error;
 }
 
+/* Return true if running AEXPR never pops more values than it pushed.
+   Unlike the interpreter, the compiled code doesn't check its stack,
+   which for code run by GDBserver is GDBserver's own.  Set *EMPTY to
+   whether the stack is empty at the end of AEXPR, which is an error
+   for the interpreter; return false if that depends on the path
+   taken.  */
+
+static bool
+check_stack_use (struct agent_expr *aexpr, bool *empty)
+{
+  int ends = 0;
+
+  /* The depth of the stack at each bytecode, or -1 if unknown.  */
+  std::vector<int> depths (aexpr->length, -1);
+  bool reachable = true;
+  int depth = 0;
+  int pc = 0;
+
+  while (pc < aexpr->length)
+    {
+      unsigned char op = aexpr->bytes[pc];
+      int consumed, produced, size;
+
+      /* Code only reached by jumps gets the depth of the jumps.  */
+      if (depths[pc] >= 0)
+	{
+	  if (reachable && depths[pc] != depth)
+	    return false;
+	  depth = depths[pc];
+	}
+      else if (!reachable)
+	return false;
+      depths[pc] = depth;
+      reachable = true;
+
+      if (op == 0 || op >= gdb_agent_op_last)
+	return false;
+
+      if (op == gdb_agent_op_printf)
+	{
+	  if (pc + 4 > aexpr->length)
+	    return false;
+	  consumed = aexpr->bytes[pc + 1] + 2;
+	  produced = 0;
+	  size = 4 + (aexpr->bytes[pc + 2] << 8) + aexpr->bytes[pc + 3];
+	}
+      else
+	{
+	  consumed = gdb_agent_op_consumed[op];
+	  produced = gdb_agent_op_produced[op];
+	  size = 1 + gdb_agent_op_sizes[op];
+	}
+
+      if (pc + size > aexpr->length || depth < consumed)
+	return false;
+      depth += produced - consumed;
+
+      if (op == gdb_agent_op_goto || op == gdb_agent_op_if_goto)
+	{
+	  int target = (aexpr->bytes[pc + 1] << 8) + aexpr->bytes[pc + 2];
+
+	  if (target >= aexpr->length
+	      || (depths[target] >= 0 && depths[target] != depth)
+	      || (target <= pc && depths[target] < 0))
+	    return false;
+	  depths[target] = depth;
+	}
+
+      if (op == gdb_agent_op_end)
+	{
+	  if (ends++ > 0 && *empty != (depth == 0))
+	    return false;
+	  *empty = depth == 0;
+	}
+      if (op == gdb_agent_op_goto || op == gdb_agent_op_end)
+	reachable = false;
+
+      pc += size;
+    }
+
+  return !reachable;
+}
+
+struct compiled_agent_expr
+{
+  /* The memory mapped for the code.  */
+  void *code;
+
+  /* The size of the mapping.  */
+  size_t size;
+
+  /* Whether the stack is empty at the end of the expression.  */
+  bool empty;
+};
+
+/* The most memory gdb_compile_agent_expr maps for one expression.  */
+
+#define MAX_COMPILED_AGENT_EXPR_SIZE (1024 * 1024)
+
+/* See ax.h.  */
+
+struct compiled_agent_expr *
+gdb_compile_agent_expr (struct agent_expr *aexpr)
+{
+#ifdef USE_WIN32API
+  return nullptr;
+#else
+  bool empty = false;
+
+  if (target_host_emit_ops () == nullptr
+      || aexpr->length == 0
+      || !check_stack_use (aexpr, &empty))
+    return nullptr;
+
+  /* The code for a breakpoint condition usually fits in a page, but
+     try again with more room if it doesn't.  */
+  for (size_t size = 4096; size <= MAX_COMPILED_AGENT_EXPR_SIZE; size *= 2)
+    {
+      void *code = mmap (nullptr, size, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (code == MAP_FAILED)
+	return nullptr;
+
+      CORE_ADDR saved_insn_ptr = current_insn_ptr;
+      host_code_start = (gdb_byte *) code;
+      host_code_end = host_code_start + size;
+      host_code_overflow = false;
+      current_insn_ptr = (CORE_ADDR) (uintptr_t) code;
+
+      emit_prologue ();
+      /* Flush the undefined stack top, so that popping the last value
+	 of the expression, as the end bytecode does even if the stack
+	 is empty, stays within the frame.  */
+      emit_stack_flush ();
+      enum eval_result_type res = compile_bytecodes (aexpr);
+      if (res == expr_eval_no_error)
+	emit_epilogue ();
+
+      bool overflow = host_code_overflow;
+      size_t used = current_insn_ptr - (uintptr_t) code;
+      host_code_start = host_code_end = nullptr;
+      current_insn_ptr = saved_insn_ptr;
+
+      if (res == expr_eval_no_error && !overflow
+	  && mprotect (code, size, PROT_READ | PROT_EXEC) == 0)
+	{
+	  __builtin___clear_cache ((char *) code, (char *) code + used);
+	  ax_debug ("Compiled agent expression to %zu bytes at %p",
+		    used, code);
+
+	  struct compiled_agent_expr *compiled
+	    = XNEW (struct compiled_agent_expr);
+	  compiled->code = code;
+	  compiled->size = size;
+	  compiled->empty = empty;
+	  return compiled;
+	}
+
+      munmap (code, size);
+      if (!overflow)
+	{
+	  if (res == expr_eval_no_error)
+	    ax_debug ("Cannot make compiled code executable: %s",
+		      safe_strerror (errno));
+	  else
+	    ax_debug ("Cannot compile agent expression, error %d", res);
+	  return nullptr;
+	}
+    }
+
+  return nullptr;
+#endif
+}
+
+/* See ax.h.  */
+
+void
+gdb_free_compiled_agent_expr (struct compiled_agent_expr *code)
+{
+  if (code == nullptr)
+    return;
+
+#ifndef USE_WIN32API
+  munmap (code->code, code->size);
+#endif
+  xfree (code);
+}
+
 #endif
 
 /* Make printf-type calls using arguments supplied from the host.  We
@@ -1374,3 +1972,37 @@ gdb_eval_agent_expr (struct eval_agent_expr_context *ctx,
 		gdb_agent_op_name (op), sp, phex_nz (top, 0));
     }
 }
+
+#ifndef IN_PROCESS_AGENT
+
+/* See ax.h.  */
+
+enum eval_result_type
+gdb_run_compiled_agent_expr (struct eval_agent_expr_context *ctx,
+			     struct compiled_agent_expr *code,
+			     ULONGEST *rslt)
+{
+  typedef enum eval_result_type (*compiled_fn) (unsigned char *, ULONGEST *);
+  compiled_fn fn = (compiled_fn) code->code;
+  ULONGEST value;
+
+  host_eval_ctx = ctx;
+  host_eval_result = expr_eval_no_error;
+
+  /* The compiled code gets the registers through host_get_reg rather
+     than from its first argument.  */
+  enum eval_result_type res = fn (nullptr, &value);
+
+  host_eval_ctx = nullptr;
+  if (res == expr_eval_no_error)
+    res = host_eval_result;
+  if (res == expr_eval_no_error && rslt != nullptr)
+    {
+      if (code->empty)
+	return expr_eval_empty_stack;
+      *rslt = value;
+    }
+  return res;
+}
+
+#endif
@@ -58,9 +58,34 @@ void gdb_free_agent_expr (struct agent_expr *aexpr);
    they can be printed or uploaded.  This allocates the buffer,
    callers should free when they are done with it.  */
 char *gdb_unparse_agent_expr (struct agent_expr *aexpr);
+
+/* Return true if AEXPR may read the inferior's memory, or if it can't
+   tell.  */
+bool gdb_agent_expr_reads_memory (const struct agent_expr *aexpr);
+
 void emit_prologue (void);
 void emit_epilogue (void);
 enum eval_result_type compile_bytecodes (struct agent_expr *aexpr);
+
+/* Write the LEN bytes of compiled code at BUF to TO, in the inferior's
+   memory, or in GDBserver's own if the code is being compiled by
+   gdb_compile_agent_expr.  */
+void write_compiled_code (CORE_ADDR to, const unsigned char *buf,
+			  size_t len);
+
+/* An agent expression compiled to native code that GDBserver runs
+   itself.  */
+struct compiled_agent_expr;
+
+/* Compile AEXPR into native code GDBserver can run in place of
+   interpreting it, using the target's host_emit_ops.  Return nullptr
+   if this GDBserver has no such compiler, or if AEXPR uses bytecodes
+   the compiler doesn't handle; the caller should then interpret the
+   expression with gdb_eval_agent_expr.  */
+struct compiled_agent_expr *gdb_compile_agent_expr (struct agent_expr *aexpr);
+
+/* Release the code returned by gdb_compile_agent_expr.  */
+void gdb_free_compiled_agent_expr (struct compiled_agent_expr *code);
 #endif
 
 /* The context when evaluating agent expression.  */
@@ -80,6 +105,17 @@ enum eval_result_type
 		       struct agent_expr *aexpr,
 		       ULONGEST *rslt);
 
+#ifndef IN_PROCESS_AGENT
+
+/* Run CODE, compiled by gdb_compile_agent_expr, in context CTX.  The
+   result is the same gdb_eval_agent_expr gives for the expression.  */
+
+enum eval_result_type
+  gdb_run_compiled_agent_expr (struct eval_agent_expr_context *ctx,
+			       struct compiled_agent_expr *code,
+			       ULONGEST *rslt);
+#endif
+
 /* Bytecode compilation function vector.  */
 
 struct emit_ops
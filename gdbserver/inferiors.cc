@@ -44,6 +44,7 @@ add_thread (ptid_t thread_id, void *target_data)
   thread_info *new_thread = new thread_info (thread_id, target_data);
 
   all_threads.push_back (new_thread);
+  note_thread_list_add (thread_id);
 
   if (current_thread == NULL)
     switch_to_thread (new_thread);
@@ -102,6 +103,7 @@ remove_thread (struct thread_info *thread)
     target_disable_btrace (thread->btrace);
 
   discard_queued_stop_replies (ptid_of (thread));
+  note_thread_list_exit (ptid_of (thread));
   all_threads.remove (thread);
   if (current_thread == thread)
     switch_to_thread (nullptr);
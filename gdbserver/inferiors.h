@@ -30,6 +30,7 @@ struct sym_cache;
 struct breakpoint;
 struct raw_breakpoint;
 struct fast_tracepoint_jump;
+struct fast_breakpoint;
 struct process_info_private;
 
 struct process_info
@@ -61,6 +62,10 @@ struct process_info
   /* The list of installed fast tracepoints.  */
   struct fast_tracepoint_jump *fast_tracepoint_jumps = NULL;
 
+  /* The list of fast breakpoints, GDB breakpoints whose condition the
+     in-process agent evaluates.  */
+  struct fast_breakpoint *fast_breakpoints = NULL;
+
   /* The list of syscalls to report, or just a single element, ANY_SYSCALL,
      for unfiltered syscall reporting.  */
   std::vector<int> syscalls_to_catch;
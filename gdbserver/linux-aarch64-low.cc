@@ -88,6 +88,8 @@ public:
 
   struct emit_ops *emit_ops () override;
 
+  struct emit_ops *host_emit_ops () override;
+
   bool supports_memory_tagging () override;
 
   bool fetch_memtags (CORE_ADDR address, size_t len,
@@ -2025,11 +2027,11 @@ append_insns (CORE_ADDR *to, size_t len, const uint32_t *buf)
   for (i = 0; i < len; i++)
     le_buf[i] = htole32 (buf[i]);
 
-  target_write_memory (*to, (const unsigned char *) le_buf, byte_len);
+  write_compiled_code (*to, (const unsigned char *) le_buf, byte_len);
 
   xfree (le_buf);
 #else
-  target_write_memory (*to, (const unsigned char *) buf, byte_len);
+  write_compiled_code (*to, (const unsigned char *) buf, byte_len);
 #endif
 
   *to += byte_len;
@@ -3387,6 +3389,14 @@ aarch64_target::emit_ops ()
   return &aarch64_emit_ops_impl;
 }
 
+/* Implementation of target ops method "host_emit_ops".  */
+
+emit_ops *
+aarch64_target::host_emit_ops ()
+{
+  return &aarch64_emit_ops_impl;
+}
+
 /* Implementation of target ops method
    "get_min_fast_tracepoint_insn_len".  */
 
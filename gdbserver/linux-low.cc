@@ -3158,6 +3158,32 @@ linux_process_target::wait_1 (ptid_t ptid, target_waitstatus *ourstatus,
 	 breakpoints.  */
       trace_event = handle_tracepoints (event_child);
 
+      /* The condition of a fast breakpoint was true.  Let the lwp
+	 finish the jump pad call, up to the relocated instruction,
+	 and then report it at the breakpoint.  */
+      if (supports_fast_tracepoints ()
+	  && fast_breakpoint_hit (event_child->stop_pc))
+	{
+	  struct fast_tpoint_collect_status status;
+
+	  event_child->collecting_fast_tracepoint
+	    = linux_fast_tracepoint_collecting (event_child, &status);
+
+	  if (event_child->collecting_fast_tracepoint
+	      == fast_tpoint_collect_result::before_insn)
+	    {
+	      threads_debug_printf ("LWP %ld hit fast breakpoint at 0x%s.",
+				    lwpid_of (current_thread),
+				    paddress (status.tpoint_addr));
+
+	      if (event_child->exit_jump_pad_bkpt == NULL)
+		event_child->exit_jump_pad_bkpt
+		  = set_breakpoint_at (status.adjusted_insn_addr, NULL);
+	      event_child->fast_breakpoint_stop = status.tpoint_addr;
+	      trace_event = 1;
+	    }
+	}
+
       if (bp_explains_trap)
 	threads_debug_printf ("Hit a gdbserver breakpoint.");
     }
@@ -3208,10 +3234,12 @@ linux_process_target::wait_1 (ptid_t ptid, target_waitstatus *ourstatus,
 	 lwpid_of (current_thread),
 	 (int) event_child->collecting_fast_tracepoint);
 
+      struct fast_tpoint_collect_status status;
+
       trace_event = 1;
 
       event_child->collecting_fast_tracepoint
-	= linux_fast_tracepoint_collecting (event_child, NULL);
+	= linux_fast_tracepoint_collecting (event_child, &status);
 
       if (event_child->collecting_fast_tracepoint
 	  != fast_tpoint_collect_result::before_insn)
@@ -3239,6 +3267,31 @@ linux_process_target::wait_1 (ptid_t ptid, target_waitstatus *ourstatus,
 
 	      gdb_assert (event_child->suspended >= 0);
 	    }
+
+	  /* Once at the relocated instruction, an lwp that hit a fast
+	     breakpoint goes back to the breakpoint address, as if it
+	     had hit a trap there.  */
+	  if (event_child->fast_breakpoint_stop != 0
+	      && (event_child->collecting_fast_tracepoint
+		  == fast_tpoint_collect_result::at_insn)
+	      && event_child->stop_pc == status.adjusted_insn_addr)
+	    {
+	      struct regcache *regcache
+		= get_thread_regcache (current_thread, 1);
+
+	      threads_debug_printf
+		("Moving LWP %ld back to fast breakpoint at 0x%s.",
+		 lwpid_of (current_thread),
+		 paddress (event_child->fast_breakpoint_stop));
+
+	      low_set_pc (regcache, event_child->fast_breakpoint_stop);
+	      event_child->stop_pc = event_child->fast_breakpoint_stop;
+	      event_child->stop_reason = TARGET_STOPPED_BY_SW_BREAKPOINT;
+	      event_child->collecting_fast_tracepoint
+		= fast_tpoint_collect_result::not_collecting;
+	      trace_event = 0;
+	    }
+	  event_child->fast_breakpoint_stop = 0;
 	}
 
       if (event_child->collecting_fast_tracepoint
@@ -7053,8 +7106,13 @@ linux_process_target::thread_name (ptid_t thread)
       else if ((errno == EILSEQ || errno == EINVAL)
 	       && outbuf < &dest[sizeof (dest) - 2])
 	*outbuf++ = '?';
-      *outbuf = '\0';
     }
+  else if (outbuf == &dest[sizeof (dest)])
+    outbuf = &dest[sizeof (dest) - 1];
+
+  /* ICONV does not terminate the output, and DEST still holds the
+     previous name.  */
+  *outbuf = '\0';
 
   iconv_close (handle);
   return *dest == '\0' ? nullptr : dest;
@@ -899,6 +899,12 @@ struct lwp_info
      a exit-jump-pad-quickly breakpoint.  This is it.  */
   struct breakpoint *exit_jump_pad_bkpt = nullptr;
 
+  /* The address of the fast breakpoint whose condition this lwp found
+     true, while it moves to the relocated instruction in the jump pad.
+     The lwp is then moved back to this address, and reported as
+     having hit the breakpoint.  0 if none.  */
+  CORE_ADDR fast_breakpoint_stop = 0;
+
 #ifdef USE_THREAD_DB
   int thread_known = 0;
   /* The thread handle, used for e.g. TLS access.  Only valid if
@@ -125,6 +125,8 @@ public:
 
   struct emit_ops *emit_ops () override;
 
+  struct emit_ops *host_emit_ops () override;
+
   int get_ipa_tdesc_idx () override;
 
 protected:
@@ -1132,7 +1134,7 @@ x86_target::supports_tracepoints ()
 static void
 append_insns (CORE_ADDR *to, size_t len, const unsigned char *buf)
 {
-  target_write_memory (*to, buf, len);
+  write_compiled_code (*to, buf, len);
   *to += len;
 }
 
@@ -1185,10 +1187,19 @@ amd64_install_fast_tracepoint_jump_pad (CORE_ADDR tpoint, CORE_ADDR tpaddr,
 
   /* Build the jump pad.  */
 
-  /* First, do tracepoint data collection.  Save registers.  */
+  /* First, do tracepoint data collection.  Save registers, below the
+     red zone, where the code at the tracepoint may keep data.  The
+     saved %rsp is the original one, the last "pop %rsp" restores
+     it.  */
+  i = 0;
+  i += push_opcode (&buf[i], "48 8d 64 24 80");	/* lea -0x80(%rsp),%rsp */
+  buf[i++] = 0x50; /* push %rax */
+  i += push_opcode (&buf[i],
+		    "48 8d 84 24 88 00 00 00"); /* lea 0x88(%rsp),%rax */
+  i += push_opcode (&buf[i], "48 87 04 24");	/* xchg %rax,(%rsp) */
+  append_insns (&buildaddr, i, buf);
+
   i = 0;
-  /* Need to ensure stack pointer saved first.  */
-  buf[i++] = 0x54; /* push %rsp */
   buf[i++] = 0x55; /* push %rbp */
   buf[i++] = 0x57; /* push %rdi */
   buf[i++] = 0x56; /* push %rsi */
@@ -1721,25 +1732,36 @@ amd64_emit_sub (void)
 static void
 amd64_emit_mul (void)
 {
-  emit_error = 1;
+  EMIT_ASM (amd64_mul,
+	    "imul (%rsp),%rax\n\t"
+	    "lea 0x8(%rsp),%rsp");
 }
 
 static void
 amd64_emit_lsh (void)
 {
-  emit_error = 1;
+  EMIT_ASM (amd64_lsh,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "shl %cl,%rax");
 }
 
 static void
 amd64_emit_rsh_signed (void)
 {
-  emit_error = 1;
+  EMIT_ASM (amd64_rsh_signed,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "sar %cl,%rax");
 }
 
 static void
 amd64_emit_rsh_unsigned (void)
 {
-  emit_error = 1;
+  EMIT_ASM (amd64_rsh_unsigned,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "shr %cl,%rax");
 }
 
 static void
@@ -1911,7 +1933,7 @@ amd64_write_goto_address (CORE_ADDR from, CORE_ADDR to, int size)
     }
 
   memcpy (buf, &diff, sizeof (int));
-  target_write_memory (from, buf, sizeof (int));
+  write_compiled_code (from, buf, sizeof (int));
 }
 
 static void
@@ -1937,6 +1959,14 @@ amd64_emit_call (CORE_ADDR fn)
   CORE_ADDR buildaddr;
   LONGEST offset64;
 
+  /* The stack pointer is only 8-byte aligned, as values are pushed and
+     popped.  Align it as the ABI requires for the call, saving the
+     original one above the aligned stack.  */
+  EMIT_ASM (amd64_call_align,
+	    "push %rsp\n\t"
+	    "push (%rsp)\n\t"
+	    "and $-0x10,%rsp");
+
   /* The destination function being in the shared library, may be
      >31-bits away off the compiled code pad.  */
 
@@ -1969,6 +1999,9 @@ amd64_emit_call (CORE_ADDR fn)
 
   append_insns (&buildaddr, i, buf);
   current_insn_ptr = buildaddr;
+
+  EMIT_ASM (amd64_call_unalign,
+	    "mov 0x8(%rsp),%rsp");
 }
 
 static void
@@ -2529,7 +2562,7 @@ i386_write_goto_address (CORE_ADDR from, CORE_ADDR to, int size)
     }
 
   memcpy (buf, &diff, sizeof (int));
-  target_write_memory (from, buf, sizeof (int));
+  write_compiled_code (from, buf, sizeof (int));
 }
 
 static void
@@ -2942,6 +2975,18 @@ x86_target::emit_ops ()
     return &i386_emit_ops;
 }
 
+/* Implementation of target ops method "host_emit_ops".  */
+
+emit_ops *
+x86_target::host_emit_ops ()
+{
+#ifdef __x86_64__
+  return &amd64_emit_ops;
+#else
+  return nullptr;
+#endif
+}
+
 /* Implementation of target ops method "sw_breakpoint_from_kind".  */
 
 const gdb_byte *
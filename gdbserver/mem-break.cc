@@ -21,6 +21,7 @@
 #include "server.h"
 #include "regcache.h"
 #include "ax.h"
+#include "tracepoint.h"
 
 #define MAX_BREAKPOINT_LEN 8
 
@@ -113,6 +114,11 @@ struct raw_breakpoint
      inferior.  Negative if it was, but we've detected that it's now
      gone.  Zero if not inserted.  */
   int inserted;
+
+  /* True if the trap is left out of the inferior because the only
+     reference is a GDB breakpoint whose condition is evaluated by a
+     fast breakpoint instead.  See update_fast_breakpoint.  */
+  bool replaced_by_jump;
 };
 
 /* The type of a breakpoint.  */
@@ -147,6 +153,9 @@ struct point_cond_list
      conditional.  */
   struct agent_expr *cond;
 
+  /* COND compiled to native code, or NULL if it is interpreted.  */
+  struct compiled_agent_expr *compiled;
+
   /* Pointer to the next condition.  */
   struct point_cond_list *next;
 };
@@ -157,6 +166,9 @@ struct point_command_list
      commands.  */
   struct agent_expr *cmd;
 
+  /* CMD compiled to native code, or NULL if it is interpreted.  */
+  struct compiled_agent_expr *compiled;
+
   /* Flag that is true if this command should run even while GDB is
      disconnected.  */
   int persistence;
@@ -463,6 +475,7 @@ set_raw_breakpoint_at (enum raw_bkpt_type type, CORE_ADDR where, int kind,
 	}
 
       bp->inserted = 1;
+      bp->replaced_by_jump = false;
     }
 
   /* If the breakpoint was allocated above, we know we want to keep it
@@ -615,6 +628,23 @@ inc_ref_fast_tracepoint_jump (struct fast_tracepoint_jump *jp)
   jp->refcount++;
 }
 
+/* See mem-break.h.  */
+
+struct fast_tracepoint_jump *
+clone_fast_tracepoint_jump (struct process_info *child_proc,
+			    const struct fast_tracepoint_jump *jp)
+{
+  size_t size = sizeof (*jp) + jp->length * 2;
+  struct fast_tracepoint_jump *copy
+    = (struct fast_tracepoint_jump *) xmalloc (size);
+
+  memcpy (copy, jp, size);
+  copy->refcount = 1;
+  copy->next = child_proc->fast_tracepoint_jumps;
+  child_proc->fast_tracepoint_jumps = copy;
+  return copy;
+}
+
 struct fast_tracepoint_jump *
 set_fast_tracepoint_jump (CORE_ADDR where,
 			  unsigned char *insn, ULONGEST length)
@@ -913,6 +943,12 @@ release_breakpoint (struct process_info *proc, struct breakpoint *bp)
   int newrefcount;
   int ret;
 
+  if (bp->type == gdb_breakpoint_Z0)
+    {
+      delete_fast_breakpoint (proc, bp->raw->pc);
+      bp->raw->replaced_by_jump = false;
+    }
+
   newrefcount = bp->raw->refcount - 1;
   if (newrefcount == 0)
     {
@@ -1132,6 +1168,7 @@ clear_breakpoint_conditions (struct gdb_breakpoint *bp)
       struct point_cond_list *cond_next;
 
       cond_next = cond->next;
+      gdb_free_compiled_agent_expr (cond->compiled);
       gdb_free_agent_expr (cond->cond);
       free (cond);
       cond = cond_next;
@@ -1157,6 +1194,7 @@ clear_breakpoint_commands (struct gdb_breakpoint *bp)
       struct point_command_list *cmd_next;
 
       cmd_next = cmd->next;
+      gdb_free_compiled_agent_expr (cmd->compiled);
       gdb_free_agent_expr (cmd->cmd);
       free (cmd);
       cmd = cmd_next;
@@ -1172,6 +1210,37 @@ clear_breakpoint_conditions_and_commands (struct gdb_breakpoint *bp)
   clear_breakpoint_commands (bp);
 }
 
+/* See mem-break.h.  */
+
+bool compile_breakpoint_expressions = true;
+
+/* Compile AEXPR, a breakpoint condition or command, to native code if
+   possible.  Return NULL if it is to be interpreted.  */
+
+static struct compiled_agent_expr *
+compile_breakpoint_expression (struct agent_expr *aexpr)
+{
+  if (!compile_breakpoint_expressions)
+    return NULL;
+
+  return gdb_compile_agent_expr (aexpr);
+}
+
+/* Evaluate the breakpoint condition or command AEXPR in context CTX,
+   running COMPILED, the code it was compiled to, if not NULL.  */
+
+static enum eval_result_type
+eval_breakpoint_expression (struct eval_agent_expr_context *ctx,
+			    struct agent_expr *aexpr,
+			    struct compiled_agent_expr *compiled,
+			    ULONGEST *value)
+{
+  if (compiled != NULL)
+    return gdb_run_compiled_agent_expr (ctx, compiled, value);
+
+  return gdb_eval_agent_expr (ctx, aexpr, value);
+}
+
 /* Add condition CONDITION to GDBserver's breakpoint BP.  */
 
 static void
@@ -1183,6 +1252,7 @@ add_condition_to_breakpoint (struct gdb_breakpoint *bp,
   /* Create new condition.  */
   new_cond = XCNEW (struct point_cond_list);
   new_cond->cond = condition;
+  new_cond->compiled = compile_breakpoint_expression (condition);
 
   /* Add condition to the list.  */
   new_cond->next = bp->cond_list;
@@ -1252,7 +1322,8 @@ gdb_condition_true_at_breakpoint_z_type (char z_type, CORE_ADDR addr)
        cl && !value && !err; cl = cl->next)
     {
       /* Evaluate the condition.  */
-      err = gdb_eval_agent_expr (&ctx, cl->cond, &value);
+      err = eval_breakpoint_expression (&ctx, cl->cond, cl->compiled,
+					&value);
     }
 
   if (err)
@@ -1280,6 +1351,7 @@ add_commands_to_breakpoint (struct gdb_breakpoint *bp,
   /* Create new command.  */
   new_cmd = XCNEW (struct point_command_list);
   new_cmd->cmd = commands;
+  new_cmd->compiled = compile_breakpoint_expression (commands);
   new_cmd->persistence = persist;
 
   /* Add commands to the list.  */
@@ -1369,7 +1441,8 @@ run_breakpoint_commands_z_type (char z_type, CORE_ADDR addr)
        cl && !value && !err; cl = cl->next)
     {
       /* Run the command.  */
-      err = gdb_eval_agent_expr (&ctx, cl->cmd, &value);
+      err = eval_breakpoint_expression (&ctx, cl->cmd, cl->compiled,
+					&value);
 
       /* If one command has a problem, stop digging the hole deeper.  */
       if (err)
@@ -1536,7 +1609,7 @@ reinsert_raw_breakpoint (struct raw_breakpoint *bp)
 {
   int err;
 
-  if (bp->inserted)
+  if (bp->inserted || bp->replaced_by_jump)
     return;
 
   err = the_target->insert_point (bp->raw_type, bp->pc, bp->kind, bp);
@@ -1547,6 +1620,43 @@ reinsert_raw_breakpoint (struct raw_breakpoint *bp)
 			  paddress (bp->pc), err);
 }
 
+/* See mem-break.h.  */
+
+void
+update_fast_breakpoint (struct gdb_breakpoint *bp, int insn_len)
+{
+  struct raw_breakpoint *raw = bp->base.raw;
+
+  /* Only a trap that is GDB's alone, with a single condition to
+     evaluate and nothing else to do, can be replaced.  */
+  if (insn_len > 0
+      && bp->base.type == gdb_breakpoint_Z0
+      && bp->cond_list != NULL
+      && bp->cond_list->next == NULL
+      && bp->command_list == NULL
+      && raw->refcount == 1
+      && (raw->inserted > 0 || raw->replaced_by_jump)
+      && set_fast_breakpoint (raw->pc, insn_len, bp->cond_list->cond) == 0)
+    {
+      /* The jump is in place, the trap on top of it can go.  */
+      if (raw->inserted > 0)
+	{
+	  uninsert_raw_breakpoint (raw);
+	  raw->replaced_by_jump = (raw->inserted == 0);
+	}
+      return;
+    }
+
+  if (raw->replaced_by_jump)
+    {
+      /* Put the trap back before removing the jump, so that the
+	 breakpoint is never missing.  */
+      raw->replaced_by_jump = false;
+      reinsert_raw_breakpoint (raw);
+    }
+  delete_fast_breakpoint (current_process (), raw->pc);
+}
+
 void
 reinsert_breakpoints_at (CORE_ADDR pc)
 {
@@ -2018,7 +2128,10 @@ mark_breakpoints_out (struct process_info *proc)
   struct raw_breakpoint *raw_bp;
 
   for (raw_bp = proc->raw_breakpoints; raw_bp != NULL; raw_bp = raw_bp->next)
-    raw_bp->inserted = 0;
+    {
+      raw_bp->inserted = 0;
+      raw_bp->replaced_by_jump = false;
+    }
 }
 
 /* Release all breakpoints, but do not try to un-insert them from the
@@ -2028,6 +2141,7 @@ void
 free_all_breakpoints (struct process_info *proc)
 {
   mark_breakpoints_out (proc);
+  free_fast_breakpoints (proc);
 
   /* Note: use PROC explicitly instead of deferring to
      delete_all_breakpoints --- CURRENT_INFERIOR may already have been
@@ -2067,6 +2181,7 @@ clone_one_breakpoint (const struct breakpoint *src, ptid_t ptid)
   dest_raw->kind = src->raw->kind;
   memcpy (dest_raw->old_data, src->raw->old_data, MAX_BREAKPOINT_LEN);
   dest_raw->inserted = src->raw->inserted;
+  dest_raw->replaced_by_jump = src->raw->replaced_by_jump;
 
   /* Clone the high-level breakpoint.  */
   if (is_gdb_breakpoint (src->type))
@@ -2086,6 +2201,9 @@ clone_one_breakpoint (const struct breakpoint *src, ptid_t ptid)
 	{
 	  new_cond = XCNEW (struct point_cond_list);
 	  new_cond->cond = clone_agent_expr (current_cond->cond);
+	  if (current_cond->compiled != NULL)
+	    new_cond->compiled
+	      = compile_breakpoint_expression (new_cond->cond);
 	  APPEND_TO_LIST (&gdb_dest->cond_list, new_cond, cond_tail);
 	}
 
@@ -2096,6 +2214,9 @@ clone_one_breakpoint (const struct breakpoint *src, ptid_t ptid)
 	{
 	  new_cmd = XCNEW (struct point_command_list);
 	  new_cmd->cmd = clone_agent_expr (current_cmd->cmd);
+	  if (current_cmd->compiled != NULL)
+	    new_cmd->compiled
+	      = compile_breakpoint_expression (new_cmd->cmd);
 	  new_cmd->persistence = current_cmd->persistence;
 	  APPEND_TO_LIST (&gdb_dest->command_list, new_cmd, cmd_tail);
 	}
@@ -2149,4 +2270,8 @@ clone_all_breakpoints (struct thread_info *child_thread,
       APPEND_TO_LIST (new_list, new_bkpt, bkpt_tail);
       APPEND_TO_LIST (new_raw_list, new_bkpt->raw, raw_bkpt_tail);
     }
+
+  /* The child has the jumps of the fast breakpoints standing for the
+     traps of its GDB breakpoints too.  */
+  clone_fast_breakpoints (child_proc, parent_proc);
 }
@@ -110,6 +110,12 @@ int single_step_breakpoint_inserted_here (CORE_ADDR addr);
 
 void clear_breakpoint_conditions_and_commands (struct gdb_breakpoint *bp);
 
+/* Whether breakpoint conditions and commands are compiled to native
+   code when they are added, instead of being interpreted each time the
+   breakpoint is hit.  */
+
+extern bool compile_breakpoint_expressions;
+
 /* Set target-side condition CONDITION to the breakpoint at ADDR.
    Returns false on failure.  On success, advances CONDITION pointer
    past the condition and returns true.  */
@@ -117,6 +123,12 @@ void clear_breakpoint_conditions_and_commands (struct gdb_breakpoint *bp);
 int add_breakpoint_condition (struct gdb_breakpoint *bp,
 			      const char **condition);
 
+/* Replace the trap of GDB breakpoint BP with a fast breakpoint jump,
+   if BP can be, and INSN_LEN, the length of the instruction at BP, is
+   not 0.  Otherwise, put the trap back if it was replaced.  */
+
+void update_fast_breakpoint (struct gdb_breakpoint *bp, int insn_len);
+
 /* Set target-side commands COMMANDS to the breakpoint at ADDR.
    Returns false on failure.  On success, advances COMMANDS past the
    commands and returns true.  If PERSIST, the commands should run
@@ -243,6 +255,11 @@ struct fast_tracepoint_jump *set_fast_tracepoint_jump (CORE_ADDR where,
 /* Increment reference counter of JP.  */
 void inc_ref_fast_tracepoint_jump (struct fast_tracepoint_jump *jp);
 
+/* Add a copy of jump JP, which is already in the memory of process
+   CHILD_PROC, to CHILD_PROC's tables.  */
+struct fast_tracepoint_jump *clone_fast_tracepoint_jump
+  (struct process_info *child_proc, const struct fast_tracepoint_jump *jp);
+
 /* Delete fast tracepoint jump TODEL from our tables, and uninsert if
    from memory.  */
 
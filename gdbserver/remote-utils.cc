@@ -30,6 +30,7 @@
 #include "gdbsupport/filestuff.h"
 #include "gdbsupport/gdb-sigmask.h"
 #include <ctype.h>
+#include <zlib.h>
 #if HAVE_SYS_IOCTL_H
 #include <sys/ioctl.h>
 #endif
@@ -715,6 +716,44 @@ putpkt (char *buf)
   return putpkt_binary (buf, strlen (buf));
 }
 
+/* Replies shorter than this are not worth compressing.  */
+
+#define COMPRESS_MIN_LENGTH 256
+
+/* Compress the reply of LEN bytes in BUF, if that makes it shorter.
+   The compressed reply is 'Z', the length of the original reply in
+   hex, ':', and the original reply compressed with zlib and escaped
+   like binary data.  Returns the length of the reply now in BUF.  */
+
+int
+compress_packet (char *buf, int len)
+{
+  if (len < COMPRESS_MIN_LENGTH)
+    return len;
+
+  uLongf packed_len = compressBound (len);
+  gdb::byte_vector packed (packed_len);
+  if (compress2 (packed.data (), &packed_len, (const Bytef *) buf, len,
+		 Z_BEST_SPEED) != Z_OK)
+    return len;
+
+  /* Build the compressed reply aside, giving up as soon as it gets
+     as long as the original one.  */
+  gdb::char_vector out (len);
+  int header_len = xsnprintf (out.data (), len, "Z%x:", len);
+  int packed_units;
+  int out_len = remote_escape_output (packed.data (), packed_len, 1,
+				      (gdb_byte *) out.data () + header_len,
+				      &packed_units, len - header_len - 1);
+  if (packed_units != packed_len)
+    return len;
+
+  out_len += header_len;
+  memcpy (buf, out.data (), out_len);
+  buf[out_len] = '\0';
+  return out_len;
+}
+
 int
 putpkt_notif (char *buf)
 {
@@ -1057,6 +1096,10 @@ prepare_resume_reply (char *buf, ptid_t ptid, const target_waitstatus &status)
 			target_pid_to_str (ptid).c_str (),
 			status.to_string ().c_str ());
 
+  /* The thread may have been renamed since the last thread list
+     report.  */
+  note_thread_list_stop (ptid);
+
   switch (status.kind ())
     {
     case TARGET_WAITKIND_STOPPED:
@@ -30,6 +30,7 @@ char *write_ptid (char *buf, ptid_t ptid);
 int putpkt (char *buf);
 int putpkt_binary (char *buf, int len);
 int putpkt_notif (char *buf);
+int compress_packet (char *buf, int len);
 int getpkt (char *buf);
 void remote_prepare (const char *name);
 void remote_open (const char *name);
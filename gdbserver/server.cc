@@ -222,6 +222,61 @@ discard_queued_stop_replies (ptid_t ptid)
     }
 }
 
+/* The number of added, removed or stopped threads recorded for the
+   next qXfer:threads-delta report, past which GDB is sent the whole
+   thread list instead.  */
+#define MAX_CHANGED_THREADS 65536
+
+/* Record PTID in SET, one of the sets of threads that changed since
+   the last qXfer:threads-delta report.  */
+
+static void
+note_thread_list_change (std::unordered_set<ptid_t> &set, ptid_t ptid)
+{
+  client_state &cs = get_client_state ();
+
+  /* Nothing to do if GDB does not use the delta reports.  */
+  if (cs.thread_list_generation == 0)
+    return;
+
+  if (set.size () >= MAX_CHANGED_THREADS)
+    {
+      /* Make the next report a complete one.  */
+      cs.thread_list_generation++;
+      cs.reported_threads.clear ();
+      cs.added_threads.clear ();
+      cs.exited_threads.clear ();
+      cs.stopped_threads.clear ();
+      return;
+    }
+
+  set.insert (ptid);
+}
+
+/* See server.h.  */
+
+void
+note_thread_list_add (ptid_t ptid)
+{
+  note_thread_list_change (get_client_state ().added_threads, ptid);
+}
+
+/* See server.h.  */
+
+void
+note_thread_list_exit (ptid_t ptid)
+{
+  note_thread_list_change (get_client_state ().exited_threads, ptid);
+}
+
+/* See server.h.  */
+
+void
+note_thread_list_stop (ptid_t ptid)
+{
+  note_thread_list_change (get_client_state ().stopped_threads, ptid);
+}
+
 static void
 vstop_notif_reply (struct notif_event *event, char *own_buf)
 {
@@ -1151,6 +1206,8 @@ monitor_show_help (void)
   monitor_output ("    Enable remote protocol debugging messages\n");
   monitor_output ("  set event-loop-debug <0|1>\n");
   monitor_output ("    Enable event loop debugging messages\n");
+  monitor_output ("  set compile-conditions <0|1>\n");
+  monitor_output ("    Compile breakpoint conditions and commands to native code\n");
   monitor_output ("  set debug-format option1[,option2,...]\n");
   monitor_output ("    Add additional information to debugging messages\n");
   monitor_output ("    Options: all, none");
@@ -1504,6 +1561,16 @@ handle_monitor_command (char *mon, char *own_buf)
       debug_event_loop = debug_event_loop_kind::OFF;
       monitor_output ("Event loop debug output disabled.\n");
     }
+  else if (strcmp (mon, "set compile-conditions 1") == 0)
+    {
+      compile_breakpoint_expressions = true;
+      monitor_output ("Compilation of breakpoint conditions enabled.\n");
+    }
+  else if (strcmp (mon, "set compile-conditions 0") == 0)
+    {
+      compile_breakpoint_expressions = false;
+      monitor_output ("Compilation of breakpoint conditions disabled.\n");
+    }
   else if (startswith (mon, "set debug-format "))
     {
       std::string error_msg
@@ -1758,10 +1825,12 @@ handle_qxfer_statictrace (const char *annex,
 }
 
 /* Helper for handle_qxfer_threads_proper.
-   Emit the XML to describe the thread of INF.  */
+   Emit the XML to describe the thread of INF.  If NAME_OUT is not
+   NULL, store the name of the thread there.  */
 
 static void
-handle_qxfer_threads_worker (thread_info *thread, std::string *buffer)
+handle_qxfer_threads_worker (thread_info *thread, std::string *buffer,
+			     std::string *name_out = nullptr)
 {
   ptid_t ptid = ptid_of (thread);
   char ptid_s[100];
@@ -1791,6 +1860,8 @@ handle_qxfer_threads_worker (thread_info *thread, std::string *buffer)
 
   if (name != NULL)
     string_xml_appendf (*buffer, " name=\"%s\"", name);
+  if (name_out != nullptr)
+    *name_out = name != nullptr ? name : "";
 
   if (handle_status)
     {
@@ -1874,6 +1945,169 @@ handle_qxfer_threads (const char *annex,
   return len;
 }
 
+/* Helper for handle_qxfer_threads_delta.  Describe the changes to
+   the thread list since GENERATION, or the whole list if GENERATION is
+   not the last one reported.  Return true on success, false
+   otherwise.
+
+   Only the threads recorded by note_thread_list_add,
+   note_thread_list_exit and note_thread_list_stop are looked at, so
+   that a report costs nothing for the threads that did not change.  In
+   particular, the names of the threads are only read for new threads,
+   and for threads that reported a stop, since a thread may rename
+   itself without the target knowing.  */
+
+static bool
+handle_qxfer_threads_delta_proper (ULONGEST generation,
+				   std::string *buffer)
+{
+  client_state &cs = get_client_state ();
+  bool full = (generation == 0 || generation != cs.thread_list_generation);
+  std::string changes;
+  char ptid_s[100];
+
+  /* See handle_qxfer_threads_proper.  */
+  if (non_stop)
+    target_pause_all (true);
+
+  if (full)
+    {
+      cs.reported_threads.clear ();
+      cs.added_threads.clear ();
+      cs.exited_threads.clear ();
+      cs.stopped_threads.clear ();
+
+      for_each_thread ([&] (thread_info *thread)
+	{
+	  /* (V)fork/clone children are reported once GDB knows about
+	     them, see handle_qxfer_threads_worker.  */
+	  if (target_thread_pending_parent (thread) != nullptr)
+	    {
+	      cs.added_threads.insert (ptid_of (thread));
+	      return;
+	    }
+
+	  handle_qxfer_threads_worker
+	    (thread, &changes, &cs.reported_threads[ptid_of (thread)]);
+	});
+    }
+  else
+    {
+      /* A thread that is gone, unless its ptid was reused since.  Those
+	 created and removed since the last report are included.  */
+      for (ptid_t ptid : cs.exited_threads)
+	if (find_thread_ptid (ptid) == nullptr)
+	  {
+	    write_ptid (ptid_s, ptid);
+	    string_xml_appendf (changes, "<exited id=\"%s\"/>\n", ptid_s);
+	    cs.reported_threads.erase (ptid);
+	  }
+      cs.exited_threads.clear ();
+
+      /* A new thread, described as in the complete list.  */
+      std::unordered_set<ptid_t> pending;
+      for (ptid_t ptid : cs.added_threads)
+	{
+	  thread_info *thread = find_thread_ptid (ptid);
+	  if (thread == nullptr
+	      || cs.reported_threads.find (ptid) != cs.reported_threads.end ())
+	    continue;
+
+	  /* Keep (v)fork/clone children for a later report.  */
+	  if (target_thread_pending_parent (thread) != nullptr)
+	    {
+	      pending.insert (ptid);
+	      continue;
+	    }
+
+	  handle_qxfer_threads_worker (thread, &changes,
+				       &cs.reported_threads[ptid]);
+	}
+      cs.added_threads = std::move (pending);
+
+      /* A thread that reported a stop may have been renamed.  */
+      for (ptid_t ptid : cs.stopped_threads)
+	{
+	  auto it = cs.reported_threads.find (ptid);
+	  if (it == cs.reported_threads.end ()
+	      || find_thread_ptid (ptid) == nullptr)
+	    continue;
+
+	  const char *name = target_thread_name (ptid);
+	  if (name == nullptr)
+	    name = "";
+	  if (it->second != name)
+	    {
+	      write_ptid (ptid_s, ptid);
+	      string_xml_appendf (changes,
+				  "<renamed id=\"%s\" name=\"%s\"/>\n",
+				  ptid_s, name);
+	      it->second = name;
+	    }
+	}
+    }
+  cs.stopped_threads.clear ();
+
+  if (non_stop)
+    target_unpause_all (true);
+
+  if (full || !changes.empty ())
+    cs.thread_list_generation++;
+
+  string_xml_appendf (*buffer, "<threads-delta generation=\"%s\"",
+		      pulongest (cs.thread_list_generation));
+  if (full)
+    *buffer += " full=\"yes\"";
+  *buffer += ">\n";
+  *buffer += changes;
+  *buffer += "</threads-delta>\n";
+  return true;
+}
+
+/* Handle qXfer:threads-delta:read.  The annex is the generation of
+   the thread list GDB last got, in hex.  */
+
+static int
+handle_qxfer_threads_delta (const char *annex,
+			    gdb_byte *readbuf, const gdb_byte *writebuf,
+			    ULONGEST offset, LONGEST len)
+{
+  static std::string result;
+
+  if (writebuf != NULL)
+    return -2;
+
+  if (offset == 0)
+    {
+      const char *end;
+      ULONGEST generation = strtoulst (annex, &end, 16);
+
+      if (annex[0] == '\0' || *end != '\0')
+	return -1;
+
+      /* When asked for data at offset 0, generate everything and store
+	 into 'result'.  Successive reads will be served off 'result'.  */
+      result.clear ();
+
+      if (!handle_qxfer_threads_delta_proper (generation, &result))
+	return -1;
+    }
+
+  if (offset >= result.length ())
+    {
+      /* We're out of data.  */
+      result.clear ();
+      return 0;
+    }
+
+  if (len > result.length () - offset)
+    len = result.length () - offset;
+
+  memcpy (readbuf, result.c_str () + offset, len);
+
+  return len;
+}
+
 /* Handle qXfer:traceframe-info:read.  */
 
 static int
@@ -2095,6 +2329,7 @@ static const struct qxfer qxfer_packets[] =
     { "siginfo", handle_qxfer_siginfo },
     { "statictrace", handle_qxfer_statictrace },
     { "threads", handle_qxfer_threads },
+    { "threads-delta", handle_qxfer_threads_delta },
     { "traceframe-info", handle_qxfer_traceframe_info },
   };
 
@@ -2484,6 +2719,27 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 		  if (target_supports_memory_tagging ())
 		    cs.memory_tagging_feature = true;
 		}
+	      else if (feature == "memory-read-pipeline+")
+		{
+		  /* GDB may send several memory-read packets before
+		     waiting for their replies.  */
+		  cs.memory_read_pipeline_feature = true;
+		}
+	      else if (feature == "vFile-pread-pipeline+")
+		{
+		  /* Likewise for vFile:pread packets.  */
+		  cs.vfile_pread_pipeline_feature = true;
+		}
+	      else if (startswith (feature, "compression="))
+		{
+		  /* GDB lists the algorithms it can expand, separated
+		     by commas.  */
+		  std::string algorithms
+		    = "," + feature.substr (strlen ("compression=")) + ",";
+
+		  if (algorithms.find (",zlib,") != std::string::npos)
+		    cs.compression_feature = true;
+		}
 	      else
 		{
 		  /* Move the unknown features all together.  */
@@ -2556,6 +2812,7 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 	strcat (own_buf, ";QDisableRandomization+");
 
       strcat (own_buf, ";qXfer:threads:read+");
+      strcat (own_buf, ";qXfer:threads-delta:read+");
 
       if (target_supports_tracepoints ())
 	{
@@ -2578,6 +2835,9 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 	  || target_supports_software_single_step () )
 	{
 	  strcat (own_buf, ";ConditionalBreakpoints+");
+
+	  if (target_supports_fast_tracepoints ())
+	    strcat (own_buf, ";FastBreakpoints+");
 	}
       strcat (own_buf, ";BreakpointCommands+");
 
@@ -2613,6 +2873,19 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       if (target_supports_memory_tagging ())
 	strcat (own_buf, ";memory-tagging+");
 
+      /* The memory-read packets GDB sends before waiting for their
+	 replies queue up in the readchar buffer and are handled in
+	 order, see reschedule.  */
+      if (cs.memory_read_pipeline_feature)
+	strcat (own_buf, ";memory-read-pipeline+");
+
+      /* So do the vFile:pread packets.  */
+      if (cs.vfile_pread_pipeline_feature)
+	strcat (own_buf, ";vFile-pread-pipeline+");
+
+      if (cs.compression_feature)
+	strcat (own_buf, ";compression=zlib");
+
       /* Reinitialize components as needed for the new connection.  */
       hostio_handle_new_gdb_connection ();
       target_handle_new_gdb_connection ();
@@ -4107,6 +4380,14 @@ captured_main (int argc, char *argv[])
       cs.hwbreak_feature = 0;
       cs.vCont_supported = 0;
       cs.memory_tagging_feature = false;
+      cs.memory_read_pipeline_feature = false;
+      cs.vfile_pread_pipeline_feature = false;
+      cs.compression_feature = false;
+      cs.thread_list_generation = 0;
+      cs.reported_threads.clear ();
+      cs.added_threads.clear ();
+      cs.exited_threads.clear ();
+      cs.stopped_threads.clear ();
 
       remote_open (port);
 
@@ -4221,14 +4502,19 @@ main (int argc, char *argv[])
 
 /* Process options coming from Z packets for a breakpoint.  PACKET is
    the packet buffer.  *PACKET is updated to point to the first char
-   after the last processed option.  */
+   after the last processed option.  *FAST_INSN_LEN is set to the
+   length of the instruction at the breakpoint if GDB allows a jump
+   to replace the breakpoint, and to 0 otherwise.  */
 
 static void
-process_point_options (struct gdb_breakpoint *bp, const char **packet)
+process_point_options (struct gdb_breakpoint *bp, const char **packet,
+		       int *fast_insn_len)
 {
   const char *dataptr = *packet;
   int persist;
 
+  *fast_insn_len = 0;
+
   /* Check if data has the correct format.  */
   if (*dataptr != ';')
     return;
@@ -4256,6 +4542,16 @@ process_point_options (struct gdb_breakpoint *bp, const char **packet)
 	  if (add_breakpoint_commands (bp, &dataptr, persist))
 	    dataptr = strchrnul (dataptr, ';');
 	}
+      else if (*dataptr == 'F')
+	{
+	  ULONGEST len;
+
+	  /* The breakpoint may be replaced by a jump.  */
+	  dataptr = unpack_varlen_hex (dataptr + 1, &len);
+	  threads_debug_printf ("Found fast breakpoint option, "
+				"instruction length %s.", pulongest (len));
+	  *fast_insn_len = len;
+	}
       else
 	{
 	  fprintf (stderr, "Unknown token %c, ignoring.\n",
@@ -4267,6 +4563,18 @@ process_point_options (struct gdb_breakpoint *bp, const char **packet)
   *packet = dataptr;
 }
 
+/* Return true if the reply to the packet in BUF is one of the large
+   ones worth compressing: memory and register reads, qXfer objects
+   and target file reads.  */
+
+static bool
+reply_compressible (const char *buf)
+{
+  return (buf[0] == 'm' || buf[0] == 'g'
+	  || startswith (buf, "qXfer:")
+	  || startswith (buf, "vFile:pread:"));
+}
+
 /* Event loop callback that handles a serial event.  The first byte in
    the serial buffer gets us here.  We expect characters to arrive at
    a brisk pace, so we read the rest of the packet with a blocking
@@ -4295,6 +4603,10 @@ process_serial_event (void)
     }
   response_needed = true;
 
+  /* Whether the reply may be compressed, see compress_packet.  */
+  bool compress_reply = (cs.compression_feature
+			 && reply_compressible (cs.own_buf));
+
   char ch = cs.own_buf[0];
   switch (ch)
     {
@@ -4507,7 +4819,13 @@ process_serial_event (void)
 		   instead.  */
 		clear_breakpoint_conditions_and_commands (bp);
 		const char *options = dataptr;
-		process_point_options (bp, &options);
+		int fast_insn_len;
+		process_point_options (bp, &options, &fast_insn_len);
+
+		/* Now that the options are known, see whether a jump
+		   evaluating the condition in the inferior can stand for
+		   the trap.  This may reuse the packet buffer.  */
+		update_fast_breakpoint (bp, fast_insn_len);
 	      }
 	  }
 	else
@@ -4616,6 +4934,13 @@ process_serial_event (void)
       break;
     }
 
+  if (compress_reply)
+    {
+      if (new_packet_len == -1)
+	new_packet_len = strlen (cs.own_buf);
+      new_packet_len = compress_packet (cs.own_buf, new_packet_len);
+    }
+
   if (new_packet_len != -1)
     putpkt_binary (cs.own_buf, new_packet_len);
   else
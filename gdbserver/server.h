@@ -87,6 +87,18 @@ extern void handle_target_event (int err, gdb_client_data client_data);
 /* Get rid of the currently pending stop replies that match PTID.  */
 extern void discard_queued_stop_replies (ptid_t ptid);
 
+/* Record that the thread PTID was added, for the next
+   qXfer:threads-delta report.  */
+extern void note_thread_list_add (ptid_t ptid);
+
+/* Record that the thread PTID was removed, for the next
+   qXfer:threads-delta report.  */
+extern void note_thread_list_exit (ptid_t ptid);
+
+/* Record that the thread PTID reported a stop to GDB, for the next
+   qXfer:threads-delta report, which then checks its name.  */
+extern void note_thread_list_stop (ptid_t ptid);
+
 /* Returns true if there's a pending stop reply that matches PTID in
    the vStopped notifications queue.  */
 extern int in_queued_stop_replies (ptid_t ptid);
@@ -96,6 +108,8 @@ extern int in_queued_stop_replies (ptid_t ptid);
 #include "utils.h"
 #include "debug.h"
 #include "gdbsupport/gdb_vecs.h"
+#include <unordered_map>
+#include <unordered_set>
 
 /* Maximum number of bytes to read/write at once.  The value here
    is chosen to fill up a packet (the headers account for the 32).  */
@@ -192,6 +206,38 @@ struct client_state
   /* If true, memory tagging features are supported.  */
   bool memory_tagging_feature = false;
 
+  /* If true, GDB may send several memory-read packets before waiting
+     for their replies.  */
+  bool memory_read_pipeline_feature = false;
+
+  /* If true, GDB may send several vFile:pread packets before waiting
+     for their replies.  */
+  bool vfile_pread_pipeline_feature = false;
+
+  /* If true, GDB accepts large replies compressed with zlib.  */
+  bool compression_feature = false;
+
+  /* The generation of the thread list last reported with
+     qXfer:threads-delta, or 0 if none was.  */
+  ULONGEST thread_list_generation = 0;
+
+  /* The threads GDB was told about by the reports so far, with the
+     names it was given.  This is kept up to date from one report to
+     the next.  */
+  std::unordered_map<ptid_t, std::string> reported_threads;
+
+  /* The threads added since the last report, and the (v)fork/clone
+     children not reported yet.  */
+  std::unordered_set<ptid_t> added_threads;
+
+  /* The threads removed since the last report.  They are reported as
+     exited even if they were created after it, as GDB may have
+     learned about them from a stop reply.  */
+  std::unordered_set<ptid_t> exited_threads;
+
+  /* The threads that reported a stop since the last report.  */
+  std::unordered_set<ptid_t> stopped_threads;
+
 };
 
 client_state &get_client_state ();
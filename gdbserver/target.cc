@@ -681,6 +681,12 @@ process_stratum_target::emit_ops ()
   return nullptr;
 }
 
+struct emit_ops *
+process_stratum_target::host_emit_ops ()
+{
+  return nullptr;
+}
+
 bool
 process_stratum_target::supports_disable_randomization ()
 {
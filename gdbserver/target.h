@@ -378,6 +378,12 @@ class process_stratum_target
      Returns nullptr if bytecode compilation is not supported.  */
   virtual struct emit_ops *emit_ops ();
 
+  /* Return the bytecode operations vector that generates code for
+     GDBserver itself rather than for the inferior, to compile the
+     expressions GDBserver evaluates on its own, such as breakpoint
+     conditions.  Returns nullptr if there is none.  */
+  virtual struct emit_ops *host_emit_ops ();
+
   /* Returns true if the target supports disabling randomization.  */
   virtual bool supports_disable_randomization ();
 
@@ -626,6 +632,9 @@ int kill_inferior (process_info *proc);
 #define target_emit_ops() \
   the_target->emit_ops ()
 
+#define target_host_emit_ops() \
+  the_target->host_emit_ops ()
+
 #define target_supports_disable_randomization() \
   the_target->supports_disable_randomization ()
 
@@ -104,8 +104,12 @@ trace_vdebug (const char *fmt, ...)
 # define gdb_trampoline_buffer_error IPA_SYM_EXPORTED_NAME (gdb_trampoline_buffer_error)
 # define collecting IPA_SYM_EXPORTED_NAME (collecting)
 # define gdb_collect_ptr IPA_SYM_EXPORTED_NAME (gdb_collect_ptr)
+# define gdb_collect_breakpoint_ptr \
+  IPA_SYM_EXPORTED_NAME (gdb_collect_breakpoint_ptr)
 # define stop_tracing IPA_SYM_EXPORTED_NAME (stop_tracing)
 # define flush_trace_buffer IPA_SYM_EXPORTED_NAME (flush_trace_buffer)
+# define stop_at_fast_breakpoint \
+  IPA_SYM_EXPORTED_NAME (stop_at_fast_breakpoint)
 # define about_to_request_buffer_space IPA_SYM_EXPORTED_NAME (about_to_request_buffer_space)
 # define trace_buffer_is_full IPA_SYM_EXPORTED_NAME (trace_buffer_is_full)
 # define stopping_tracepoint IPA_SYM_EXPORTED_NAME (stopping_tracepoint)
@@ -146,8 +150,10 @@ struct ipa_sym_addresses
   CORE_ADDR addr_gdb_trampoline_buffer_error;
   CORE_ADDR addr_collecting;
   CORE_ADDR addr_gdb_collect_ptr;
+  CORE_ADDR addr_gdb_collect_breakpoint_ptr;
   CORE_ADDR addr_stop_tracing;
   CORE_ADDR addr_flush_trace_buffer;
+  CORE_ADDR addr_stop_at_fast_breakpoint;
   CORE_ADDR addr_about_to_request_buffer_space;
   CORE_ADDR addr_trace_buffer_is_full;
   CORE_ADDR addr_stopping_tracepoint;
@@ -183,8 +189,10 @@ static struct
   IPA_SYM(gdb_trampoline_buffer_error),
   IPA_SYM(collecting),
   IPA_SYM(gdb_collect_ptr),
+  IPA_SYM(gdb_collect_breakpoint_ptr),
   IPA_SYM(stop_tracing),
   IPA_SYM(flush_trace_buffer),
+  IPA_SYM(stop_at_fast_breakpoint),
   IPA_SYM(about_to_request_buffer_space),
   IPA_SYM(trace_buffer_is_full),
   IPA_SYM(stopping_tracepoint),
@@ -341,9 +349,16 @@ tracepoint_look_up_symbols (void)
    "flush_trace_buffer", which triggers an internal breakpoint.
    GDBserver reacts to this breakpoint by pulling the meanwhile
    collected data.  Old frames discarding is always handled on the
-   GDBserver side.  */
+   GDBserver side.
+
+   Likewise, the jump pads of fast breakpoints call
+   "stop_at_fast_breakpoint" when the breakpoint's condition is true,
+   so that GDBserver reports the breakpoint hit to GDB.  */
 
 #ifdef IN_PROCESS_AGENT
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
 /* See target.h.  */
 
 int
@@ -353,6 +368,34 @@ read_inferior_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
   return 0;
 }
 
+/* Like read_inferior_memory, but return non-zero instead of faulting
+   if the LEN bytes at MEMADDR can't be read.  The agent expressions
+   the jump pads evaluate may dereference any address, and an error
+   lets GDBserver evaluate them again and report it.  The kernel does
+   the read, so this is slower than a plain copy.  */
+
+static int
+read_inferior_memory_safely (CORE_ADDR memaddr, unsigned char *myaddr,
+			     int len)
+{
+#ifdef SYS_process_vm_readv
+  struct iovec local, remote;
+  int saved_errno = errno;
+  ssize_t nread;
+
+  local.iov_base = myaddr;
+  local.iov_len = len;
+  remote.iov_base = (void *) (uintptr_t) memaddr;
+  remote.iov_len = len;
+  nread = syscall (SYS_process_vm_readv, getpid (), &local, 1,
+		   &remote, 1, 0);
+  errno = saved_errno;
+  return nread == len ? 0 : 1;
+#else
+  return 1;
+#endif
+}
+
 /* Call this in the functions where GDBserver places a breakpoint, so
    that the compiler doesn't try to be clever and skip calling the
    function at all.  This is necessary, even if we tell the compiler
@@ -384,6 +427,16 @@ flush_trace_buffer (void)
   UNKNOWN_SIDE_EFFECTS();
 }
 
+/* This is needed for -Wmissing-declarations.  */
+IP_AGENT_EXPORT_FUNC void stop_at_fast_breakpoint (void);
+
+IP_AGENT_EXPORT_FUNC void
+stop_at_fast_breakpoint (void)
+{
+  /* GDBserver places breakpoint here.  */
+  UNKNOWN_SIDE_EFFECTS();
+}
+
 #endif
 
 #ifndef IN_PROCESS_AGENT
@@ -802,6 +855,50 @@ struct tracepoint
 
 #ifndef IN_PROCESS_AGENT
 
+#define MAX_JUMP_SIZE 20
+
+/* A fast breakpoint: a GDB breakpoint whose trap is replaced by a
+   jump to a jump pad, where the in-process agent evaluates the
+   breakpoint's condition, and only stops the thread when it is true.
+   TPOINT holds the condition and the jump pad, like for a fast
+   tracepoint, and is downloaded to the in-process agent the same way.
+
+   Jump pad space is never reclaimed, so fast breakpoints are kept
+   around when GDB removes the breakpoint, to be reused when it
+   inserts it again, as it usually does on every resume.  */
+
+struct fast_breakpoint
+{
+  struct fast_breakpoint *next;
+
+  struct tracepoint tpoint;
+
+  /* The jump to the jump pad, to insert when GDB inserts the
+     breakpoint.  */
+  unsigned char fjump[MAX_JUMP_SIZE];
+  ULONGEST fjump_size;
+
+  /* The original instruction at the breakpoint's address, relocated
+     to the jump pad.  A fast breakpoint is only reused if this still
+     matches what the inferior has there.  */
+  unsigned char insn[MAX_JUMP_SIZE];
+
+  /* The space in the inferior taken by the conditions this
+     breakpoint was given after it was created, which is never
+     reclaimed either.  See set_fast_breakpoint_condition.  */
+  ULONGEST cond_space;
+};
+
+/* Return the list of fast breakpoints of the current process.  */
+
+static struct fast_breakpoint *
+current_fast_breakpoints (void)
+{
+  struct process_info *proc = current_process ();
+
+  return proc != NULL ? proc->fast_breakpoints : NULL;
+}
+
 /* Given `while-stepping', a thread may be collecting data for more
    than one tracepoint simultaneously.  On the other hand, the same
    tracepoint with a while-stepping action may be hit by more than one
@@ -3052,37 +3149,18 @@ clone_fast_tracepoint (struct tracepoint *to, const struct tracepoint *from)
   inc_ref_fast_tracepoint_jump ((struct fast_tracepoint_jump *) from->handle);
 }
 
-#define MAX_JUMP_SIZE 20
-
-/* Install fast tracepoint.  Return 0 if successful, otherwise return
-   non-zero.  */
+/* Build a jump pad calling COLLECT for the fast tracepoint TPOINT,
+   and wire it in.  The jump to the jump pad is returned in FJUMP and
+   *FJUMP_SIZE.  Return 0 if successful, otherwise return non-zero.  */
 
 static int
-install_fast_tracepoint (struct tracepoint *tpoint, char *errbuf)
+install_jump_pad (struct tracepoint *tpoint, CORE_ADDR collect,
+		  unsigned char *fjump, ULONGEST *fjump_size, char *errbuf)
 {
   CORE_ADDR jentry, jump_entry;
   CORE_ADDR trampoline;
-  CORE_ADDR collect;
   ULONGEST trampoline_size;
   int err = 0;
-  /* The jump to the jump pad of the last fast tracepoint
-     installed.  */
-  unsigned char fjump[MAX_JUMP_SIZE];
-  ULONGEST fjump_size;
-
-  if (tpoint->orig_size < target_get_min_fast_tracepoint_insn_len ())
-    {
-      trace_debug ("Requested a fast tracepoint on an instruction "
-		   "that is of less than the minimum length.");
-      return 0;
-    }
-
-  if (read_inferior_data_pointer (ipa_sym_addrs.addr_gdb_collect_ptr,
-				  &collect))
-    {
-      error ("error extracting gdb_collect_ptr");
-      return 1;
-    }
 
   jentry = jump_entry = get_jump_space_head ();
 
@@ -3093,7 +3171,7 @@ install_fast_tracepoint (struct tracepoint *tpoint, char *errbuf)
   err = target_install_fast_tracepoint_jump_pad
     (tpoint->obj_addr_on_target, tpoint->address, collect,
      ipa_sym_addrs.addr_collecting, tpoint->orig_size, &jentry,
-     &trampoline, &trampoline_size, fjump, &fjump_size,
+     &trampoline, &trampoline_size, fjump, fjump_size,
      &tpoint->adjusted_insn_addr, &tpoint->adjusted_insn_addr_end, errbuf);
 
   if (err)
@@ -3101,7 +3179,7 @@ install_fast_tracepoint (struct tracepoint *tpoint, char *errbuf)
 
   /* Wire it in.  */
   tpoint->handle = set_fast_tracepoint_jump (tpoint->address, fjump,
-					     fjump_size);
+					     *fjump_size);
 
   if (tpoint->handle != NULL)
     {
@@ -3118,6 +3196,45 @@ install_fast_tracepoint (struct tracepoint *tpoint, char *errbuf)
   return 0;
 }
 
+/* Install fast tracepoint.  Return 0 if successful, otherwise return
+   non-zero.  */
+
+static int
+install_fast_tracepoint (struct tracepoint *tpoint, char *errbuf)
+{
+  CORE_ADDR collect;
+  /* The jump to the jump pad of the last fast tracepoint
+     installed.  */
+  unsigned char fjump[MAX_JUMP_SIZE];
+  ULONGEST fjump_size;
+
+  if (tpoint->orig_size < target_get_min_fast_tracepoint_insn_len ())
+    {
+      trace_debug ("Requested a fast tracepoint on an instruction "
+		   "that is of less than the minimum length.");
+      return 0;
+    }
+
+  /* A fast breakpoint's jump can't be shared.  */
+  for (struct fast_breakpoint *fb = current_fast_breakpoints ();
+       fb != NULL; fb = fb->next)
+    if (fb->tpoint.address == tpoint->address && fb->tpoint.handle != NULL)
+      {
+	trace_debug ("Requested a fast tracepoint at the address of "
+		     "a fast breakpoint.");
+	return 0;
+      }
+
+  if (read_inferior_data_pointer (ipa_sym_addrs.addr_gdb_collect_ptr,
+				  &collect))
+    {
+      error ("error extracting gdb_collect_ptr");
+      return 1;
+    }
+
+  return install_jump_pad (tpoint, collect, fjump, &fjump_size, errbuf);
+}
+
 
 /* Install tracepoint TPOINT, and write reply message in OWN_BUF.  */
 
@@ -4921,7 +5038,11 @@ agent_mem_read (struct eval_agent_expr_context *ctx,
 
   /* If a 'to' buffer is specified, use it.  */
   if (to != NULL)
+#ifdef IN_PROCESS_AGENT
+    return read_inferior_memory_safely (from, to, len);
+#else
     return read_inferior_memory (from, to, len);
+#endif
 
   /* Otherwise, create a new memory block in the trace buffer.  */
   while (remaining > 0)
@@ -5454,27 +5575,35 @@ traceframe_read_info (int tfnum, std::string *buffer)
   return 0;
 }
 
-/* Return the first fast tracepoint whose jump pad contains PC.  */
+/* Return the first fast tracepoint whose jump pad contains PC.  The
+   tracepoints of fast breakpoints are considered too.  */
 
 static struct tracepoint *
 fast_tracepoint_from_jump_pad_address (CORE_ADDR pc)
 {
   struct tracepoint *tpoint;
+  struct fast_breakpoint *fb;
 
   for (tpoint = tracepoints; tpoint; tpoint = tpoint->next)
     if (tpoint->type == fast_tracepoint)
       if (tpoint->jump_pad <= pc && pc < tpoint->jump_pad_end)
 	return tpoint;
 
+  for (fb = current_fast_breakpoints (); fb; fb = fb->next)
+    if (fb->tpoint.jump_pad <= pc && pc < fb->tpoint.jump_pad_end)
+      return &fb->tpoint;
+
   return NULL;
 }
 
-/* Return the first fast tracepoint whose trampoline contains PC.  */
+/* Return the first fast tracepoint whose trampoline contains PC.  The
+   tracepoints of fast breakpoints are considered too.  */
 
 static struct tracepoint *
 fast_tracepoint_from_trampoline_address (CORE_ADDR pc)
 {
   struct tracepoint *tpoint;
+  struct fast_breakpoint *fb;
 
   for (tpoint = tracepoints; tpoint; tpoint = tpoint->next)
     {
@@ -5483,23 +5612,33 @@ fast_tracepoint_from_trampoline_address (CORE_ADDR pc)
 	return tpoint;
     }
 
+  for (fb = current_fast_breakpoints (); fb; fb = fb->next)
+    if (fb->tpoint.trampoline <= pc && pc < fb->tpoint.trampoline_end)
+      return &fb->tpoint;
+
   return NULL;
 }
 
 /* Return GDBserver's tracepoint that matches the IP Agent's
    tracepoint object that lives at IPA_TPOINT_OBJ in the IP Agent's
-   address space.  */
+   address space.  The tracepoints of fast breakpoints are considered
+   too.  */
 
 static struct tracepoint *
 fast_tracepoint_from_ipa_tpoint_address (CORE_ADDR ipa_tpoint_obj)
 {
   struct tracepoint *tpoint;
+  struct fast_breakpoint *fb;
 
   for (tpoint = tracepoints; tpoint; tpoint = tpoint->next)
     if (tpoint->type == fast_tracepoint)
       if (tpoint->obj_addr_on_target == ipa_tpoint_obj)
 	return tpoint;
 
+  for (fb = current_fast_breakpoints (); fb; fb = fb->next)
+    if (fb->tpoint.obj_addr_on_target == ipa_tpoint_obj)
+      return &fb->tpoint;
+
   return NULL;
 }
 
@@ -5830,6 +5969,55 @@ gdb_collect (struct tracepoint *tpoint, unsigned char *regs)
     }
 }
 
+/* This is needed for -Wmissing-declarations.  */
+IP_AGENT_EXPORT_FUNC void gdb_collect_breakpoint (struct tracepoint *tpoint,
+						  unsigned char *regs);
+
+/* The counterpart of gdb_collect for the jump pads of fast
+   breakpoints.  TPOINT carries the condition of a GDB breakpoint:
+   evaluate it, and only stop the thread if it is true.  Evaluation
+   errors stop the thread too, so that GDBserver evaluates the
+   condition itself and GDB gets to see the error.  Conditions that
+   read memory are never compiled, so that a bad address is such an
+   error rather than a fault; see download_fast_breakpoint_condition.  */
+
+IP_AGENT_EXPORT_FUNC void
+gdb_collect_breakpoint (struct tracepoint *tpoint, unsigned char *regs)
+{
+  ULONGEST value = 0;
+  enum eval_result_type err;
+
+  if (!tpoint->enabled)
+    return;
+
+  tpoint->hit_count++;
+
+  if (tpoint->compiled_cond)
+    err = ((condfn) (uintptr_t) (tpoint->compiled_cond)) (regs, &value);
+  else
+    {
+      struct fast_tracepoint_ctx ctx;
+      struct eval_agent_expr_context ax_ctx;
+      const struct target_desc *ipa_tdesc = get_ipa_tdesc (ipa_tdesc_idx);
+
+      ctx.base.type = fast_tracepoint;
+      ctx.regs = regs;
+      ctx.regcache_initted = 0;
+      ctx.regspace = (unsigned char *) alloca (ipa_tdesc->registers_size);
+      ctx.tpoint = tpoint;
+
+      ax_ctx.regcache = get_context_regcache ((struct tracepoint_hit_ctx *)
+					      &ctx);
+      ax_ctx.tframe = NULL;
+      ax_ctx.tpoint = tpoint;
+
+      err = gdb_eval_agent_expr (&ax_ctx, tpoint->cond, &value);
+    }
+
+  if (err != expr_eval_no_error || value != 0)
+    stop_at_fast_breakpoint ();
+}
+
 /* These global variables points to the corresponding functions.  This is
    necessary on powerpc64, where asking for function symbol address from gdb
    results in returning the actual code pointer, instead of the descriptor
@@ -5842,6 +6030,8 @@ typedef void (*set_trace_state_variable_value_ptr_type) (int, LONGEST);
 
 extern "C" {
 IP_AGENT_EXPORT_VAR gdb_collect_ptr_type gdb_collect_ptr = gdb_collect;
+IP_AGENT_EXPORT_VAR gdb_collect_ptr_type gdb_collect_breakpoint_ptr
+  = gdb_collect_breakpoint;
 IP_AGENT_EXPORT_VAR get_raw_reg_ptr_type get_raw_reg_ptr = get_raw_reg;
 IP_AGENT_EXPORT_VAR get_trace_state_variable_value_ptr_type
   get_trace_state_variable_value_ptr = get_trace_state_variable_value;
@@ -6205,6 +6395,338 @@ download_tracepoint (struct tracepoint *tpoint)
 
 }
 
+/* The jump pad space a fast breakpoint needs at most, besides its
+   compiled condition, and the space to budget for each byte of the
+   condition's bytecode.  The jump pad builders don't check for
+   overflow themselves.  */
+#define FAST_BREAKPOINT_JUMP_PAD_SIZE 1024
+#define FAST_BREAKPOINT_JUMP_PAD_SIZE_PER_BYTECODE 64
+
+/* The most space in the inferior a fast breakpoint may take for the
+   conditions it is given after its creation.  Past that, changing its
+   condition makes it a trap again, so that editing a condition over
+   and over can't use up the jump pad space fast tracepoints share.  */
+#define FAST_BREAKPOINT_CONDITION_SPACE 4096
+
+/* Return true if there are at least SIZE bytes of jump pad space
+   left.  */
+
+static bool
+jump_space_left_p (ULONGEST size)
+{
+  CORE_ADDR jump_pad_end;
+
+  if (read_inferior_data_pointer (ipa_sym_addrs.addr_gdb_jump_pad_buffer_end,
+				  &jump_pad_end))
+    {
+      trace_debug ("error extracting gdb_jump_pad_buffer_end");
+      return false;
+    }
+
+  return get_jump_space_head () + size <= jump_pad_end;
+}
+
+/* Return a copy of the agent expression EXPR.  */
+
+static struct agent_expr *
+copy_agent_expr (const struct agent_expr *expr)
+{
+  struct agent_expr *copy = XCNEW (struct agent_expr);
+
+  copy->length = expr->length;
+  copy->bytes = (unsigned char *) xmalloc (expr->length);
+  memcpy (copy->bytes, expr->bytes, expr->length);
+  return copy;
+}
+
+/* Return true if the condition COND of a fast breakpoint should be
+   compiled to native code.  The compiled code reads memory directly,
+   and would crash the inferior on a bad address where the in-process
+   agent's interpreter reports an error, so conditions that read
+   memory are left to the interpreter.  */
+
+static bool
+compile_fast_breakpoint_condition_p (const struct agent_expr *cond)
+{
+  return target_emit_ops () != NULL && !gdb_agent_expr_reads_memory (cond);
+}
+
+/* Give the condition of the fast breakpoint FB, FB->tpoint.cond, to
+   the in-process agent, compiling it if possible.  Return the jump
+   pad space the compiled code took.  */
+
+static ULONGEST
+download_fast_breakpoint_condition (struct fast_breakpoint *fb)
+{
+  CORE_ADDR tpptr = fb->tpoint.obj_addr_on_target;
+  ULONGEST code_space = 0;
+
+  fb->tpoint.compiled_cond = 0;
+
+  if (compile_fast_breakpoint_condition_p (fb->tpoint.cond))
+    {
+      CORE_ADDR jentry, jump_entry;
+
+      jentry = jump_entry = get_jump_space_head ();
+      jentry = UALIGN (jentry, 8);
+      compile_tracepoint_condition (&fb->tpoint, &jentry);
+      jentry = UALIGN (jentry, 8);
+      claim_jump_space (jentry - jump_entry);
+      code_space = jentry - jump_entry;
+    }
+
+  write_inferior_data_pointer (tpptr + offsetof (struct tracepoint, cond),
+			       download_agent_expr (fb->tpoint.cond));
+  write_inferior_data_pointer (tpptr
+			       + offsetof (struct tracepoint, compiled_cond),
+			       fb->tpoint.compiled_cond);
+  return code_space;
+}
+
+/* Replace the condition of the fast breakpoint FB with COND, both in
+   GDBserver and in the in-process agent.  The old condition is left
+   in place in the in-process agent, threads may still be evaluating
+   it.  Return 0 if successful, or non-zero, leaving FB untouched, if
+   FB used up its share of space for conditions, or if the jump pad
+   space is exhausted.  */
+
+static int
+set_fast_breakpoint_condition (struct fast_breakpoint *fb,
+			       const struct agent_expr *cond)
+{
+  ULONGEST code_size = 0;
+
+  if (compile_fast_breakpoint_condition_p (cond))
+    {
+      code_size = FAST_BREAKPOINT_JUMP_PAD_SIZE_PER_BYTECODE * cond->length;
+      if (!jump_space_left_p (code_size))
+	{
+	  trace_debug ("Not enough jump pad space left for the condition "
+		       "of the fast breakpoint at %s",
+		       paddress (fb->tpoint.address));
+	  return 1;
+	}
+    }
+
+  if (fb->cond_space + code_size + sizeof (struct agent_expr) + cond->length
+      > FAST_BREAKPOINT_CONDITION_SPACE)
+    {
+      trace_debug ("The fast breakpoint at %s used up its space for "
+		   "conditions", paddress (fb->tpoint.address));
+      return 1;
+    }
+
+  gdb_free_agent_expr (fb->tpoint.cond);
+  fb->tpoint.cond = copy_agent_expr (cond);
+  fb->cond_space += sizeof (struct agent_expr) + cond->length;
+  fb->cond_space += download_fast_breakpoint_condition (fb);
+  return 0;
+}
+
+/* Create a fast breakpoint at ADDRESS, evaluating COND, for the
+   INSN_LEN bytes long instruction whose contents are INSN.  Returns
+   NULL if the jump pad couldn't be built.  */
+
+static struct fast_breakpoint *
+create_fast_breakpoint (CORE_ADDR address, int insn_len,
+			const unsigned char *insn,
+			const struct agent_expr *cond)
+{
+  struct process_info *proc = current_process ();
+  CORE_ADDR collect;
+  char errbuf[IPA_BUFSIZ];
+
+  if (read_inferior_data_pointer
+	(ipa_sym_addrs.addr_gdb_collect_breakpoint_ptr, &collect))
+    {
+      trace_debug ("error extracting gdb_collect_breakpoint_ptr");
+      return NULL;
+    }
+
+  if (!jump_space_left_p (FAST_BREAKPOINT_JUMP_PAD_SIZE
+			  + (FAST_BREAKPOINT_JUMP_PAD_SIZE_PER_BYTECODE
+			     * cond->length)))
+    {
+      trace_debug ("Not enough jump pad space left for a fast breakpoint "
+		   "at %s", paddress (address));
+      return NULL;
+    }
+
+  struct fast_breakpoint *fb = XCNEW (struct fast_breakpoint);
+
+  fb->tpoint.address = address;
+  fb->tpoint.type = fast_tracepoint;
+  fb->tpoint.enabled = 1;
+  fb->tpoint.orig_size = insn_len;
+  memcpy (fb->insn, insn, insn_len);
+
+  /* The condition is downloaded separately, download_tracepoint_1
+     would compile all of them.  */
+  download_tracepoint_1 (&fb->tpoint);
+  fb->tpoint.cond = copy_agent_expr (cond);
+  download_fast_breakpoint_condition (fb);
+
+  errbuf[0] = '\0';
+  if (install_jump_pad (&fb->tpoint, collect, fb->fjump, &fb->fjump_size,
+			errbuf) != 0
+      || fb->tpoint.handle == NULL)
+    {
+      trace_debug ("Failed to install the jump pad of fast breakpoint "
+		   "at %s: %s", paddress (address), errbuf);
+      gdb_free_agent_expr (fb->tpoint.cond);
+      free (fb);
+      return NULL;
+    }
+
+  fb->next = proc->fast_breakpoints;
+  proc->fast_breakpoints = fb;
+  return fb;
+}
+
+/* See tracepoint.h.  */
+
+int
+set_fast_breakpoint (CORE_ADDR address, int insn_len,
+		     const struct agent_expr *cond)
+{
+  struct fast_breakpoint *fb;
+  unsigned char insn[MAX_JUMP_SIZE];
+
+  if (!agent_loaded_p ()
+      || !target_supports_fast_tracepoints ()
+      || insn_len > MAX_JUMP_SIZE
+      || insn_len < target_get_min_fast_tracepoint_insn_len ())
+    return 1;
+
+  /* Reading through the breakpoint and jump shadows gets us the
+     instruction that is really at ADDRESS.  */
+  if (read_inferior_memory (address, insn, insn_len) != 0)
+    return 1;
+
+  for (fb = current_process ()->fast_breakpoints; fb != NULL; fb = fb->next)
+    if (fb->tpoint.address == address
+	&& fb->tpoint.orig_size == insn_len
+	&& memcmp (fb->insn, insn, insn_len) == 0)
+      break;
+
+  /* Don't take over the jump of a fast tracepoint.  */
+  if ((fb == NULL || fb->tpoint.handle == NULL)
+      && fast_tracepoint_jump_here (address))
+    return 1;
+
+  /* Pause all threads while we patch code, and the in-process agent's
+     objects.  */
+  target_pause_all (true);
+
+  if (fb == NULL)
+    fb = create_fast_breakpoint (address, insn_len, insn, cond);
+  else
+    {
+      /* On failure, the caller removes the jump, which still
+	 evaluates the old condition.  */
+      if ((fb->tpoint.cond->length != cond->length
+	   || memcmp (fb->tpoint.cond->bytes, cond->bytes,
+		      cond->length) != 0)
+	  && set_fast_breakpoint_condition (fb, cond) != 0)
+	fb = NULL;
+      else if (fb->tpoint.handle == NULL)
+	fb->tpoint.handle = set_fast_tracepoint_jump (address, fb->fjump,
+						      fb->fjump_size);
+    }
+
+  if (fb != NULL && fb->tpoint.handle != NULL)
+    {
+      /* The in-process agent needs the register layout to interpret
+	 conditions.  */
+      write_inferior_integer (ipa_sym_addrs.addr_ipa_tdesc_idx,
+			      target_get_ipa_tdesc_idx ());
+
+      if (!breakpoint_here (ipa_sym_addrs.addr_stop_at_fast_breakpoint))
+	set_breakpoint_at (ipa_sym_addrs.addr_stop_at_fast_breakpoint, NULL);
+    }
+
+  target_unpause_all (true);
+
+  if (fb == NULL || fb->tpoint.handle == NULL)
+    return 1;
+
+  trace_debug ("Fast breakpoint at %s inserted, jump pad at %s",
+	       paddress (address), paddress (fb->tpoint.jump_pad));
+  return 0;
+}
+
+/* See tracepoint.h.  */
+
+void
+delete_fast_breakpoint (struct process_info *proc, CORE_ADDR address)
+{
+  struct fast_breakpoint *fb;
+
+  for (fb = proc->fast_breakpoints; fb != NULL; fb = fb->next)
+    if (fb->tpoint.address == address && fb->tpoint.handle != NULL)
+      {
+	target_pause_all (true);
+	delete_fast_tracepoint_jump ((struct fast_tracepoint_jump *)
+				     fb->tpoint.handle);
+	fb->tpoint.handle = NULL;
+	target_unpause_all (true);
+
+	trace_debug ("Fast breakpoint at %s removed", paddress (address));
+	return;
+      }
+}
+
+/* See tracepoint.h.  */
+
+void
+free_fast_breakpoints (struct process_info *proc)
+{
+  while (proc->fast_breakpoints != NULL)
+    {
+      struct fast_breakpoint *fb = proc->fast_breakpoints;
+
+      proc->fast_breakpoints = fb->next;
+      gdb_free_agent_expr (fb->tpoint.cond);
+      free (fb);
+    }
+}
+
+/* See tracepoint.h.  */
+
+void
+clone_fast_breakpoints (struct process_info *child_proc,
+			const struct process_info *parent_proc)
+{
+  const struct fast_breakpoint *fb;
+
+  for (fb = parent_proc->fast_breakpoints; fb != NULL; fb = fb->next)
+    {
+      struct fast_breakpoint *copy = XNEW (struct fast_breakpoint);
+
+      *copy = *fb;
+      copy->tpoint.cond = copy_agent_expr (fb->tpoint.cond);
+      if (fb->tpoint.handle != NULL)
+	copy->tpoint.handle
+	  = clone_fast_tracepoint_jump (child_proc,
+					((const struct fast_tracepoint_jump *)
+					 fb->tpoint.handle));
+      copy->next = child_proc->fast_breakpoints;
+      child_proc->fast_breakpoints = copy;
+    }
+}
+
+/* See tracepoint.h.  */
+
+int
+fast_breakpoint_hit (CORE_ADDR stop_pc)
+{
+  struct process_info *proc = current_process ();
+
+  return (proc != NULL
+	  && proc->fast_breakpoints != NULL
+	  && stop_pc == ipa_sym_addrs.addr_stop_at_fast_breakpoint);
+}
+
 static void
 download_trace_state_variables (void)
 {
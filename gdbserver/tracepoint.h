@@ -156,6 +156,35 @@ void stop_tracing (void);
 int claim_trampoline_space (ULONGEST used, CORE_ADDR *trampoline);
 int have_fast_tracepoint_trampoline_buffer (char *msgbuf);
 void gdb_agent_about_to_close (int pid);
+
+/* Fast breakpoints replace the trap of a conditional GDB breakpoint
+   with a jump to a jump pad, where the in-process agent evaluates
+   the condition, and only stops the thread when it is true.  */
+
+/* Make the INSN_LEN bytes long instruction at ADDRESS jump to a jump
+   pad evaluating COND.  Return 0 if successful, otherwise return
+   non-zero, and the breakpoint should be a trap.  */
+int set_fast_breakpoint (CORE_ADDR address, int insn_len,
+			 const struct agent_expr *cond);
+
+/* Remove the jump of the fast breakpoint at ADDRESS of process PROC,
+   if any.  */
+void delete_fast_breakpoint (struct process_info *proc, CORE_ADDR address);
+
+/* Release the fast breakpoints of PROC, without touching the
+   inferior.  */
+void free_fast_breakpoints (struct process_info *proc);
+
+/* Copy the fast breakpoints of PARENT_PROC to CHILD_PROC, a fork of
+   it, whose memory holds the same jumps and jump pads.  */
+void clone_fast_breakpoints (struct process_info *child_proc,
+			     const struct process_info *parent_proc);
+
+/* Return true if a thread stopped at STOP_PC because the condition of
+   a fast breakpoint was true.  The thread is then within the jump pad
+   of the breakpoint, before the relocated original instruction, as
+   fast_tracepoint_collecting tells.  */
+int fast_breakpoint_hit (CORE_ADDR stop_pc);
 #endif
 
 struct traceframe;
@@ -81,6 +81,8 @@ class future
   future &operator= (future &&other) = default;
   future &operator= (const future &other) = delete;
 
+  bool valid () const { return true; }
+
   void wait () const { }
 
   template<class Rep, class Period>
@@ -103,6 +105,8 @@ template<>
 class future<void>
 {
 public:
+  bool valid () const { return true; }
+
   void wait () const { }
 
   template<class Rep, class Period>
@@ -250,6 +250,8 @@ Archive::setup()
       const char* px = reinterpret_cast<const char*>(p);
       this->extended_names_.assign(px, extended_size);
     }
+  if (this->is_thin_archive_ && parameters->options().prefetch_inputs())
+    this->prefetch_members();
   bool preread_syms = (parameters->options().threads()
                        && parameters->options().preread_archive_symbols());
 #ifndef ENABLE_THREADS
@@ -262,6 +264,43 @@ Archive::setup()
     this->read_all_symbols();
 }
 
+// For --prefetch-inputs, start reading the external members of a
+// thin archive.  The armap gives us the offsets of all the members
+// which define symbols, so we can issue the readahead before we know
+// which of them will be included.
+
+void
+Archive::prefetch_members()
+{
+  off_t last_seen_offset = -1;
+  for (std::vector<Armap_entry>::const_iterator p = this->armap_.begin();
+       p != this->armap_.end();
+       ++p)
+    {
+      if (p->file_offset == last_seen_offset)
+	continue;
+      last_seen_offset = p->file_offset;
+
+      std::string member_name;
+      off_t nested_off;
+      if (this->read_header(p->file_offset, false, &member_name,
+			    &nested_off) < 0
+	  || nested_off > 0)
+	continue;
+
+      if (!IS_ABSOLUTE_PATH(member_name.c_str()))
+	{
+	  const char* arch_path = this->filename().c_str();
+	  const char* basename = lbasename(arch_path);
+	  if (basename > arch_path)
+	    member_name.replace(0, 0,
+				this->filename().substr(0,
+							basename - arch_path));
+	}
+      File_read::prefetch(member_name);
+    }
+}
+
 // Unlock any nested archives.
 
 void
@@ -1005,6 +1044,7 @@ Archive::include_member(Symbol_table* symtab, Layout* layout,
         {
           obj->layout(symtab, layout, sd);
           obj->add_symbols(symtab, sd, layout);
+          obj->discard_decompressed_sections();
 	  this->included_member_ = true;
         }
       delete sd;
@@ -1057,6 +1097,7 @@ Archive::include_member(Symbol_table* symtab, Layout* layout,
     obj->read_symbols(&sd);
     obj->layout(symtab, layout, &sd);
     obj->add_symbols(symtab, &sd, layout);
+    obj->discard_decompressed_sections();
   }
 
   this->included_member_ = true;
@@ -1290,6 +1331,7 @@ Lib_group::include_member(Symbol_table* symtab, Layout* layout,
 						    this, NULL);
       obj->layout(symtab, layout, sd);
       obj->add_symbols(symtab, sd, layout);
+      obj->discard_decompressed_sections();
     }
   delete sd;
   // Unlock the file for the next task.
@@ -292,6 +292,10 @@ class Archive : public Library_base
   get_view(off_t start, section_size_type size, bool aligned, bool cache)
   { return this->input_file_->file().get_view(0, start, size, aligned, cache); }
 
+  // Start reading the external members of a thin archive.
+  void
+  prefetch_members();
+
   // Read the archive symbol map.
   template<int mapsize>
   void
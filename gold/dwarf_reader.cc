@@ -1878,6 +1878,29 @@ Sized_dwarf_line_info<size, big_endian>::Sized_dwarf_line_info(
   // info.
   this->data_valid_ = true;
   this->read_line_mappings(read_shndx);
+  this->release_buffers();
+}
+
+// Free the section contents and relocation information.
+
+template<int size, bool big_endian>
+void
+Sized_dwarf_line_info<size, big_endian>::release_buffers()
+{
+  if (this->buffer_start_ != NULL)
+    delete[] this->buffer_start_;
+  if (this->str_buffer_start_ != NULL)
+    delete[] this->str_buffer_start_;
+  this->buffer_start_ = NULL;
+  this->str_buffer_start_ = NULL;
+  this->buffer_ = this->buffer_end_ = NULL;
+  this->str_buffer_ = this->str_buffer_end_ = NULL;
+  if (this->reloc_mapper_ != NULL)
+    {
+      delete this->reloc_mapper_;
+      this->reloc_mapper_ = NULL;
+    }
+  this->reloc_map_.clear();
 }
 
 // Read the DWARF header.
@@ -2494,12 +2517,49 @@ Sized_dwarf_line_info<size, big_endian>::read_line_mappings(unsigned int shndx)
       this->buffer_ = this->end_of_unit_;
     }
 
-  // Sort the lines numbers, so addr2line can use binary search.
-  for (typename Lineno_map::iterator it = line_number_map_.begin();
-       it != line_number_map_.end();
+  this->build_line_index();
+}
+
+// Sort the line numbers of each section, so addr2line can use binary
+// search, and move them into a single vector.
+
+template<int size, bool big_endian>
+void
+Sized_dwarf_line_info<size, big_endian>::build_line_index()
+{
+  std::vector<unsigned int> shndxs;
+  shndxs.reserve(this->line_number_map_.size());
+  size_t count = 0;
+  for (typename Lineno_map::const_iterator it = this->line_number_map_.begin();
+       it != this->line_number_map_.end();
        ++it)
-    // Each vector needs to be sorted by offset.
-    std::sort(it->second.begin(), it->second.end());
+    {
+      shndxs.push_back(it->first);
+      count += it->second.size();
+    }
+  std::sort(shndxs.begin(), shndxs.end());
+
+  this->line_index_.reserve(count);
+  this->section_lines_.reserve(shndxs.size());
+  for (std::vector<unsigned int>::const_iterator p = shndxs.begin();
+       p != shndxs.end();
+       ++p)
+    {
+      std::vector<Offset_to_lineno_entry>& lines(this->line_number_map_[*p]);
+      Section_lines sl;
+      sl.shndx = *p;
+      sl.begin = this->line_index_.size();
+      // Each vector needs to be sorted by offset.
+      std::sort(lines.begin(), lines.end());
+      this->line_index_.insert(this->line_index_.end(), lines.begin(),
+			       lines.end());
+      sl.end = this->line_index_.size();
+      this->section_lines_.push_back(sl);
+
+      // Free the memory as we go.
+      std::vector<Offset_to_lineno_entry>().swap(lines);
+    }
+  this->line_number_map_.clear();
 }
 
 // Some processing depends on whether the input is a .o file or not.
@@ -2516,14 +2576,15 @@ Sized_dwarf_line_info<size, big_endian>::input_is_relobj()
   return this->symtab_buffer_ != NULL;
 }
 
-// Given an Offset_to_lineno_entry vector, and an offset, figure out
-// if the offset points into a function according to the vector (see
-// comments below for the algorithm).  If it does, return an iterator
-// into the vector that points to the line-number that contains that
-// offset.  If not, it returns vector::end().
+// Given a sorted range of Offset_to_lineno_entry, [BEGIN, END), and
+// an offset, figure out if the offset points into a function
+// according to the range (see comments below for the algorithm).  If
+// it does, return an iterator into the range that points to the
+// line-number that contains that offset.  If not, it returns END.
 
 static std::vector<Offset_to_lineno_entry>::const_iterator
-offset_to_iterator(const std::vector<Offset_to_lineno_entry>* offsets,
+offset_to_iterator(std::vector<Offset_to_lineno_entry>::const_iterator begin,
+		   std::vector<Offset_to_lineno_entry>::const_iterator end,
                    off_t offset)
 {
   const Offset_to_lineno_entry lookup_key = { offset, 0, 0, true, 0 };
@@ -2531,7 +2592,7 @@ offset_to_iterator(const std::vector<Offset_to_lineno_entry>* offsets,
   // lower_bound() returns the smallest offset which is >= lookup_key.
   // If no offset in offsets is >= lookup_key, returns end().
   std::vector<Offset_to_lineno_entry>::const_iterator it
-      = std::lower_bound(offsets->begin(), offsets->end(), lookup_key);
+      = std::lower_bound(begin, end, lookup_key);
 
   // This code is easiest to understand with a concrete example.
   // Here's a possible offsets array:
@@ -2599,30 +2660,30 @@ offset_to_iterator(const std::vector<Offset_to_lineno_entry>* offsets,
   //         we want it to be last.)
 
   // This deals with cases (1) and (2).
-  if ((it == offsets->begin() && offset < it->offset)
-      || it == offsets->end())
-    return offsets->end();
+  if ((it == begin && offset < it->offset)
+      || it == end)
+    return end;
 
   // This deals with cases (3) and (4).
   if (offset == it->offset)
     {
-      while (it != offsets->end()
+      while (it != end
              && it->offset == offset
              && it->line_num == -1)
         ++it;
-      if (it == offsets->end() || it->offset != offset)
-        return offsets->end();
+      if (it == end || it->offset != offset)
+        return end;
       else
         return it;
     }
 
   // This handles the first part of case (7) -- we back up to the
   // *first* entry that has the offset that's behind us.
-  gold_assert(it != offsets->begin());
+  gold_assert(it != begin);
   std::vector<Offset_to_lineno_entry>::const_iterator range_end = it;
   --it;
   const off_t range_value = it->offset;
-  while (it != offsets->begin() && (it-1)->offset == range_value)
+  while (it != begin && (it-1)->offset == range_value)
     --it;
 
   // This handles cases (5), (6), and (7): if any entry in the
@@ -2633,7 +2694,7 @@ offset_to_iterator(const std::vector<Offset_to_lineno_entry>* offsets,
   for (; it != range_end; ++it)
     if (it->line_num != -1)
       return it;
-  return offsets->end();
+  return end;
 }
 
 // Returns the canonical filename:lineno for the address passed in.
@@ -2653,20 +2714,34 @@ Sized_dwarf_line_info<size, big_endian>::do_addr2line(
   if (this->data_valid_ == false)
     return "";
 
-  const std::vector<Offset_to_lineno_entry>* offsets;
   // If we do not have reloc information, then our input is a .so or
   // some similar data structure where all the information is held in
   // the offset.  In that case, we ignore the input shndx.
-  if (this->input_is_relobj())
-    offsets = &this->line_number_map_[shndx];
-  else
-    offsets = &this->line_number_map_[-1U];
-  if (offsets->empty())
+  if (!this->input_is_relobj())
+    shndx = -1U;
+
+  // Find the lines for SHNDX.
+  size_t lo = 0;
+  size_t hi = this->section_lines_.size();
+  while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+      if (this->section_lines_[mid].shndx < shndx)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  if (lo == this->section_lines_.size()
+      || this->section_lines_[lo].shndx != shndx)
     return "";
+  typename std::vector<Offset_to_lineno_entry>::const_iterator begin
+      = this->line_index_.begin() + this->section_lines_[lo].begin;
+  typename std::vector<Offset_to_lineno_entry>::const_iterator end
+      = this->line_index_.begin() + this->section_lines_[lo].end;
 
   typename std::vector<Offset_to_lineno_entry>::const_iterator it
-      = offset_to_iterator(offsets, offset);
-  if (it == offsets->end())
+      = offset_to_iterator(begin, end, offset);
+  if (it == end)
     return "";
 
   std::string result = this->format_file_lineno(*it);
@@ -2678,7 +2753,7 @@ Sized_dwarf_line_info<size, big_endian>::do_addr2line(
       int last_line_num = it->line_num;
       // Return up to 4 more locations from the beginning of the function
       // for fuzzy matching.
-      for (++it; it != offsets->end(); ++it)
+      for (++it; it != end; ++it)
 	{
 	  if (it->offset == offset && it->line_num == -1)
 	    continue;  // The end of a previous function.
@@ -2793,27 +2868,7 @@ Dwarf_line_info::one_addr2line(Object* object,
   // cache.
   if (lineinfo == NULL)
   {
-    switch (parameters->size_and_endianness())
-      {
-#ifdef HAVE_TARGET_32_LITTLE
-        case Parameters::TARGET_32_LITTLE:
-          lineinfo = new Sized_dwarf_line_info<32, false>(object, shndx); break;
-#endif
-#ifdef HAVE_TARGET_32_BIG
-        case Parameters::TARGET_32_BIG:
-          lineinfo = new Sized_dwarf_line_info<32, true>(object, shndx); break;
-#endif
-#ifdef HAVE_TARGET_64_LITTLE
-        case Parameters::TARGET_64_LITTLE:
-          lineinfo = new Sized_dwarf_line_info<64, false>(object, shndx); break;
-#endif
-#ifdef HAVE_TARGET_64_BIG
-        case Parameters::TARGET_64_BIG:
-          lineinfo = new Sized_dwarf_line_info<64, true>(object, shndx); break;
-#endif
-        default:
-          gold_unreachable();
-      }
+    lineinfo = Dwarf_line_info::make_line_info(object, shndx);
     addr2line_cache.push_back(Addr2line_cache_entry(object, shndx, lineinfo));
   }
 
@@ -2858,6 +2913,32 @@ Dwarf_line_info::clear_addr2line_cache()
   addr2line_cache.clear();
 }
 
+Dwarf_line_info*
+Dwarf_line_info::make_line_info(Object* object, unsigned int shndx)
+{
+  switch (parameters->size_and_endianness())
+    {
+#ifdef HAVE_TARGET_32_LITTLE
+      case Parameters::TARGET_32_LITTLE:
+        return new Sized_dwarf_line_info<32, false>(object, shndx);
+#endif
+#ifdef HAVE_TARGET_32_BIG
+      case Parameters::TARGET_32_BIG:
+        return new Sized_dwarf_line_info<32, true>(object, shndx);
+#endif
+#ifdef HAVE_TARGET_64_LITTLE
+      case Parameters::TARGET_64_LITTLE:
+        return new Sized_dwarf_line_info<64, false>(object, shndx);
+#endif
+#ifdef HAVE_TARGET_64_BIG
+      case Parameters::TARGET_64_BIG:
+        return new Sized_dwarf_line_info<64, true>(object, shndx);
+#endif
+      default:
+        gold_unreachable();
+    }
+}
+
 #ifdef HAVE_TARGET_32_LITTLE
 template
 class Sized_dwarf_line_info<32, false>;
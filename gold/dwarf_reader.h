@@ -1024,6 +1024,12 @@ class Dwarf_line_info
   static void
   clear_addr2line_cache();
 
+  // Return a new Sized_dwarf_line_info for OBJECT, of the size and
+  // endianness of the target.  If SHNDX is not -1U, only read the
+  // line information for that section.
+  static Dwarf_line_info*
+  make_line_info(Object* object, unsigned int shndx);
+
  private:
   virtual std::string
   do_addr2line(unsigned int shndx, off_t offset,
@@ -1041,18 +1047,22 @@ class Sized_dwarf_line_info : public Dwarf_line_info
 
   virtual
   ~Sized_dwarf_line_info()
-  {
-    if (this->buffer_start_ != NULL)
-      delete[] this->buffer_start_;
-    if (this->str_buffer_start_ != NULL)
-      delete[] this->str_buffer_start_;
-  }
+  { this->release_buffers(); }
 
  private:
   std::string
   do_addr2line(unsigned int shndx, off_t offset,
                std::vector<std::string>* other_lines);
 
+  // Free the section contents and relocation information, which are
+  // not needed once the line index has been built.
+  void
+  release_buffers();
+
+  // Move the entries of line_number_map_ into line_index_.
+  void
+  build_line_index();
+
   // Formats a file and line number to a string like "dirname/filename:lineno".
   std::string
   format_file_lineno(const Offset_to_lineno_entry& lineno) const;
@@ -1172,10 +1182,28 @@ class Sized_dwarf_line_info : public Dwarf_line_info
   Reloc_map reloc_map_;
 
   // We have a vector of offset->lineno entries for every input section.
+  // This is only used while reading the line information.
   typedef Unordered_map<unsigned int, std::vector<Offset_to_lineno_entry> >
   Lineno_map;
 
   Lineno_map line_number_map_;
+
+  // The range of line_index_ which holds the entries for one input
+  // section.
+  struct Section_lines
+  {
+    unsigned int shndx;
+    size_t begin;
+    size_t end;
+  };
+
+  // Once the line information has been read, the entries for all the
+  // input sections, each range sorted by offset, so that addr2line
+  // can use binary search.  This is not changed by addr2line, so it
+  // may be used by several threads at once.
+  std::vector<Offset_to_lineno_entry> line_index_;
+  // The ranges of line_index_, sorted by section index.
+  std::vector<Section_lines> section_lines_;
 };
 
 } // End namespace gold.
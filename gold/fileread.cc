@@ -124,7 +124,11 @@ static Initialize_lock file_counts_initialize_lock(&file_counts_lock);
 unsigned long long File_read::total_mapped_bytes;
 unsigned long long File_read::current_mapped_bytes;
 unsigned long long File_read::maximum_mapped_bytes;
+unsigned long long File_read::total_copied_bytes;
 std::vector<std::string> File_read::files_read;
+File_read::Prefetched_files File_read::prefetched_files;
+unsigned int File_read::prefetch_hits;
+unsigned int File_read::prefetch_stalls;
 
 // Class File_read::View.
 
@@ -215,6 +219,16 @@ File_read::open(const Task* task, const std::string& name)
       file_counts_initialize_lock.initialize();
       Hold_optional_lock hl(file_counts_lock);
       record_file_read(this->name_);
+      if (parameters->options_valid()
+	  && parameters->options().prefetch_inputs())
+	{
+	  Prefetched_files::const_iterator p =
+	    File_read::prefetched_files.find(this->name_);
+	  if (p != File_read::prefetched_files.end() && p->second)
+	    ++File_read::prefetch_hits;
+	  else
+	    ++File_read::prefetch_stalls;
+	}
     }
 
   return this->descriptor_ >= 0;
@@ -271,9 +285,11 @@ File_read::release()
       File_read::current_mapped_bytes += this->mapped_bytes_;
       if (File_read::current_mapped_bytes > File_read::maximum_mapped_bytes)
 	File_read::maximum_mapped_bytes = File_read::current_mapped_bytes;
+      File_read::total_copied_bytes += this->copied_bytes_;
     }
 
   this->mapped_bytes_ = 0;
+  this->copied_bytes_ = 0;
 
   // Only clear views if there is only one attached object.  Otherwise
   // we waste time trying to clear cached archive views.  Similarly
@@ -857,6 +873,48 @@ File_read::clear_views(Clear_views_mode mode)
     }
 }
 
+// Copy data from the file to the output file using copy_file_range,
+// so that the kernel does the copy.  This avoids touching the data in
+// user space, and on file systems which support it the data blocks
+// may simply be shared with the input file.
+
+bool
+File_read::copy_to_file(off_t start, section_size_type size,
+			int output_descriptor, off_t output_offset)
+{
+#ifdef HAVE_COPY_FILE_RANGE
+  // There is no file to copy from if the contents were given in
+  // memory.
+  if (this->whole_file_view_ != NULL
+      && this->whole_file_view_->is_permanent_view())
+    return false;
+
+  this->reopen_descriptor();
+
+  off_t in_pos = start;
+  off_t out_pos = output_offset;
+  size_t to_copy = size;
+  while (to_copy > 0)
+    {
+      ssize_t bytes = ::copy_file_range(this->descriptor_, &in_pos,
+					output_descriptor, &out_pos,
+					to_copy, 0);
+      // On an error, such as a kernel or file system which does not
+      // support copy_file_range, or at the end of the file, let the
+      // caller read the data instead, which will report any real
+      // error.
+      if (bytes <= 0)
+	return false;
+      to_copy -= bytes;
+    }
+
+  this->copied_bytes_ += size;
+  return true;
+#else
+  return false;
+#endif
+}
+
 // Print statistical information to stderr.  This is used for --stats.
 
 void
@@ -866,6 +924,17 @@ File_read::print_stats()
 	  program_name, File_read::total_mapped_bytes);
   fprintf(stderr, _("%s: maximum bytes mapped for read at one time: %llu\n"),
 	  program_name, File_read::maximum_mapped_bytes);
+  fprintf(stderr, _("%s: total bytes copied by the kernel: %llu\n"),
+	  program_name, File_read::total_copied_bytes);
+  if (parameters->options_valid() && parameters->options().prefetch_inputs())
+    {
+      fprintf(stderr, _("%s: input files prefetched: %zu\n"),
+	      program_name, File_read::prefetched_files.size());
+      fprintf(stderr, _("%s: input file prefetch hits: %u\n"),
+	      program_name, File_read::prefetch_hits);
+      fprintf(stderr, _("%s: input file prefetch stalls: %u\n"),
+	      program_name, File_read::prefetch_stalls);
+    }
 }
 
 // Class File_view.
@@ -1154,6 +1223,35 @@ File_read::record_file_read(const std::string& name)
   File_read::files_read.push_back(name);
 }
 
+// Issue readahead for the file NAME.  We do not go through the
+// descriptor cache here, since the descriptor is only needed long
+// enough to hand the request to the kernel.
+
+void
+File_read::prefetch(const std::string& name)
+{
+  {
+    file_counts_initialize_lock.initialize();
+    Hold_optional_lock hl(file_counts_lock);
+    if (!File_read::prefetched_files.insert(std::make_pair(name,
+							    false)).second)
+      return;
+  }
+
+  int o = ::open(name.c_str(), O_RDONLY);
+  if (o < 0)
+    return;
+#ifdef POSIX_FADV_WILLNEED
+  ::posix_fadvise(o, 0, 0, POSIX_FADV_WILLNEED);
+#endif
+  ::close(o);
+
+  gold_debug(DEBUG_FILES, "Prefetched \"%s\"", name.c_str());
+
+  Hold_optional_lock hl(file_counts_lock);
+  File_read::prefetched_files[name] = true;
+}
+
 void
 File_read::write_dependency_file(const char* dependency_file_name,
 				 const char* output_file_name)
@@ -72,7 +72,7 @@ class File_read
   File_read()
     : name_(), descriptor_(-1), is_descriptor_opened_(false), object_count_(0),
       size_(0), token_(false), views_(), saved_views_(), mapped_bytes_(0),
-      released_(true), whole_file_view_(NULL)
+      copied_bytes_(0), released_(true), whole_file_view_(NULL)
   { }
 
   ~File_read();
@@ -203,6 +203,18 @@ class File_read
   void
   read_multiple(off_t base, const Read_multiple&);
 
+  // Ask the kernel to copy SIZE bytes starting at file offset START
+  // to OUTPUT_OFFSET in the file open as OUTPUT_DESCRIPTOR, without
+  // reading them into memory.  This returns false if the copy could
+  // not be done, in which case the caller must read the data itself.
+  bool
+  copy_to_file(off_t start, section_size_type size, int output_descriptor,
+	       off_t output_offset);
+
+  // The smallest amount of data for which copy_to_file is worth the
+  // system call.
+  static const section_size_type min_copy_size = 16 * 1024;
+
   // Dump statistical information to stderr.
   static void
   print_stats();
@@ -216,6 +228,13 @@ class File_read
   static void
   record_file_read(const std::string& name);
 
+  // Ask the operating system to start reading the file NAME into the
+  // page cache, so that a later open and read of the file does not
+  // stall.  This is used for --prefetch-inputs.  It does nothing if
+  // the file was already prefetched or can not be opened.
+  static void
+  prefetch(const std::string& name);
+
   // Return the open file descriptor (for plugins).
   int
   descriptor()
@@ -256,9 +275,25 @@ class File_read
   // --stats.
   static unsigned long long maximum_mapped_bytes;
 
+  // Total bytes copied by copy_to_file during the link if --stats.
+  static unsigned long long total_copied_bytes;
+
   // Set of names of all files read.
   static std::vector<std::string> files_read;
 
+  // Files for which we have requested a prefetch.  The value is true
+  // once the readahead has been issued.
+  typedef Unordered_map<std::string, bool> Prefetched_files;
+  static Prefetched_files prefetched_files;
+
+  // Number of files opened after their prefetch was issued, if
+  // --prefetch-inputs.
+  static unsigned int prefetch_hits;
+
+  // Number of files opened before their prefetch was issued, if
+  // --prefetch-inputs.
+  static unsigned int prefetch_stalls;
+
   // A view into the file.
   class View
   {
@@ -446,6 +481,9 @@ class File_read
   // while the file is locked.  When we unlock the file, we transfer
   // the total to total_mapped_bytes, and reset this to zero.
   size_t mapped_bytes_;
+  // Bytes copied by copy_to_file.  This is transferred to
+  // total_copied_bytes when we release the file, like mapped_bytes_.
+  size_t copied_bytes_;
   // Whether the file was released.
   bool released_;
   // A view containing the whole file.  May be NULL if we mmap only
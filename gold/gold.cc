@@ -223,6 +223,11 @@ queue_initial_tasks(const General_options& options,
 	}
     }
 
+  // Start reading the input files in the background, ahead of the
+  // Read_symbols tasks which will need them.
+  if (options.prefetch_inputs() && ibase == NULL)
+    workqueue->queue(new Prefetch_inputs(&search_path, &cmdline));
+
   // Read the input files.  We have to add the symbols to the symbol
   // table in order.  We do this by creating a separate blocker for
   // each input file.  We associate the blocker with the following
@@ -577,6 +582,11 @@ queue_middle_tasks(const General_options& options,
 	(*p)->update_section_layout(layout->get_section_order_map());
     }
 
+  // Order the sections which define the functions in the call graph
+  // profile.
+  if (parameters->options().call_graph_ordering_file())
+    layout->order_sections_by_call_graph(symtab);
+
   if (parameters->options().gc_sections()
       || parameters->options().icf_enabled())
     {
@@ -836,6 +846,12 @@ queue_final_tasks(const General_options& options,
   if (!any_postprocessing_sections)
     final_blocker->add_blocker();
 
+  // See if any of the input definitions violate the One Definition
+  // Rule.  This queues tasks which read the debugging information of
+  // the objects in parallel with the rest of the output.
+  symtab->detect_odr_violations(workqueue, options.output_file_name(),
+				final_blocker);
+
   // Queue a task to write out the symbol table.
   workqueue->queue(new Write_symbols_task(layout,
 					  symtab,
@@ -27,6 +27,7 @@
 #include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <utility>
 #include <fcntl.h>
 #include <fnmatch.h>
@@ -370,10 +371,6 @@ Layout::Relaxation_debug_check::verify_sections(
 void
 Layout_task_runner::run(Workqueue* workqueue, const Task* task)
 {
-  // See if any of the input definitions violate the One Definition Rule.
-  // TODO: if this is too slow, do this as a task, rather than inline.
-  this->symtab_->detect_odr_violations(task, this->options_.output_file_name());
-
   Layout* layout = this->layout_;
   off_t file_size = layout->finalize(this->input_objects_,
 				     this->symtab_,
@@ -384,10 +381,7 @@ Layout_task_runner::run(Workqueue* workqueue, const Task* task)
   // each piece of information goes.
 
   if (this->mapfile_ != NULL)
-    {
-      this->mapfile_->print_discarded_sections(this->input_objects_);
-      layout->print_to_mapfile(this->mapfile_);
-    }
+    this->mapfile_->queue_tasks(workqueue, this->input_objects_, layout);
 
   Output_file* of;
   if (layout->incremental_base() == NULL)
@@ -477,6 +471,7 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     section_segment_map_(),
     input_section_position_(),
     input_section_glob_(),
+    call_graph_edges_(),
     incremental_base_(NULL),
     free_list_(),
     gnu_properties_()
@@ -2955,6 +2950,301 @@ Layout::read_layout_from_file()
     }
 }
 
+// Read the call graph profile from the file specified with option
+// --call-graph-ordering-file.  Each line of the file names a caller,
+// a callee and the number of calls, separated by white space, as
+// found in the edge counts produced by profiling tools.  Edges with a
+// count of zero are kept: they name functions which were never called.
+
+void
+Layout::read_call_graph_from_file()
+{
+  const char* filename = parameters->options().call_graph_ordering_file();
+  std::ifstream in;
+  std::string line;
+
+  in.open(filename);
+  if (!in)
+    gold_fatal(_("unable to open --call-graph-ordering-file file %s: %s"),
+	       filename, strerror(errno));
+
+  File_read::record_file_read(filename);
+
+  unsigned int lineno = 0;
+  while (std::getline(in, line))
+    {
+      ++lineno;
+      // Ignore blank lines and comments, beginning with '#'.
+      size_t start = line.find_first_not_of(" \t\r");
+      if (start == std::string::npos || line[start] == '#')
+	continue;
+
+      std::istringstream fields(line);
+      std::string caller;
+      std::string callee;
+      uint64_t weight;
+      std::string extra;
+      if (!(fields >> caller >> callee >> weight) || (fields >> extra))
+	{
+	  gold_error(_("%s:%u: expected a caller, a callee and a count"),
+		     filename, lineno);
+	  continue;
+	}
+      this->call_graph_edges_.push_back(Call_graph_edge(caller, callee,
+							weight));
+    }
+}
+
+// A cluster of input sections built by Layout::order_sections_by_call_graph.
+// Every input section starts out in a cluster of its own.
+
+struct Call_graph_cluster
+{
+  Call_graph_cluster(unsigned int index, uint64_t size_arg)
+    : size(size_arg == 0 ? 1 : size_arg), weight(0), initial_weight(0),
+      best_pred(-1U), best_pred_weight(0), is_hot(false),
+      sections(1, index)
+  { }
+
+  // The number of calls into this cluster per byte.
+  double
+  density() const
+  { return static_cast<double>(this->weight) / this->size; }
+
+  // The total size of the cluster.
+  uint64_t size;
+  // The number of calls into the cluster.
+  uint64_t weight;
+  // The number of calls into the section which started the cluster.
+  uint64_t initial_weight;
+  // The most frequent caller of the section which started the cluster.
+  unsigned int best_pred;
+  // The number of calls from BEST_PRED.
+  uint64_t best_pred_weight;
+  // Whether the profile shows a call from or into the section.
+  bool is_hot;
+  // The sections in the cluster, in order.
+  std::vector<unsigned int> sections;
+};
+
+// Sort clusters by decreasing density.
+
+class Call_graph_cluster_compare
+{
+ public:
+  Call_graph_cluster_compare(const std::vector<Call_graph_cluster>& clusters)
+    : clusters_(clusters)
+  { }
+
+  bool
+  operator()(unsigned int i1, unsigned int i2) const
+  { return this->clusters_[i1].density() > this->clusters_[i2].density(); }
+
+ private:
+  const std::vector<Call_graph_cluster>& clusters_;
+};
+
+// Return the size of the function SYM.
+
+template<int size>
+static uint64_t
+call_graph_symbol_size(const Symbol* sym)
+{
+  return static_cast<const Sized_symbol<size>*>(sym)->symsize();
+}
+
+// Find the cluster which now holds the section which started cluster
+// INDEX.
+
+static unsigned int
+call_graph_leader(std::vector<unsigned int>* leaders, unsigned int index)
+{
+  while ((*leaders)[index] != index)
+    {
+      (*leaders)[index] = (*leaders)[(*leaders)[index]];
+      index = (*leaders)[index];
+    }
+  return index;
+}
+
+// Order the input sections which define the functions named in the
+// call graph profile.  This uses the C3 heuristic (Ottoni and Maher,
+// "Optimizing function placement for large-scale data-center
+// applications"): each function is appended to the cluster of its
+// most frequent caller, as long as that does not make the cluster too
+// large or too sparse, and the clusters are then laid out by
+// decreasing density of calls.  The resulting sections are placed
+// with the .text.hot sections.  Sections whose functions appear in the
+// profile only with zero counts were never executed, and are placed
+// with the .text.unlikely sections.  Sections which are not in the
+// profile at all are left with the ordinary code.
+
+void
+Layout::order_sections_by_call_graph(const Symbol_table* symtab)
+{
+  // The largest cluster we build; there is no point in grouping code
+  // which will not share pages anyway.
+  const uint64_t max_cluster_size = 1024 * 1024;
+  // We refuse merges which make a cluster this much sparser.
+  const uint64_t max_density_degradation = 8;
+
+  // Map each function to the input section which defines it.  A
+  // section which defines several functions is sized by the largest.
+  typedef Unordered_map<Section_id, unsigned int, Section_id_hash> Node_map;
+  Node_map nodes;
+  std::vector<Section_id> sections;
+  std::vector<Call_graph_cluster> clusters;
+  Unordered_map<std::string, unsigned int> function_nodes;
+  const int size = parameters->target().get_size();
+  for (std::vector<Call_graph_edge>::const_iterator p =
+	 this->call_graph_edges_.begin();
+       p != this->call_graph_edges_.end();
+       ++p)
+    {
+      const std::string* names[2] = { &p->caller, &p->callee };
+      for (int i = 0; i < 2; ++i)
+	{
+	  if (function_nodes.find(*names[i]) != function_nodes.end())
+	    continue;
+	  function_nodes[*names[i]] = -1U;
+
+	  const Symbol* sym = symtab->lookup(names[i]->c_str());
+	  if (sym == NULL
+	      || sym->source() != Symbol::FROM_OBJECT
+	      || !sym->is_defined()
+	      || sym->is_from_dynobj()
+	      || sym->is_placeholder()
+	      || sym->object()->pluginobj() != NULL)
+	    continue;
+	  bool is_ordinary;
+	  unsigned int shndx = sym->shndx(&is_ordinary);
+	  if (!is_ordinary)
+	    continue;
+
+	  uint64_t symsize = (size == 32
+			      ? call_graph_symbol_size<32>(sym)
+			      : call_graph_symbol_size<64>(sym));
+	  Section_id secid(static_cast<Relobj*>(sym->object()), shndx);
+	  std::pair<Node_map::iterator, bool> ins =
+	    nodes.insert(std::make_pair(secid, clusters.size()));
+	  if (ins.second)
+	    {
+	      sections.push_back(secid);
+	      clusters.push_back(Call_graph_cluster(ins.first->second,
+						    symsize));
+	    }
+	  else if (symsize > clusters[ins.first->second].size)
+	    clusters[ins.first->second].size = symsize;
+	  function_nodes[*names[i]] = ins.first->second;
+	}
+    }
+
+  // Record the calls into each section and its most frequent caller.
+  // Calls between functions in the same section are not interesting,
+  // except to show that the section is hot.  The same pair of sections
+  // may appear more than once.
+  std::map<std::pair<unsigned int, unsigned int>, uint64_t> edges;
+  for (std::vector<Call_graph_edge>::const_iterator p =
+	 this->call_graph_edges_.begin();
+       p != this->call_graph_edges_.end();
+       ++p)
+    {
+      if (p->weight == 0)
+	continue;
+      unsigned int from = function_nodes[p->caller];
+      unsigned int to = function_nodes[p->callee];
+      if (from != -1U)
+	clusters[from].is_hot = true;
+      if (to != -1U)
+	clusters[to].is_hot = true;
+      if (from == -1U || to == -1U || from == to)
+	continue;
+      uint64_t weight = (edges[std::make_pair(from, to)] += p->weight);
+      Call_graph_cluster& c(clusters[to]);
+      c.weight += p->weight;
+      if (c.best_pred == -1U || c.best_pred_weight < weight)
+	{
+	  c.best_pred = from;
+	  c.best_pred_weight = weight;
+	}
+    }
+
+  std::vector<unsigned int> leaders(clusters.size());
+  std::vector<unsigned int> sorted(clusters.size());
+  for (unsigned int i = 0; i < clusters.size(); ++i)
+    {
+      clusters[i].initial_weight = clusters[i].weight;
+      leaders[i] = i;
+      sorted[i] = i;
+    }
+
+  // Visit the sections in decreasing order of density, and append each
+  // one to the cluster of its most frequent caller.
+  std::stable_sort(sorted.begin(), sorted.end(),
+		   Call_graph_cluster_compare(clusters));
+  for (std::vector<unsigned int>::const_iterator p = sorted.begin();
+       p != sorted.end();
+       ++p)
+    {
+      Call_graph_cluster& c(clusters[*p]);
+
+      // Don't bother when the most frequent caller accounts for only a
+      // small fraction of the calls.
+      if (c.best_pred == -1U || c.best_pred_weight * 10 <= c.initial_weight)
+	continue;
+
+      unsigned int pred_leader = call_graph_leader(&leaders, c.best_pred);
+      if (pred_leader == *p)
+	continue;
+
+      Call_graph_cluster& pred(clusters[pred_leader]);
+      if (c.size + pred.size > max_cluster_size)
+	continue;
+      double new_density = (static_cast<double>(c.weight + pred.weight)
+			    / (c.size + pred.size));
+      if (new_density * max_density_degradation < pred.density())
+	continue;
+
+      leaders[*p] = pred_leader;
+      pred.size += c.size;
+      pred.weight += c.weight;
+      pred.sections.insert(pred.sections.end(), c.sections.begin(),
+			   c.sections.end());
+      c.sections.clear();
+    }
+
+  // Lay out the remaining hot clusters by decreasing density.  A cold
+  // section is never merged, since it has no callers.
+  Output_section::Section_layout_order order_map;
+  sorted.clear();
+  for (unsigned int i = 0; i < clusters.size(); ++i)
+    {
+      if (!clusters[i].is_hot)
+	order_map[sections[i]] = Output_section::cold_section_order_index;
+      else if (leaders[i] == i)
+	sorted.push_back(i);
+    }
+  std::stable_sort(sorted.begin(), sorted.end(),
+		   Call_graph_cluster_compare(clusters));
+
+  unsigned int position = 1;
+  for (std::vector<unsigned int>::const_iterator p = sorted.begin();
+       p != sorted.end();
+       ++p)
+    {
+      const std::vector<unsigned int>& members(clusters[*p].sections);
+      for (std::vector<unsigned int>::const_iterator q = members.begin();
+	   q != members.end();
+	   ++q)
+	order_map[sections[*q]] = position++;
+    }
+
+  for (Section_list::const_iterator p = this->section_list_.begin();
+       p != this->section_list_.end();
+       ++p)
+    (*p)->update_section_layout(&order_map);
+}
+
 // Finalize the layout.  When this is called, we have created all the
 // output sections and all the output segments which are based on
 // input sections.  We have several things to do, and we have to do
@@ -6042,19 +6332,19 @@ Layout::write_binary(Output_file* in) const
   out.close();
 }
 
-// Print the output sections to the map file.
+// Collect the Output_data which appear in the map file, in order.
 
 void
-Layout::print_to_mapfile(Mapfile* mapfile) const
+Layout::get_mapfile_order(std::vector<const Output_data*>* pods) const
 {
   for (Segment_list::const_iterator p = this->segment_list_.begin();
        p != this->segment_list_.end();
        ++p)
-    (*p)->print_sections_to_mapfile(mapfile);
+    (*p)->get_mapfile_order(pods);
   for (Section_list::const_iterator p = this->unattached_section_list_.begin();
        p != this->unattached_section_list_.end();
        ++p)
-    (*p)->print_to_mapfile(mapfile);
+    pods->push_back(*p);
 }
 
 // Print statistical information to stderr.  This is used for --stats.
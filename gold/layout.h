@@ -620,6 +620,16 @@ class Layout
   void
   read_layout_from_file();
 
+  // Read the call graph profile from the file specified with linker
+  // option --call-graph-ordering-file.
+  void
+  read_call_graph_from_file();
+
+  // Order the input sections which define the functions named in the
+  // call graph profile.  This is called after symbol resolution.
+  void
+  order_sections_by_call_graph(const Symbol_table*);
+
   // Layout an input reloc section when doing a relocatable link.  The
   // section is RELOC_SHNDX in OBJECT, with data in SHDR.
   // DATA_SECTION is the reloc section to which it refers.  RR is the
@@ -965,9 +975,9 @@ class Layout
   void
   write_binary(Output_file* in) const;
 
-  // Print output sections to the map file.
+  // Collect the Output_data to print to the map file, in order.
   void
-  print_to_mapfile(Mapfile*) const;
+  get_mapfile_order(std::vector<const Output_data*>*) const;
 
   // Dump statistical information to stderr.
   void
@@ -1520,6 +1530,20 @@ class Layout
   Unordered_map<std::string, unsigned int> input_section_position_;
   // Vector of glob only patterns in the section_ordering file.
   std::vector<std::string> input_section_glob_;
+  // An edge of the call graph read from --call-graph-ordering-file.
+  struct Call_graph_edge
+  {
+    Call_graph_edge(const std::string& caller_arg,
+		    const std::string& callee_arg, uint64_t weight_arg)
+      : caller(caller_arg), callee(callee_arg), weight(weight_arg)
+    { }
+
+    std::string caller;
+    std::string callee;
+    uint64_t weight;
+  };
+  // The call graph read from --call-graph-ordering-file.
+  std::vector<Call_graph_edge> call_graph_edges_;
   // For incremental links, the base file to be modified.
   Incremental_binary* incremental_base_;
   // For incremental links, a list of free space within the file.
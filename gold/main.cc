@@ -29,6 +29,10 @@
 #include <malloc.h>
 #endif
 
+#ifdef HAVE_GETRUSAGE
+#include <sys/resource.h>
+#endif
+
 #include "libiberty.h"
 
 #include "script.h"
@@ -43,6 +47,7 @@
 #include "archive.h"
 #include "symtab.h"
 #include "layout.h"
+#include "reloc.h"
 #include "plugin.h"
 #include "gc.h"
 #include "icf.h"
@@ -234,6 +239,8 @@ main(int argc, char** argv)
 
   if (parameters->options().section_ordering_file())
     layout.read_layout_from_file();
+  else if (parameters->options().call_graph_ordering_file())
+    layout.read_call_graph_from_file();
 
   // Load plugin libraries.
   if (command_line.options().has_plugins())
@@ -300,7 +307,16 @@ main(int argc, char** argv)
 	      program_name, static_cast<long long>(m.arena));
 #endif
 
+#ifdef HAVE_GETRUSAGE
+      struct rusage ru;
+      if (getrusage(RUSAGE_SELF, &ru) == 0)
+	fprintf(stderr, _("%s: maximum resident set size: %ld kilobytes\n"),
+		program_name, static_cast<long>(ru.ru_maxrss));
+#endif
+
       File_read::print_stats();
+      Read_relocs::print_stats();
+      Object::print_stats();
       Archive::print_stats();
       Lib_group::print_stats();
       fprintf(stderr, _("%s: output file size: %lld bytes\n"),
@@ -318,7 +334,9 @@ main(int argc, char** argv)
   // Output cross reference table.
   if (command_line.options().cref())
     input_objects.print_cref(&symtab,
-			     mapfile == NULL ? stdout : mapfile->file());
+			     (mapfile == NULL || mapfile->is_json()
+			      ? stdout
+			      : mapfile->file()));
 
   if (mapfile != NULL)
     mapfile->close();
@@ -22,13 +22,17 @@
 
 #include "gold.h"
 
+#include <algorithm>
 #include <cerrno>
+#include <cstdarg>
 #include <cstdio>
 #include <cstring>
 
 #include "archive.h"
 #include "symtab.h"
 #include "output.h"
+#include "layout.h"
+#include "workqueue.h"
 #include "mapfile.h"
 
 // This file holds the code for printing information to the map file.
@@ -41,9 +45,44 @@ namespace gold
 
 Mapfile::Mapfile()
   : map_file_(NULL),
+    buffer_(NULL),
+    parent_(NULL),
+    is_json_(false),
+    json_list_(NULL),
+    json_list_empty_(true),
+    json_section_empty_(true),
+    in_output_section_(false),
     printed_archive_header_(false),
     printed_common_header_(false),
-    printed_memory_map_header_(false)
+    printed_memory_map_header_(false),
+    objects_(),
+    object_index_(),
+    object_text_(),
+    memory_map_(),
+    memory_map_text_()
+{
+}
+
+// Constructor for a Mapfile which formats a piece of the map into a
+// buffer.  The headers are printed by the parent.
+
+Mapfile::Mapfile(const Mapfile* parent, std::string* buffer)
+  : map_file_(NULL),
+    buffer_(buffer),
+    parent_(parent),
+    is_json_(parent->is_json_),
+    json_list_(NULL),
+    json_list_empty_(true),
+    json_section_empty_(true),
+    in_output_section_(false),
+    printed_archive_header_(true),
+    printed_common_header_(true),
+    printed_memory_map_header_(true),
+    objects_(),
+    object_index_(),
+    object_text_(),
+    memory_map_(),
+    memory_map_text_()
 {
 }
 
@@ -72,6 +111,11 @@ Mapfile::open(const char* map_filename)
 	  return false;
 	}
     }
+
+  this->is_json_ = strcmp(parameters->options().map_format(), "json") == 0;
+  if (this->is_json_)
+    this->output("{");
+
   return true;
 }
 
@@ -80,11 +124,110 @@ Mapfile::open(const char* map_filename)
 void
 Mapfile::close()
 {
+  if (this->is_json_)
+    {
+      if (this->json_list_ != NULL)
+	this->output("\n  ]");
+      this->output("\n}\n");
+    }
+
   if (fclose(this->map_file_) != 0)
     gold_error(_("cannot close map file: %s"), strerror(errno));
   this->map_file_ = NULL;
 }
 
+// Write a formatted string.
+
+void
+Mapfile::output(const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  if (this->buffer_ == NULL)
+    vfprintf(this->map_file_, format, args);
+  else
+    {
+      va_list args2;
+      va_copy(args2, args);
+      char buf[256];
+      int len = vsnprintf(buf, sizeof buf, format, args);
+      if (len < 0)
+	gold_unreachable();
+      else if (static_cast<size_t>(len) < sizeof buf)
+	this->buffer_->append(buf, len);
+      else
+	{
+	  size_t start = this->buffer_->size();
+	  this->buffer_->resize(start + len + 1);
+	  vsnprintf(&(*this->buffer_)[start], len + 1, format, args2);
+	  this->buffer_->resize(start + len);
+	}
+      va_end(args2);
+    }
+  va_end(args);
+}
+
+// Write a character.
+
+void
+Mapfile::output_char(char c)
+{
+  if (this->buffer_ == NULL)
+    putc(c, this->map_file_);
+  else
+    this->buffer_->push_back(c);
+}
+
+// Write a JSON string.
+
+void
+Mapfile::output_json_string(const char* s)
+{
+  this->output_char('"');
+  for (; *s != '\0'; ++s)
+    {
+      unsigned char c = *s;
+      if (c == '"' || c == '\\')
+	{
+	  this->output_char('\\');
+	  this->output_char(c);
+	}
+      else if (c < 0x20)
+	this->output("\\u%04x", c);
+      else
+	this->output_char(c);
+    }
+  this->output_char('"');
+}
+
+// Start a new element of the top-level JSON list NAME.
+
+void
+Mapfile::start_json_element(const char* name)
+{
+  if (this->json_list_ == NULL || strcmp(this->json_list_, name) != 0)
+    {
+      if (this->json_list_ != NULL)
+	this->output("\n  ],");
+      this->output("\n  \"%s\": [\n", name);
+      this->json_list_ = name;
+      this->json_list_empty_ = true;
+    }
+  if (!this->json_list_empty_)
+    this->output(",\n");
+  this->json_list_empty_ = false;
+}
+
+// Start a new element of the list of inputs of an output section.
+
+void
+Mapfile::start_json_section_element()
+{
+  if (!this->json_section_empty_)
+    this->output(",\n");
+  this->json_section_empty_ = false;
+}
+
 // Advance to a column.
 
 void
@@ -92,12 +235,12 @@ Mapfile::advance_to_column(size_t from, size_t to)
 {
   if (from >= to - 1)
     {
-      putc('\n', this->map_file_);
+      this->output_char('\n');
       from = 0;
     }
   while (from < to)
     {
-      putc(' ', this->map_file_);
+      this->output_char(' ');
       ++from;
     }
 }
@@ -108,31 +251,57 @@ void
 Mapfile::report_include_archive_member(const std::string& member_name,
 				       const Symbol* sym, const char* why)
 {
+  if (this->is_json_)
+    {
+      this->start_json_element("archive_members");
+      this->output("    {\"member\": ");
+      this->output_json_string(member_name.c_str());
+      if (sym == NULL)
+	{
+	  this->output(", \"reason\": ");
+	  this->output_json_string(why);
+	}
+      else
+	{
+	  this->output(", \"file\": ");
+	  if (sym->source() == Symbol::FROM_OBJECT)
+	    this->output_json_string(sym->object()->name().c_str());
+	  else
+	    {
+	      gold_assert(sym->source() == Symbol::IS_UNDEFINED);
+	      this->output_json_string("-u");
+	    }
+	  this->output(", \"symbol\": ");
+	  this->output_json_string(sym->name());
+	}
+      this->output("}");
+      return;
+    }
+
   // We print a header before the list of archive members, mainly for
   // GNU ld compatibility.
   if (!this->printed_archive_header_)
     {
-      fprintf(this->map_file_,
-	      _("Archive member included because of file (symbol)\n\n"));
+      this->output(_("Archive member included because of file (symbol)\n\n"));
       this->printed_archive_header_ = true;
     }
 
-  fprintf(this->map_file_, "%s", member_name.c_str());
+  this->output("%s", member_name.c_str());
 
   this->advance_to_column(member_name.length(), 30);
 
   if (sym == NULL)
-    fprintf(this->map_file_, "%s", why);
+    this->output("%s", why);
   else
     {
       switch (sym->source())
 	{
 	case Symbol::FROM_OBJECT:
-	  fprintf(this->map_file_, "%s", sym->object()->name().c_str());
+	  this->output("%s", sym->object()->name().c_str());
 	  break;
 
 	case Symbol::IS_UNDEFINED:
-	  fprintf(this->map_file_, "-u");
+	  this->output("-u");
 	  break;
 
 	default:
@@ -143,10 +312,10 @@ Mapfile::report_include_archive_member(const std::string& member_name,
 	  gold_unreachable();
 	}
 
-      fprintf(this->map_file_, " (%s)", sym->name());
+      this->output(" (%s)", sym->name());
     }
 
-  putc('\n', this->map_file_);
+  this->output_char('\n');
 }
 
 // Report allocating a common symbol.
@@ -154,31 +323,43 @@ Mapfile::report_include_archive_member(const std::string& member_name,
 void
 Mapfile::report_allocate_common(const Symbol* sym, uint64_t symsize)
 {
+  std::string demangled_name = sym->demangled_name();
+
+  if (this->is_json_)
+    {
+      this->start_json_element("common_symbols");
+      this->output("    {\"name\": ");
+      this->output_json_string(demangled_name.c_str());
+      this->output(", \"size\": \"0x%llx\", \"file\": ",
+		   static_cast<unsigned long long>(symsize));
+      this->output_json_string(sym->object()->name().c_str());
+      this->output("}");
+      return;
+    }
+
   if (!this->printed_common_header_)
     {
-      fprintf(this->map_file_, _("\nAllocating common symbols\n"));
-      fprintf(this->map_file_,
-	      _("Common symbol       size              file\n\n"));
+      this->output(_("\nAllocating common symbols\n"));
+      this->output(_("Common symbol       size              file\n\n"));
       this->printed_common_header_ = true;
     }
 
-  std::string demangled_name = sym->demangled_name();
-  fprintf(this->map_file_, "%s", demangled_name.c_str());
+  this->output("%s", demangled_name.c_str());
 
   this->advance_to_column(demangled_name.length(), 20);
 
   char buf[50];
   snprintf(buf, sizeof buf, "0x%llx", static_cast<unsigned long long>(symsize));
-  fprintf(this->map_file_, "%s", buf);
+  this->output("%s", buf);
 
   size_t len = strlen(buf);
   while (len < 18)
     {
-      putc(' ', this->map_file_);
+      this->output_char(' ');
       ++len;
     }
 
-  fprintf(this->map_file_, "%s\n", sym->object()->name().c_str());
+  this->output("%s\n", sym->object()->name().c_str());
 }
 
 // The space we make for a section name.
@@ -192,129 +373,211 @@ Mapfile::print_memory_map_header()
 {
   if (!this->printed_memory_map_header_)
     {
-      fprintf(this->map_file_, _("\nMemory map\n\n"));
+      if (!this->is_json_)
+	this->output(_("\nMemory map\n\n"));
       this->printed_memory_map_header_ = true;
     }
 }
 
-// Print the symbols associated with an input section.
+// Print a symbol associated with an input section.  FIRST is true for
+// the first symbol in the section.
 
-template<int size, bool big_endian>
+template<int size>
 void
-Mapfile::print_input_section_symbols(
-    const Sized_relobj_file<size, big_endian>* relobj,
-    unsigned int shndx)
+Mapfile::print_input_section_symbol(const Sized_symbol<size>* sym,
+				    bool first)
 {
-  unsigned int symcount = relobj->symbol_count();
-  for (unsigned int i = relobj->local_symbol_count(); i < symcount; ++i)
+  if (this->is_json_)
     {
-      const Symbol* sym = relobj->global_symbol(i);
-      bool is_ordinary;
-      if (sym != NULL
-	  && sym->source() == Symbol::FROM_OBJECT
-	  && sym->object() == relobj
-	  && sym->shndx(&is_ordinary) == shndx
-	  && is_ordinary
-	  && sym->is_defined())
-	{
-	  for (size_t i = 0; i < Mapfile::section_name_map_length; ++i)
-	    putc(' ', this->map_file_);
-	  const Sized_symbol<size>* ssym =
-	    static_cast<const Sized_symbol<size>*>(sym);
-	  fprintf(this->map_file_,
-		  "0x%0*llx                %s\n",
-		  size / 4,
-		  static_cast<unsigned long long>(ssym->value()),
-		  sym->demangled_name().c_str());
-	}
+      this->output(first ? ", \"symbols\": [" : ", ");
+      this->output("{\"name\": ");
+      this->output_json_string(sym->demangled_name().c_str());
+      this->output(", \"value\": \"0x%llx\"}",
+		   static_cast<unsigned long long>(sym->value()));
+      return;
     }
+
+  for (size_t i = 0; i < Mapfile::section_name_map_length; ++i)
+    this->output_char(' ');
+  this->output("0x%0*llx                %s\n",
+	       size / 4,
+	       static_cast<unsigned long long>(sym->value()),
+	       sym->demangled_name().c_str());
 }
 
-// Print an input section.
+// Print the line describing an input section, not including the
+// symbols defined in it.  For JSON, this leaves the object open.
 
 void
-Mapfile::print_input_section(Relobj* relobj, unsigned int shndx)
+Mapfile::print_input_section_header(Relobj* relobj, unsigned int shndx)
 {
-  putc(' ', this->map_file_);
-
   std::string name = relobj->section_name(shndx);
-  fprintf(this->map_file_, "%s", name.c_str());
-
-  this->advance_to_column(name.length() + 1, Mapfile::section_name_map_length);
 
-  Output_section* os;
   uint64_t addr;
   if (!relobj->is_section_included(shndx))
-    {
-      os = NULL;
-      addr = 0;
-    }
+    addr = 0;
   else
     {
-      os = relobj->output_section(shndx);
+      Output_section* os = relobj->output_section(shndx);
       addr = relobj->output_section_offset(shndx);
       if (addr != -1ULL)
 	addr += os->address();
     }
 
-  char sizebuf[50];
   section_size_type size;
   if (!relobj->section_is_compressed(shndx, &size))
     size = relobj->section_size(shndx);
+
+  if (this->is_json_)
+    {
+      this->output("    {\"name\": ");
+      this->output_json_string(name.c_str());
+      this->output(", \"address\": \"0x%llx\", \"size\": \"0x%llx\", "
+		   "\"object\": ",
+		   static_cast<unsigned long long>(addr),
+		   static_cast<unsigned long long>(size));
+      this->output_json_string(relobj->name().c_str());
+      return;
+    }
+
+  this->output_char(' ');
+  this->output("%s", name.c_str());
+
+  this->advance_to_column(name.length() + 1, Mapfile::section_name_map_length);
+
+  char sizebuf[50];
   snprintf(sizebuf, sizeof sizebuf, "0x%llx",
 	   static_cast<unsigned long long>(size));
 
-  fprintf(this->map_file_, "0x%0*llx %10s %s\n",
-	  parameters->target().get_size() / 4,
-	  static_cast<unsigned long long>(addr), sizebuf,
-	  relobj->name().c_str());
+  this->output("0x%0*llx %10s %s\n",
+	       parameters->target().get_size() / 4,
+	       static_cast<unsigned long long>(addr), sizebuf,
+	       relobj->name().c_str());
+}
+
+// Format the input sections of an object, and the symbols defined in
+// them.  We walk the global symbols once, rather than once per input
+// section.
+
+template<int size, bool big_endian>
+void
+Mapfile::format_sized_object(Sized_relobj_file<size, big_endian>* relobj,
+			     Object_text* text)
+{
+  // Collect the defined symbols, sorted by section index and then by
+  // symbol index.
+  std::vector<std::pair<unsigned int, unsigned int> > syms;
+  unsigned int symcount = relobj->symbol_count();
+  for (unsigned int i = relobj->local_symbol_count(); i < symcount; ++i)
+    {
+      const Symbol* sym = relobj->global_symbol(i);
+      bool is_ordinary;
+      unsigned int sym_shndx;
+      if (sym != NULL
+	  && sym->source() == Symbol::FROM_OBJECT
+	  && sym->object() == relobj
+	  && (sym_shndx = sym->shndx(&is_ordinary)) != elfcpp::SHN_UNDEF
+	  && is_ordinary
+	  && sym->is_defined())
+	syms.push_back(std::make_pair(sym_shndx, i));
+    }
+  std::sort(syms.begin(), syms.end());
 
-  if (os != NULL)
+  unsigned int shnum = relobj->shnum();
+  text->sections.resize(shnum);
+  std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
+    psym = syms.begin();
+  for (unsigned int shndx = 1; shndx < shnum; ++shndx)
     {
-      switch (parameters->size_and_endianness())
+      while (psym != syms.end() && psym->first < shndx)
+	++psym;
+
+      if (relobj->output_section(shndx) != NULL)
+	{
+	  Mapfile piece(this, &text->sections[shndx]);
+	  piece.print_input_section_header(relobj, shndx);
+	  bool first = true;
+	  for (; psym != syms.end() && psym->first == shndx; ++psym)
+	    {
+	      const Sized_symbol<size>* ssym =
+		static_cast<const Sized_symbol<size>*>(
+		    relobj->global_symbol(psym->second));
+	      piece.print_input_section_symbol(ssym, first);
+	      first = false;
+	    }
+	  if (this->is_json_)
+	    piece.output(first ? "}" : "]}");
+	}
+
+      unsigned int sh_type = relobj->section_type(shndx);
+      if ((sh_type == elfcpp::SHT_PROGBITS
+	   || sh_type == elfcpp::SHT_NOBITS
+	   || sh_type == elfcpp::SHT_GROUP)
+	  && !relobj->is_section_included(shndx))
 	{
+	  Mapfile piece(this, &text->discarded);
+	  if (this->is_json_ && !text->discarded.empty())
+	    piece.output(",\n");
+	  piece.print_input_section_header(relobj, shndx);
+	  if (this->is_json_)
+	    piece.output("}");
+	}
+    }
+}
+
+// Format the input sections of the object with index INDEX.
+
+void
+Mapfile::format_object(Relobj* relobj, unsigned int index)
+{
+  Object_text* text = &this->object_text_[index];
+  switch (parameters->size_and_endianness())
+    {
 #ifdef HAVE_TARGET_32_LITTLE
-	case Parameters::TARGET_32_LITTLE:
-	  {
-	    const Sized_relobj_file<32, false>* sized_relobj =
-	      static_cast<Sized_relobj_file<32, false>*>(relobj);
-	    this->print_input_section_symbols(sized_relobj, shndx);
-	  }
-	  break;
+    case Parameters::TARGET_32_LITTLE:
+      this->format_sized_object(static_cast<Sized_relobj_file<32, false>*>(
+				  relobj), text);
+      break;
 #endif
 #ifdef HAVE_TARGET_32_BIG
-	case Parameters::TARGET_32_BIG:
-	  {
-	    const Sized_relobj_file<32, true>* sized_relobj =
-	      static_cast<Sized_relobj_file<32, true>*>(relobj);
-	    this->print_input_section_symbols(sized_relobj, shndx);
-	  }
-	  break;
+    case Parameters::TARGET_32_BIG:
+      this->format_sized_object(static_cast<Sized_relobj_file<32, true>*>(
+				  relobj), text);
+      break;
 #endif
 #ifdef HAVE_TARGET_64_LITTLE
-	case Parameters::TARGET_64_LITTLE:
-	  {
-	    const Sized_relobj_file<64, false>* sized_relobj =
-	      static_cast<Sized_relobj_file<64, false>*>(relobj);
-	    this->print_input_section_symbols(sized_relobj, shndx);
-	  }
-	  break;
+    case Parameters::TARGET_64_LITTLE:
+      this->format_sized_object(static_cast<Sized_relobj_file<64, false>*>(
+				  relobj), text);
+      break;
 #endif
 #ifdef HAVE_TARGET_64_BIG
-	case Parameters::TARGET_64_BIG:
-	  {
-	    const Sized_relobj_file<64, true>* sized_relobj =
-	      static_cast<Sized_relobj_file<64, true>*>(relobj);
-	    this->print_input_section_symbols(sized_relobj, shndx);
-	  }
-	  break;
+    case Parameters::TARGET_64_BIG:
+      this->format_sized_object(static_cast<Sized_relobj_file<64, true>*>(
+				  relobj), text);
+      break;
 #endif
-	default:
-	  gold_unreachable();
-	}
+    default:
+      gold_unreachable();
     }
 }
 
+// Print an input section.  The text was formatted by format_object.
+
+void
+Mapfile::print_input_section(Relobj* relobj, unsigned int shndx)
+{
+  gold_assert(this->parent_ != NULL);
+  Object_index::const_iterator p = this->parent_->object_index_.find(relobj);
+  gold_assert(p != this->parent_->object_index_.end());
+  const Object_text& text(this->parent_->object_text_[p->second]);
+  gold_assert(shndx < text.sections.size());
+
+  if (this->is_json_)
+    this->start_json_section_element();
+  this->buffer_->append(text.sections[shndx]);
+}
+
 // Print an Output_section_data.  This is printed to look like an
 // input section.
 
@@ -323,60 +586,37 @@ Mapfile::print_output_data(const Output_data* od, const char* name)
 {
   this->print_memory_map_header();
 
-  putc(' ', this->map_file_);
+  unsigned long long address = (od->is_address_valid()
+				? static_cast<unsigned long long>(od->address())
+				: 0);
+  unsigned long long size = od->current_data_size();
 
-  fprintf(this->map_file_, "%s", name);
+  if (this->is_json_)
+    {
+      // Inside an output section this is an element of the list of
+      // inputs; otherwise it is an element of the memory map, and the
+      // separator is written by write_memory_map.
+      if (this->in_output_section_)
+	this->start_json_section_element();
+      this->output("    {\"name\": ");
+      this->output_json_string(name);
+      this->output(", \"address\": \"0x%llx\", \"size\": \"0x%llx\"}",
+		   address, size);
+      return;
+    }
 
-  this->advance_to_column(strlen(name) + 1, Mapfile::section_name_map_length);
+  this->output_char(' ');
 
-  char sizebuf[50];
-  snprintf(sizebuf, sizeof sizebuf, "0x%llx",
-	   static_cast<unsigned long long>(od->current_data_size()));
-
-  fprintf(this->map_file_, "0x%0*llx %10s\n",
-	  parameters->target().get_size() / 4,
-	  (od->is_address_valid()
-	   ? static_cast<unsigned long long>(od->address())
-	   : 0),
-	  sizebuf);
-}
+  this->output("%s", name);
 
-// Print the discarded input sections.
+  this->advance_to_column(strlen(name) + 1, Mapfile::section_name_map_length);
 
-void
-Mapfile::print_discarded_sections(const Input_objects* input_objects)
-{
-  bool printed_header = false;
-  for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
-       p != input_objects->relobj_end();
-       ++p)
-    {
-      Relobj* relobj = *p;
-      // Lock the object so we can read from it.  This is only called
-      // single-threaded from Layout_task_runner, so it is OK to lock.
-      // Unfortunately we have no way to pass in a Task token.
-      const Task* dummy_task = reinterpret_cast<const Task*>(-1);
-      Task_lock_obj<Object> tl(dummy_task, relobj);
-
-      unsigned int shnum = relobj->shnum();
-      for (unsigned int i = 0; i < shnum; ++i)
-	{
-	  unsigned int sh_type = relobj->section_type(i);
-	  if ((sh_type == elfcpp::SHT_PROGBITS
-	       || sh_type == elfcpp::SHT_NOBITS
-	       || sh_type == elfcpp::SHT_GROUP)
-	      && !relobj->is_section_included(i))
-	    {
-	      if (!printed_header)
-		{
-		  fprintf(this->map_file_, _("\nDiscarded input sections\n\n"));
-		  printed_header = true;
-		}
+  char sizebuf[50];
+  snprintf(sizebuf, sizeof sizebuf, "0x%llx", size);
 
-	      this->print_input_section(relobj, i);
-	    }
-	}
-    }
+  this->output("0x%0*llx %10s\n",
+	       parameters->target().get_size() / 4,
+	       address, sizebuf);
 }
 
 // Print an output section.
@@ -386,7 +626,25 @@ Mapfile::print_output_section(const Output_section* os)
 {
   this->print_memory_map_header();
 
-  fprintf(this->map_file_, "\n%s", os->name());
+  if (this->is_json_)
+    {
+      this->output("  {\"name\": ");
+      this->output_json_string(os->name());
+      this->output(", \"address\": \"0x%llx\", \"size\": \"0x%llx\"",
+		   static_cast<unsigned long long>(os->address()),
+		   static_cast<unsigned long long>(os->current_data_size()));
+      if (os->has_load_address())
+	this->output(", \"load_address\": \"0x%llx\"",
+		     static_cast<unsigned long long>(os->load_address()));
+      if (os->requires_postprocessing())
+	this->output(", \"before_compression\": true");
+      this->output(", \"inputs\": [\n");
+      this->in_output_section_ = true;
+      this->json_section_empty_ = true;
+      return;
+    }
+
+  this->output("\n%s", os->name());
 
   this->advance_to_column(strlen(os->name()), Mapfile::section_name_map_length);
 
@@ -394,19 +652,249 @@ Mapfile::print_output_section(const Output_section* os)
   snprintf(sizebuf, sizeof sizebuf, "0x%llx",
 	   static_cast<unsigned long long>(os->current_data_size()));
 
-  fprintf(this->map_file_, "0x%0*llx %10s",
-	  parameters->target().get_size() / 4,
-	  static_cast<unsigned long long>(os->address()), sizebuf);
+  this->output("0x%0*llx %10s",
+	       parameters->target().get_size() / 4,
+	       static_cast<unsigned long long>(os->address()), sizebuf);
 
   if (os->has_load_address())
-    fprintf(this->map_file_, " load address 0x%-*llx",
-	    parameters->target().get_size() / 4,
-	    static_cast<unsigned long long>(os->load_address()));
+    this->output(" load address 0x%-*llx",
+		 parameters->target().get_size() / 4,
+		 static_cast<unsigned long long>(os->load_address()));
 
   if (os->requires_postprocessing())
-    fprintf(this->map_file_, " (before compression)");
+    this->output(" (before compression)");
+
+  this->output_char('\n');
+}
+
+// Finish printing an output section.
+
+void
+Mapfile::finish_output_section(const Output_section*)
+{
+  if (this->is_json_)
+    {
+      this->output("]}");
+      this->in_output_section_ = false;
+    }
+}
+
+// Format the entry of the memory map with index INDEX.
+
+void
+Mapfile::format_memory_map_entry(unsigned int index)
+{
+  Mapfile piece(this, &this->memory_map_text_[index]);
+  this->memory_map_[index]->print_to_mapfile(&piece);
+}
+
+// Write out the discarded input sections and the memory map, which
+// have been formatted by tasks.
+
+void
+Mapfile::write_memory_map()
+{
+  bool printed_header = false;
+  for (std::vector<Object_text>::const_iterator p =
+	 this->object_text_.begin();
+       p != this->object_text_.end();
+       ++p)
+    {
+      if (p->discarded.empty())
+	continue;
+      if (this->is_json_)
+	this->start_json_element("discarded_sections");
+      else if (!printed_header)
+	{
+	  this->output(_("\nDiscarded input sections\n\n"));
+	  printed_header = true;
+	}
+      fwrite(p->discarded.data(), 1, p->discarded.size(), this->map_file_);
+    }
+
+  for (std::vector<std::string>::const_iterator p =
+	 this->memory_map_text_.begin();
+       p != this->memory_map_text_.end();
+       ++p)
+    {
+      if (p->empty())
+	continue;
+      if (this->is_json_)
+	this->start_json_element("memory_map");
+      else
+	this->print_memory_map_header();
+      fwrite(p->data(), 1, p->size(), this->map_file_);
+    }
+
+  // Release the memory.
+  std::vector<Object_text>().swap(this->object_text_);
+  std::vector<std::string>().swap(this->memory_map_text_);
+}
+
+// A task to format the input sections of an object for the map file.
 
-  putc('\n', this->map_file_);
+class Mapfile_object_task : public Task
+{
+ public:
+  Mapfile_object_task(Mapfile* mapfile, Relobj* relobj, unsigned int index,
+		      Task_token* blocker)
+    : mapfile_(mapfile), relobj_(relobj), index_(index), blocker_(blocker)
+  { }
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->relobj_->is_locked())
+      return this->relobj_->token();
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  {
+    tl->add(this, this->blocker_);
+    Task_token* token = this->relobj_->token();
+    if (token != NULL)
+      tl->add(this, token);
+  }
+
+  void
+  run(Workqueue*)
+  {
+    this->mapfile_->format_object(this->relobj_, this->index_);
+    this->relobj_->release();
+  }
+
+  std::string
+  get_name() const
+  { return "Mapfile_object_task " + this->relobj_->name(); }
+
+ private:
+  Mapfile* mapfile_;
+  Relobj* relobj_;
+  unsigned int index_;
+  Task_token* blocker_;
+};
+
+// A task to format an entry of the memory map.  This runs after all
+// the objects have been formatted.
+
+class Mapfile_section_task : public Task
+{
+ public:
+  Mapfile_section_task(Mapfile* mapfile, unsigned int index,
+		       Task_token* this_blocker, Task_token* next_blocker)
+    : mapfile_(mapfile), index_(index), this_blocker_(this_blocker),
+      next_blocker_(next_blocker)
+  { }
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->this_blocker_->is_blocked())
+      return this->this_blocker_;
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->next_blocker_); }
+
+  void
+  run(Workqueue*)
+  { this->mapfile_->format_memory_map_entry(this->index_); }
+
+  std::string
+  get_name() const
+  { return "Mapfile_section_task"; }
+
+ private:
+  Mapfile* mapfile_;
+  unsigned int index_;
+  Task_token* this_blocker_;
+  Task_token* next_blocker_;
+};
+
+// A task to write the formatted pieces to the map file.
+
+class Mapfile_write_task : public Task
+{
+ public:
+  Mapfile_write_task(Mapfile* mapfile, Task_token* objects_blocker,
+		     Task_token* sections_blocker)
+    : mapfile_(mapfile), objects_blocker_(objects_blocker),
+      sections_blocker_(sections_blocker)
+  { }
+
+  ~Mapfile_write_task()
+  {
+    delete this->objects_blocker_;
+    delete this->sections_blocker_;
+  }
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->sections_blocker_->is_blocked())
+      return this->sections_blocker_;
+    return NULL;
+  }
+
+  void
+  locks(Task_locker*)
+  { }
+
+  void
+  run(Workqueue*)
+  { this->mapfile_->write_memory_map(); }
+
+  std::string
+  get_name() const
+  { return "Mapfile_write_task"; }
+
+ private:
+  Mapfile* mapfile_;
+  Task_token* objects_blocker_;
+  Task_token* sections_blocker_;
+};
+
+// Queue the tasks to print the discarded input sections and the
+// memory map.
+
+void
+Mapfile::queue_tasks(Workqueue* workqueue, const Input_objects* input_objects,
+		     const Layout* layout)
+{
+  gold_assert(this->parent_ == NULL);
+
+  for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
+       p != input_objects->relobj_end();
+       ++p)
+    {
+      this->object_index_[*p] = this->objects_.size();
+      this->objects_.push_back(*p);
+    }
+  this->object_text_.resize(this->objects_.size());
+
+  layout->get_mapfile_order(&this->memory_map_);
+  this->memory_map_text_.resize(this->memory_map_.size());
+
+  // The Mapfile_section_tasks wait for all the Mapfile_object_tasks,
+  // and the Mapfile_write_task waits for all the
+  // Mapfile_section_tasks.
+  Task_token* objects_blocker = new Task_token(true);
+  objects_blocker->add_blockers(this->objects_.size());
+  Task_token* sections_blocker = new Task_token(true);
+  sections_blocker->add_blockers(this->memory_map_.size());
+
+  for (unsigned int i = 0; i < this->objects_.size(); ++i)
+    workqueue->queue(new Mapfile_object_task(this, this->objects_[i], i,
+					     objects_blocker));
+  for (unsigned int i = 0; i < this->memory_map_.size(); ++i)
+    workqueue->queue(new Mapfile_section_task(this, i, objects_blocker,
+					      sections_blocker));
+  workqueue->queue(new Mapfile_write_task(this, objects_blocker,
+					  sections_blocker));
 }
 
 } // End namespace gold.
@@ -25,6 +25,7 @@
 
 #include <cstdio>
 #include <string>
+#include <vector>
 
 namespace gold
 {
@@ -34,8 +35,13 @@ class Symbol;
 class Relobj;
 template<int size, bool big_endian>
 class Sized_relobj_file;
+template<int size>
+class Sized_symbol;
 class Output_section;
 class Output_data;
+class Input_objects;
+class Layout;
+class Workqueue;
 
 // This class manages map file output.
 
@@ -59,6 +65,11 @@ class Mapfile
   file()
   { return this->map_file_; }
 
+  // Return whether we are writing the JSON map format.
+  bool
+  is_json() const
+  { return this->is_json_; }
+
   // Report that we are including a member from an archive.  This is
   // called by the archive reading code.
   void
@@ -69,14 +80,22 @@ class Mapfile
   void
   report_allocate_common(const Symbol*, uint64_t symsize);
 
-  // Print discarded input sections.
+  // Queue the tasks which print the discarded input sections and the
+  // memory map once layout is complete.  The input sections are
+  // formatted by one task per object and the output sections by one
+  // task per output section; a final task writes the pieces to the
+  // map file in order.
   void
-  print_discarded_sections(const Input_objects*);
+  queue_tasks(Workqueue*, const Input_objects*, const Layout*);
 
   // Print an output section.
   void
   print_output_section(const Output_section*);
 
+  // Finish printing an output section.
+  void
+  finish_output_section(const Output_section*);
+
   // Print an input section.
   void
   print_input_section(Relobj*, unsigned int shndx);
@@ -85,10 +104,60 @@ class Mapfile
   void
   print_output_data(const Output_data*, const char* name);
 
+  // Format the input sections of an object.  This is called by a task
+  // which holds the lock on the object.
+  void
+  format_object(Relobj*, unsigned int index);
+
+  // Format an entry of the memory map.  This is called by a task.
+  void
+  format_memory_map_entry(unsigned int index);
+
+  // Write the discarded input sections and the memory map.  This is
+  // called by a task after all the pieces have been formatted.
+  void
+  write_memory_map();
+
  private:
+  // The text formatted for one object: the entry for each input
+  // section which was included in the link, indexed by section
+  // index, and the entries for the discarded input sections.
+  struct Object_text
+  {
+    std::vector<std::string> sections;
+    std::string discarded;
+  };
+
+  typedef Unordered_map<const Relobj*, unsigned int> Object_index;
+
+  // Create a Mapfile which formats into BUFFER, finding the input
+  // sections formatted by format_object in PARENT.
+  Mapfile(const Mapfile* parent, std::string* buffer);
+
   // The space we allow for a section name.
   static const size_t section_name_map_length;
 
+  // Write a formatted string to the map file or buffer.
+  void
+  output(const char* format, ...) ATTRIBUTE_PRINTF_2;
+
+  // Write a character to the map file or buffer.
+  void
+  output_char(char c);
+
+  // Write a JSON string, with quoting.
+  void
+  output_json_string(const char*);
+
+  // Start a new element of a JSON list, starting the list named NAME
+  // if necessary.
+  void
+  start_json_element(const char* name);
+
+  // Start a new element of the JSON list of an output section.
+  void
+  start_json_section_element();
+
   // Advance to a column.
   void
   advance_to_column(size_t from, size_t to);
@@ -97,20 +166,53 @@ class Mapfile
   void
   print_memory_map_header();
 
-  // Print symbols for an input section.
+  // Print the entry for an input section, without any symbols.
+  void
+  print_input_section_header(Relobj*, unsigned int shndx);
+
+  // Print a symbol in an input section.
+  template<int size>
+  void
+  print_input_section_symbol(const Sized_symbol<size>*, bool first);
+
+  // Format the input sections of an object.
   template<int size, bool big_endian>
   void
-  print_input_section_symbols(const Sized_relobj_file<size, big_endian>*,
-			      unsigned int shndx);
+  format_sized_object(Sized_relobj_file<size, big_endian>*, Object_text*);
 
   // Map file to write to.
   FILE* map_file_;
+  // The buffer to write to, if this is formatting a piece of the map.
+  std::string* buffer_;
+  // The Mapfile which owns the formatted input sections.
+  const Mapfile* parent_;
+  // Whether we are writing JSON.
+  bool is_json_;
+  // The JSON list we are currently adding to, or NULL.
+  const char* json_list_;
+  // Whether the current JSON list has any elements yet.
+  bool json_list_empty_;
+  // Whether the JSON list of the current output section has any
+  // elements yet.
+  bool json_section_empty_;
+  // Whether we are printing the inputs of an output section.
+  bool in_output_section_;
   // Whether we have printed the archive member header.
   bool printed_archive_header_;
   // Whether we have printed the allocated common header.
   bool printed_common_header_;
   // Whether we have printed the memory map header.
   bool printed_memory_map_header_;
+  // The objects whose input sections are printed.
+  std::vector<Relobj*> objects_;
+  // Map from object to index in objects_ and object_text_.
+  Object_index object_index_;
+  // The text formatted for each object.
+  std::vector<Object_text> object_text_;
+  // The top-level entries of the memory map, in order.
+  std::vector<const Output_data*> memory_map_;
+  // The text formatted for each entry of the memory map.
+  std::vector<std::string> memory_map_text_;
 };
 
 } // End namespace gold.
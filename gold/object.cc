@@ -42,6 +42,7 @@
 #include "compressed_output.h"
 #include "incremental.h"
 #include "merge.h"
+#include "workqueue.h"
 
 namespace gold
 {
@@ -158,6 +159,14 @@ Xindex::sym_xindex_to_shndx(Object* object, unsigned int symndx)
 
 // Class Object.
 
+Object::~Object()
+{
+  if (this->input_file_ != NULL)
+    this->input_file_->file().remove_object();
+  if (this->line_info_ != NULL)
+    delete this->line_info_;
+}
+
 // Report an error for this object file.  This is used by the
 // elfcpp::Elf_file interface, and also called by the Object code
 // itself.
@@ -711,7 +720,8 @@ need_decompressed_section(const char* name)
 }
 
 // Build a table for any compressed debug sections, mapping each section index
-// to the uncompressed size and (if needed) the decompressed contents.
+// to the uncompressed size, and noting which sections should be kept
+// in memory once they are decompressed.
 
 template<int size, bool big_endian>
 Compressed_section_map*
@@ -771,23 +781,15 @@ build_compressed_section_map(
 	      info.size = convert_to_section_size_type(uncompressed_size);
 	      info.flag = shdr.get_sh_flags();
 	      info.contents = NULL;
+	      info.compressed_offset = shdr.get_sh_offset();
+	      info.compressed_size = len;
+	      info.compressed_view = NULL;
+	      // The contents are decompressed later, either by
+	      // Object::queue_decompress_tasks or when first needed.
+	      info.keep_contents = (decompress_if_needed
+				    && need_decompressed_section(name));
 	      if (uncompressed_size != -1ULL)
-		{
-		  unsigned char* uncompressed_data = NULL;
-		  if (decompress_if_needed && need_decompressed_section(name))
-		    {
-		      uncompressed_data = new unsigned char[uncompressed_size];
-		      if (decompress_input_section(contents, len,
-						   uncompressed_data,
-						   uncompressed_size,
-						   size, big_endian,
-						   shdr.get_sh_flags()))
-			info.contents = uncompressed_data;
-		      else
-			delete[] uncompressed_data;
-		    }
-		  (*uncompressed_map)[i] = info;
-		}
+		(*uncompressed_map)[i] = info;
 	    }
 	}
     }
@@ -3155,7 +3157,7 @@ Object::decompressed_section_contents(
       return buffer;
     }
 
-  Compressed_section_map::const_iterator p =
+  Compressed_section_map::iterator p =
       this->compressed_sections_->find(shndx);
   if (p == this->compressed_sections_->end())
     {
@@ -3175,34 +3177,233 @@ Object::decompressed_section_contents(
     }
 
   unsigned char* uncompressed_data = new unsigned char[uncompressed_size];
-  if (!decompress_input_section(buffer,
-				buffer_size,
-				uncompressed_data,
-				uncompressed_size,
-				elfsize(),
-				is_big_endian(),
-				p->second.flag))
+  bool ok = decompress_input_section(buffer,
+				     buffer_size,
+				     uncompressed_data,
+				     uncompressed_size,
+				     elfsize(),
+				     is_big_endian(),
+				     p->second.flag);
+  if (!ok)
     this->error(_("could not decompress section %s"),
 		this->do_section_name(shndx).c_str());
 
-  // We could cache the results in p->second.contents and store
-  // false in *IS_NEW, but build_compressed_section_map() would
-  // have done so if it had expected it to be profitable.  If
-  // we reach this point, we expect to need the contents only
-  // once in this pass.
   *plen = uncompressed_size;
-  *is_new = true;
   if (palign != NULL)
     *palign = p->second.addralign;
+
+  // Keep the contents until the end of the Add_symbols task if
+  // build_compressed_section_map expected them to be needed again.
+  // Otherwise we expect to need the contents only once in this pass.
+  if (ok
+      && p->second.keep_contents
+      && Object::reserve_decompressed_bytes(uncompressed_size, false))
+    {
+      p->second.contents = uncompressed_data;
+      *is_new = false;
+    }
+  else
+    *is_new = true;
   return uncompressed_data;
 }
 
+// A task to decompress a section in the background, so that the
+// sections of an object are decompressed in parallel with each other
+// and with the Add_symbols tasks of the objects before it.  This does
+// not lock the object; it reads the compressed contents through a
+// lasting view, which discard_decompressed_sections deletes, and the
+// Add_symbols task of the object waits for it.
+
+class Decompress_section_task : public Task
+{
+ public:
+  Decompress_section_task(Object* object, unsigned int shndx,
+			  const Compressed_section_info* info,
+			  Task_token* blocker)
+    : object_(object), shndx_(shndx), info_(info), blocker_(blocker)
+  { }
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->blocker_); }
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Decompress_section_task " + this->object_->name(); }
+
+ private:
+  Object* object_;
+  unsigned int shndx_;
+  const Compressed_section_info* info_;
+  Task_token* blocker_;
+};
+
+// Protects the statistics of decompressed sections.
+
+static Lock* decompress_lock = NULL;
+static Initialize_lock decompress_initialize_lock(&decompress_lock);
+
+void
+Decompress_section_task::run(Workqueue*)
+{
+  unsigned char* uncompressed_data = new unsigned char[this->info_->size];
+  if (decompress_input_section(this->info_->compressed_view->data(),
+			       this->info_->compressed_size,
+			       uncompressed_data,
+			       this->info_->size,
+			       this->object_->elfsize(),
+			       this->object_->is_big_endian(),
+			       this->info_->flag))
+    this->object_->set_decompressed_contents(this->shndx_, uncompressed_data);
+  else
+    {
+      // Leave the error to decompressed_section_contents.
+      delete[] uncompressed_data;
+      Object::release_decompressed_bytes(this->info_->size);
+    }
+}
+
+// Queue a Decompress_section_task for each section whose contents
+// will be needed by the Add_symbols task.  This only helps if we are
+// multithreaded; otherwise the sections are decompressed when they
+// are first needed.
+
+void
+Object::queue_decompress_tasks(Workqueue* workqueue)
+{
+  if (this->compressed_sections_ == NULL
+      || !parameters->options().threads())
+    return;
+
+  for (Compressed_section_map::iterator p = this->compressed_sections_->begin();
+       p != this->compressed_sections_->end();
+       ++p)
+    {
+      Compressed_section_info* info = &p->second;
+      if (!info->keep_contents || info->contents != NULL)
+	continue;
+      if (!Object::reserve_decompressed_bytes(info->size, true))
+	continue;
+
+      if (this->decompress_blocker_ == NULL)
+	this->decompress_blocker_ = new Task_token(true);
+      this->decompress_blocker_->add_blocker();
+
+      info->compressed_view = this->get_lasting_view(info->compressed_offset,
+						     info->compressed_size,
+						     false, false);
+      workqueue->queue(new Decompress_section_task(this, p->first, info,
+						   this->decompress_blocker_));
+    }
+}
+
+// Record the decompressed contents of section SHNDX.
+
+void
+Object::set_decompressed_contents(unsigned int shndx,
+				  const unsigned char* contents)
+{
+  Compressed_section_map::iterator p = this->compressed_sections_->find(shndx);
+  gold_assert(p != this->compressed_sections_->end()
+	      && p->second.contents == NULL);
+  p->second.contents = contents;
+}
+
+// Statistics for decompressed sections.
+
+uint64_t Object::decompressed_bytes;
+uint64_t Object::max_decompressed_bytes;
+unsigned int Object::prefetched_sections;
+unsigned int Object::kept_sections;
+unsigned int Object::uncached_sections;
+
+// Reserve SIZE bytes for a decompressed section which will be kept in
+// memory until the object has been laid out.  IS_PREFETCH is true if
+// the section is decompressed by a Decompress_section_task.
+
+bool
+Object::reserve_decompressed_bytes(section_size_type size, bool is_prefetch)
+{
+  uint64_t limit = parameters->options().max_memory() * 1024 * 1024;
+  decompress_initialize_lock.initialize();
+  Hold_optional_lock hl(decompress_lock);
+  if (limit != 0 && Object::decompressed_bytes + size > limit)
+    {
+      ++Object::uncached_sections;
+      return false;
+    }
+  Object::decompressed_bytes += size;
+  if (Object::decompressed_bytes > Object::max_decompressed_bytes)
+    Object::max_decompressed_bytes = Object::decompressed_bytes;
+  if (is_prefetch)
+    ++Object::prefetched_sections;
+  else
+    ++Object::kept_sections;
+  return true;
+}
+
+// Release SIZE bytes reserved by reserve_decompressed_bytes.
+
+void
+Object::release_decompressed_bytes(section_size_type size)
+{
+  decompress_initialize_lock.initialize();
+  Hold_optional_lock hl(decompress_lock);
+  gold_assert(Object::decompressed_bytes >= size);
+  Object::decompressed_bytes -= size;
+}
+
+// Print statistics about decompressed sections.
+
+void
+Object::print_stats()
+{
+  if (Object::max_decompressed_bytes == 0 && Object::uncached_sections == 0)
+    return;
+  fprintf(stderr, _("%s: decompressed sections read ahead: %u\n"),
+	  program_name, Object::prefetched_sections);
+  fprintf(stderr, _("%s: decompressed sections kept when first used: %u\n"),
+	  program_name, Object::kept_sections);
+  fprintf(stderr, _("%s: decompressed sections not kept for memory: %u\n"),
+	  program_name, Object::uncached_sections);
+  fprintf(stderr, _("%s: maximum decompressed bytes kept: %llu\n"),
+	  program_name,
+	  static_cast<unsigned long long>(Object::max_decompressed_bytes));
+}
+
+// Return the line number information for this object.  Reading it
+// parses all of .debug_line, so we only do it once, however many
+// errors are reported against the object.
+
+Dwarf_line_info*
+Object::line_info()
+{
+  if (this->line_info_ == NULL)
+    this->line_info_ = Dwarf_line_info::make_line_info(this, -1U);
+  return this->line_info_;
+}
+
 // Discard any buffers of uncompressed sections.  This is done
-// at the end of the Add_symbols task.
+// at the end of the Add_symbols task, or once an archive member has
+// been laid out.
 
 void
 Object::discard_decompressed_sections()
 {
+  if (this->decompress_blocker_ != NULL)
+    {
+      gold_assert(!this->decompress_blocker_->is_blocked());
+      delete this->decompress_blocker_;
+      this->decompress_blocker_ = NULL;
+    }
+
   if (this->compressed_sections_ == NULL)
     return;
 
@@ -3214,7 +3415,16 @@ Object::discard_decompressed_sections()
 	{
 	  delete[] p->second.contents;
 	  p->second.contents = NULL;
+	  Object::release_decompressed_bytes(p->second.size);
+	}
+      if (p->second.compressed_view != NULL)
+	{
+	  delete p->second.compressed_view;
+	  p->second.compressed_view = NULL;
 	}
+      // Any later use, such as when relocating, only needs the
+      // contents once.
+      p->second.keep_contents = false;
     }
 }
 
@@ -3368,8 +3578,8 @@ template<int size, bool big_endian>
 std::string
 Relocate_info<size, big_endian>::location(size_t, off_t offset) const
 {
-  Sized_dwarf_line_info<size, big_endian> line_info(this->object);
-  std::string ret = line_info.addr2line(this->data_shndx, offset, NULL);
+  std::string ret = this->object->line_info()->addr2line(this->data_shndx,
+							 offset, NULL);
   if (!ret.empty())
     return ret;
 
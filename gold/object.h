@@ -37,6 +37,9 @@ namespace gold
 
 class General_options;
 class Task;
+class Task_token;
+class Workqueue;
+class Dwarf_line_info;
 class Cref;
 class Layout;
 class Kept_section;
@@ -113,7 +116,7 @@ struct Symbol_location_info
 struct Section_relocs
 {
   Section_relocs()
-    : contents(NULL)
+    : contents(NULL), reloc_offset(0)
   { }
 
   ~Section_relocs()
@@ -123,8 +126,11 @@ struct Section_relocs
   unsigned int reloc_shndx;
   // Index of section that relocs apply to.
   unsigned int data_shndx;
-  // Contents of reloc section.
+  // Contents of reloc section.  This is NULL if the relocations are
+  // read in windows when they are scanned; see --max-memory.
   File_view* contents;
+  // File offset of reloc section, used when CONTENTS is NULL.
+  off_t reloc_offset;
   // Reloc section type.
   unsigned int sh_type;
   // Number of reloc entries.
@@ -143,7 +149,7 @@ struct Section_relocs
 struct Read_relocs_data
 {
   Read_relocs_data()
-    : local_symbols(NULL)
+    : local_symbols(NULL), view_size(0)
   { }
 
   ~Read_relocs_data()
@@ -154,6 +160,8 @@ struct Read_relocs_data
   Relocs_list relocs;
   // The local symbols.
   File_view* local_symbols;
+  // The total size of the views in RELOCS and LOCAL_SYMBOLS.
+  section_size_type view_size;
 };
 
 // The Xindex class manages section indexes for objects with more than
@@ -377,6 +385,17 @@ struct Compressed_section_info
   elfcpp::Elf_Xword flag;
   uint64_t addralign;
   const unsigned char* contents;
+  // The location of the compressed contents in the object.
+  off_t compressed_offset;
+  section_size_type compressed_size;
+  // A view of the compressed contents, held while they are
+  // decompressed by a Decompress_section_task.  This can only be
+  // deleted while the object is locked.
+  File_view* compressed_view;
+  // Whether the decompressed contents should be kept in memory until
+  // the object has been laid out, because the Add_symbols task will
+  // need them.
+  bool keep_contents;
 };
 typedef std::map<unsigned int, Compressed_section_info> Compressed_section_map;
 
@@ -446,7 +465,7 @@ class Object
       is_dynamic_(is_dynamic), is_needed_(false), uses_split_stack_(false),
       has_no_split_stack_(false), no_export_(false),
       is_in_system_directory_(false), as_needed_(false), xindex_(NULL),
-      compressed_sections_(NULL)
+      compressed_sections_(NULL), decompress_blocker_(NULL), line_info_(NULL)
   {
     if (input_file != NULL)
       {
@@ -456,11 +475,7 @@ class Object
       }
   }
 
-  virtual ~Object()
-  {
-    if (this->input_file_ != NULL)
-      this->input_file_->file().remove_object();
-  }
+  virtual ~Object();
 
   // Return the name of the object as we would report it to the user.
   const std::string&
@@ -791,6 +806,17 @@ class Object
   read_multiple(const File_read::Read_multiple& rm)
   { this->input_file()->file().read_multiple(this->offset_, rm); }
 
+  // Ask the kernel to copy data from the underlying file to the
+  // output file.  Returns false if the caller must read the data.
+  bool
+  copy_to_file(off_t start, section_size_type size, int output_descriptor,
+	       off_t output_offset)
+  {
+    return this->input_file()->file().copy_to_file(start + this->offset_,
+						    size, output_descriptor,
+						    output_offset);
+  }
+
   // Stop caching views in the underlying file.
   void
   clear_view_cache_marks()
@@ -882,6 +908,46 @@ class Object
   void
   discard_decompressed_sections();
 
+  // Queue tasks to decompress, in parallel, the sections whose
+  // contents will be needed by the Add_symbols task.  This is called
+  // by the Read_symbols task while the object is locked.
+  void
+  queue_decompress_tasks(Workqueue*);
+
+  // Return the token which blocks the Add_symbols task until the
+  // sections queued by queue_decompress_tasks have been decompressed,
+  // or NULL if there are none.
+  Task_token*
+  decompress_blocker() const
+  { return this->decompress_blocker_; }
+
+  // Record the decompressed contents of section SHNDX, as read by a
+  // task queued by queue_decompress_tasks.
+  void
+  set_decompressed_contents(unsigned int shndx,
+			    const unsigned char* contents);
+
+  // Print statistics about decompressed sections to stderr.
+  static void
+  print_stats();
+
+  // Return the line number information for this object, used to
+  // report the location of errors.  This is read the first time it
+  // is needed, and kept for the rest of the link.  The object must
+  // be locked.
+  Dwarf_line_info*
+  line_info();
+
+  // Reserve SIZE bytes for a decompressed section which is kept in
+  // memory; IS_PREFETCH is true for queue_decompress_tasks.  Return
+  // false if this would exceed --max-memory.
+  static bool
+  reserve_decompressed_bytes(section_size_type size, bool is_prefetch);
+
+  // Release SIZE bytes reserved by reserve_decompressed_bytes.
+  static void
+  release_decompressed_bytes(section_size_type size);
+
   // Return the index of the first incremental relocation for symbol SYMNDX.
   unsigned int
   get_incremental_reloc_base(unsigned int symndx) const
@@ -1132,6 +1198,22 @@ class Object
   // For compressed debug sections, map section index to uncompressed size
   // and contents.
   Compressed_section_map* compressed_sections_;
+  // Blocks the Add_symbols task until the sections queued by
+  // queue_decompress_tasks have been decompressed.
+  Task_token* decompress_blocker_;
+  // The line number information, or NULL if not yet read.
+  Dwarf_line_info* line_info_;
+
+  // The decompressed bytes currently kept in memory.
+  static uint64_t decompressed_bytes;
+  // The maximum of decompressed_bytes.
+  static uint64_t max_decompressed_bytes;
+  // The number of sections decompressed by queue_decompress_tasks.
+  static unsigned int prefetched_sections;
+  // The number of sections decompressed when first needed and kept.
+  static unsigned int kept_sections;
+  // The number of sections not kept in memory because of --max-memory.
+  static unsigned int uncached_sections;
 };
 
 // A regular object (ET_REL).  This is an abstract base class itself.
@@ -2723,6 +2805,13 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   emit_relocs_scan(Symbol_table*, Layout*, const unsigned char* plocal_syms,
 		   const Read_relocs_data::Relocs_list::iterator&);
 
+  // Scan the input relocations for -r or --emit-relocs, reading them
+  // from the file a window at a time.
+  void
+  scan_relocs_in_windows(Symbol_table*, Layout*,
+			 const unsigned char* plocal_syms,
+			 const Read_relocs_data::Relocs_list::iterator&);
+
   // Scan the input relocations for --emit-relocs, templatized on the
   // type of the relocation section.
   template<int sh_type>
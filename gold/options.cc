@@ -1380,6 +1380,11 @@ General_options::finalize()
   if (this->relocatable() && this->retain_symbols_file())
     gold_fatal(_("-retain-symbols-file does not yet work with -r"));
 
+  if (this->call_graph_ordering_file() != NULL
+      && this->section_ordering_file() != NULL)
+    gold_fatal(_("--call-graph-ordering-file and --section-ordering-file "
+		 "are incompatible"));
+
   if (this->oformat_enum() != General_options::OBJECT_FORMAT_ELF
       && (this->shared()
 	  || this->pie()
@@ -684,6 +684,11 @@ class General_options
 	      N_("Not supported"),
 	      N_("Do not copy DT_NEEDED tags from shared libraries"));
 
+  DEFINE_bool(copy_file_range, options::TWO_DASHES, '\0', true,
+	      N_("Let the kernel copy input sections which need no "
+		 "changes to the output file"),
+	      N_("Copy all input sections through memory"));
+
   DEFINE_bool_alias(allow_multiple_definition, muldefs, options::TWO_DASHES,
 		    '\0',
 		    N_("Allow multiple definitions of symbols"),
@@ -764,6 +769,12 @@ class General_options
 
   // c
 
+  DEFINE_string(call_graph_ordering_file, options::TWO_DASHES, '\0', NULL,
+		N_("Layout functions in an order computed from a call "
+		   "graph profile, and place functions with zero counts "
+		   "with unlikely code"),
+		N_("FILENAME"));
+
   DEFINE_bool(check_sections, options::TWO_DASHES, '\0', true,
 	      N_("Check segment addresses for overlaps"),
 	      N_("Do not check segment addresses for overlaps"));
@@ -1049,6 +1060,12 @@ class General_options
 	      N_("Map whole files to memory"),
 	      N_("Map relevant file parts to memory"));
 
+  DEFINE_uint64(max_memory, options::TWO_DASHES, '\0', 0,
+		N_("Limit the relocations read ahead of scanning, and the "
+		   "decompressed debug sections kept in memory, to "
+		   "SIZE megabytes"),
+		N_("SIZE"));
+
   DEFINE_bool(merge_exidx_entries, options::TWO_DASHES, '\0', true,
 	      N_("(ARM only) Merge exidx entries in debuginfo"),
 	      N_("(ARM only) Do not merge exidx entries in debuginfo"));
@@ -1063,6 +1080,11 @@ class General_options
   DEFINE_string(Map, options::ONE_DASH, '\0', NULL, N_("Write map file"),
 		N_("MAPFILENAME"));
 
+  DEFINE_enum(map_format, options::TWO_DASHES, '\0', "text",
+	      N_("Format of the map file"),
+	      N_("[text,json]"), false,
+	      {"text", "json"});
+
   // n
 
   DEFINE_bool(nmagic, options::TWO_DASHES, 'n', false,
@@ -1164,6 +1186,10 @@ class General_options
   DEFINE_special(no_power10_stubs, options::TWO_DASHES, '\0',
 		 N_("(PowerPC64 only) stubs do not use power10 insns"), NULL);
 
+  DEFINE_bool(prefetch_inputs, options::TWO_DASHES, '\0', false,
+	      N_("Start reading input files in the background"),
+	      N_("Do not start reading input files in the background"));
+
   DEFINE_bool(preread_archive_symbols, options::TWO_DASHES, '\0', false,
 	      N_("Preread archive symbols when multi-threaded"), NULL);
 
@@ -2518,8 +2518,9 @@ Output_section::add_input_section(Layout* layout,
   // track of sections, or if we are relaxing.  Also, if this is a
   // section which requires sorting, or which may require sorting in
   // the future, we keep track of the sections.  If the
-  // --section-ordering-file option is used to specify the order of
-  // sections, we need to keep track of sections.
+  // --section-ordering-file or --call-graph-ordering-file option is
+  // used to specify the order of sections, we need to keep track of
+  // sections.
   if (this->always_keeps_input_sections_
       || have_sections_script
       || !this->input_sections_.empty()
@@ -2527,7 +2528,8 @@ Output_section::add_input_section(Layout* layout,
       || this->must_sort_attached_input_sections()
       || parameters->options().user_set_Map()
       || parameters->target().may_relax()
-      || layout->is_section_ordering_specified())
+      || layout->is_section_ordering_specified()
+      || parameters->options().call_graph_ordering_file() != NULL)
     {
       Input_section isecn(object, shndx, input_section_size, addralign);
       /* If section ordering is requested by specifying a ordering file,
@@ -3491,9 +3493,41 @@ Output_section::Input_section_sort_section_order_index_compare::operator()(
   return s1_secn_index < s2_secn_index;
 }
 
+// Return true if S1 should come before S2.  This is the sort comparison
+// function for .text when only --call-graph-ordering-file orders it.
+// As with the .text.unlikely and .text.hot prefixes, the cold sections
+// come first, then the hot sections in the order computed from the
+// profile; all other sections keep their input order.
+
+bool
+Output_section::Input_section_sort_call_graph_order_compare::operator()(
+    const Output_section::Input_section_sort_entry& s1,
+    const Output_section::Input_section_sort_entry& s2) const
+{
+  unsigned int s1_secn_index = s1.input_section().section_order_index();
+  unsigned int s2_secn_index = s2.input_section().section_order_index();
+
+  if (s1_secn_index == s2_secn_index)
+    return s1.index() < s2.index();
+  else if (s1_secn_index == cold_section_order_index)
+    return true;
+  else if (s2_secn_index == cold_section_order_index)
+    return false;
+  else if (s1_secn_index == 0)
+    return false;
+  else if (s2_secn_index == 0)
+    return true;
+  else
+    return s1_secn_index < s2_secn_index;
+}
+
 // Return true if S1 should come before S2.  This is the sort comparison
 // function for .text to sort sections with prefixes
-// .text.{unlikely,exit,startup,hot} before other sections.
+// .text.{unlikely,exit,startup,hot} before other sections.  If
+// use_order_index_ is set, sections ordered by --call-graph-ordering-file
+// are hot, and come first among the .text.hot sections, and the
+// sections it found to be cold are sorted with the .text.unlikely
+// sections.
 
 bool
 Output_section::Input_section_sort_section_prefix_special_ordering_compare
@@ -3504,8 +3538,28 @@ Output_section::Input_section_sort_section_prefix_special_ordering_compare
   // Some input section names have special ordering requirements.
   const char *s1_section_name = s1.section_name().c_str();
   const char *s2_section_name = s2.section_name().c_str();
-  int o1 = Layout::special_ordering_of_input_section(s1_section_name);
-  int o2 = Layout::special_ordering_of_input_section(s2_section_name);
+  unsigned int s1_secn_index = (this->use_order_index_
+				? s1.input_section().section_order_index()
+				: 0);
+  unsigned int s2_secn_index = (this->use_order_index_
+				? s2.input_section().section_order_index()
+				: 0);
+  if (s1_secn_index == cold_section_order_index)
+    {
+      s1_section_name = ".text.unlikely";
+      s1_secn_index = 0;
+    }
+  if (s2_secn_index == cold_section_order_index)
+    {
+      s2_section_name = ".text.unlikely";
+      s2_secn_index = 0;
+    }
+  int o1 = Layout::special_ordering_of_input_section(s1_secn_index != 0
+						     ? ".text.hot"
+						     : s1_section_name);
+  int o2 = Layout::special_ordering_of_input_section(s2_secn_index != 0
+						     ? ".text.hot"
+						     : s2_section_name);
   if (o1 != o2)
     {
       if (o1 < 0)
@@ -3515,6 +3569,15 @@ Output_section::Input_section_sort_section_prefix_special_ordering_compare
       else
 	return o1 < o2;
     }
+  else if (s1_secn_index != s2_secn_index)
+    {
+      if (s1_secn_index == 0)
+	return false;
+      else if (s2_secn_index == 0)
+	return true;
+      else
+	return s1_secn_index < s2_secn_index;
+    }
   else if (is_prefix_of(".text.sorted", s1_section_name))
     return strcmp(s1_section_name, s2_section_name) <= 0;
 
@@ -3614,11 +3677,17 @@ Output_section::sort_attached_input_sections()
 		  Input_section_sort_section_name_compare());
       else if (strcmp(this->name(), ".text") == 0)
 	std::sort(sort_list.begin(), sort_list.end(),
-		  Input_section_sort_section_prefix_special_ordering_compare());
+		  Input_section_sort_section_prefix_special_ordering_compare(
+		    parameters->options().call_graph_ordering_file() != NULL));
       else
 	std::sort(sort_list.begin(), sort_list.end(),
 		  Input_section_sort_compare());
     }
+  else if (parameters->options().call_graph_ordering_file() != NULL
+	   && this->input_section_order_specified()
+	   && strcmp(this->name(), ".text") == 0)
+    std::sort(sort_list.begin(), sort_list.end(),
+	      Input_section_sort_call_graph_order_compare());
   else
     {
       gold_assert(this->input_section_order_specified());
@@ -4014,6 +4083,8 @@ Output_section::do_print_to_mapfile(Mapfile* mapfile) const
        p != this->input_sections_.end();
        ++p)
     p->print_to_mapfile(mapfile);
+
+  mapfile->finish_output_section(this);
 }
 
 // Print stats for merge sections to stderr.
@@ -4914,27 +4985,16 @@ Output_segment::write_section_headers_list(const Layout* layout,
   return v;
 }
 
-// Print the output sections to the map file.
+// Collect the output sections to print in the map file.
 
 void
-Output_segment::print_sections_to_mapfile(Mapfile* mapfile) const
+Output_segment::get_mapfile_order(std::vector<const Output_data*>* pods) const
 {
   if (this->type() != elfcpp::PT_LOAD)
     return;
   for (int i = 0; i < static_cast<int>(ORDER_MAX); ++i)
-    this->print_section_list_to_mapfile(mapfile, &this->output_lists_[i]);
-}
-
-// Print an output section list to the map file.
-
-void
-Output_segment::print_section_list_to_mapfile(Mapfile* mapfile,
-					      const Output_data_list* pdl) const
-{
-  for (Output_data_list::const_iterator p = pdl->begin();
-       p != pdl->end();
-       ++p)
-    (*p)->print_to_mapfile(mapfile);
+    pods->insert(pods->end(), this->output_lists_[i].begin(),
+		 this->output_lists_[i].end());
 }
 
 // Output_file methods.
@@ -140,6 +140,19 @@ class Output_file
   free_input_view(off_t, size_t, const unsigned char*)
   { }
 
+  // Return the descriptor to use to write data directly to the file,
+  // bypassing the views, or -1 if that is not possible.  This is only
+  // possible when the views map the file itself, so that data written
+  // to the descriptor is seen through them and is not overwritten
+  // when the file is closed.
+  int
+  descriptor() const
+  {
+    if (this->map_is_anonymous_ || this->base_ == NULL)
+      return -1;
+    return this->o_;
+  }
+
  private:
   // Map the file into memory or, if that fails, allocate anonymous
   // memory.
@@ -3269,6 +3282,10 @@ class Output_section : public Output_data
 
   typedef std::map<Section_id, unsigned int> Section_layout_order;
 
+  // The section order index given by --call-graph-ordering-file to
+  // sections which the profile shows are never executed.
+  static const unsigned int cold_section_order_index = -1U;
+
   void
   update_section_layout(const Section_layout_order* order_map);
 
@@ -4371,7 +4388,29 @@ class Output_section : public Output_data
 
   // This is the sort comparison function for .text to sort sections with
   // prefixes .text.{unlikely,exit,startup,hot} before other sections.
+  // If USE_ORDER_INDEX is true, sections with a section order index are
+  // treated as .text.hot sections and sorted by that index.
   struct Input_section_sort_section_prefix_special_ordering_compare
+  {
+    Input_section_sort_section_prefix_special_ordering_compare(
+	bool use_order_index = false)
+      : use_order_index_(use_order_index)
+    { }
+
+    bool
+    operator()(const Input_section_sort_entry&,
+	       const Input_section_sort_entry&) const;
+
+   private:
+    // Whether to consult the section order index.
+    bool use_order_index_;
+  };
+
+  // This is the sort comparison function for .text when the order comes
+  // from --call-graph-ordering-file.  Only the sections named by the
+  // ordering are moved; the cold ones come first, then the hot ones,
+  // and everything else keeps its input order.
+  struct Input_section_sort_call_graph_order_compare
   {
     bool
     operator()(const Input_section_sort_entry&,
@@ -4828,9 +4867,9 @@ class Output_segment
   write_section_headers(const Layout*, const Stringpool*, unsigned char* v,
 			unsigned int* pshndx) const;
 
-  // Print the output sections in the map file.
+  // Collect the output sections to print in the map file.
   void
-  print_sections_to_mapfile(Mapfile*) const;
+  get_mapfile_order(std::vector<const Output_data*>*) const;
 
  private:
   typedef std::vector<Output_data*> Output_data_list;
@@ -4877,9 +4916,6 @@ class Output_segment
 			     const Output_data_list*, unsigned char* v,
 			     unsigned int* pshdx) const;
 
-  // Print a section list to the mapfile.
-  void
-  print_section_list_to_mapfile(Mapfile*, const Output_data_list*) const;
 
   // NOTE: We want to use the copy constructor.  Currently, shallow copy
   // works for us so we do not need to write our own copy constructor.
@@ -23,6 +23,7 @@
 #include "gold.h"
 
 #include <cstring>
+#include "filenames.h"
 
 #include "elfcpp.h"
 #include "options.h"
@@ -31,6 +32,7 @@
 #include "object.h"
 #include "archive.h"
 #include "script.h"
+#include "fileread.h"
 #include "readsyms.h"
 #include "plugin.h"
 #include "layout.h"
@@ -400,6 +402,11 @@ Read_symbols::do_read_symbols(Workqueue* workqueue)
       Read_symbols_data* sd = new Read_symbols_data;
       elf_obj->read_symbols(sd);
 
+      // Start decompressing the debug sections which the Add_symbols
+      // task will need.
+      if (this->member_ == NULL)
+	elf_obj->queue_decompress_tasks(workqueue);
+
       // Opening the file locked it, so now we need to unlock it.  We
       // need to unlock it before queuing the Add_symbols task,
       // because the workqueue doesn't know about our lock on the
@@ -566,14 +573,17 @@ Add_symbols::~Add_symbols()
   // input file.
 }
 
-// We are blocked by this_blocker_.  We block next_blocker_.  We also
-// lock the file.
+// We are blocked by this_blocker_, and by the tasks decompressing the
+// object's sections.  We block next_blocker_.  We also lock the file.
 
 Task_token*
 Add_symbols::is_runnable()
 {
   if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
     return this->this_blocker_;
+  Task_token* decompress_blocker = this->object_->decompress_blocker();
+  if (decompress_blocker != NULL && decompress_blocker->is_blocked())
+    return decompress_blocker;
   if (this->object_->is_locked())
     return this->object_->token();
   return NULL;
@@ -943,4 +953,115 @@ Read_script::get_name() const
   return ret;
 }
 
+// Class Prefetch_inputs.
+
+// Searching for -l libraries requires the complete search path.
+
+Task_token*
+Prefetch_inputs::is_runnable()
+{
+  if (this->dirpath_->token()->is_blocked())
+    return this->dirpath_->token();
+  return NULL;
+}
+
+// Walk the command line and prefetch every file.
+
+void
+Prefetch_inputs::run(Workqueue*)
+{
+  for (Command_line::const_iterator p = this->cmdline_->begin();
+       p != this->cmdline_->end();
+       ++p)
+    this->prefetch_argument(&*p);
+}
+
+// Prefetch the files named by an input argument, looking inside groups
+// and libs.
+
+void
+Prefetch_inputs::prefetch_argument(const Input_argument* input_argument)
+{
+  if (input_argument->is_file())
+    this->prefetch_file(&input_argument->file());
+  else if (input_argument->is_group())
+    {
+      const Input_file_group* group = input_argument->group();
+      for (Input_file_group::const_iterator p = group->begin();
+	   p != group->end();
+	   ++p)
+	this->prefetch_argument(&*p);
+    }
+  else
+    {
+      gold_assert(input_argument->is_lib());
+      const Input_file_lib* lib = input_argument->lib();
+      for (Input_file_lib::const_iterator p = lib->begin();
+	   p != lib->end();
+	   ++p)
+	this->prefetch_argument(&*p);
+    }
+}
+
+// Find a single input file and prefetch it.  This follows the same
+// search as Input_file::find_file, but stays quiet if the file can not
+// be found; the Read_symbols task will report that.
+
+void
+Prefetch_inputs::prefetch_file(const Input_file_argument* input_argument)
+{
+  if (input_argument->options().format_enum()
+      != General_options::OBJECT_FORMAT_ELF)
+    return;
+
+  if (IS_ABSOLUTE_PATH(input_argument->name())
+      || (!input_argument->is_lib()
+	  && !input_argument->is_searched_file()
+	  && input_argument->extra_search_path() == NULL))
+    {
+      File_read::prefetch(input_argument->name());
+      return;
+    }
+
+  std::vector<std::string> names;
+  if (input_argument->is_lib())
+    {
+      std::string prefix = "lib";
+      prefix += input_argument->name();
+      if (parameters->options().is_static()
+	  || !input_argument->options().Bdynamic())
+	names.push_back(prefix + ".a");
+      else
+	{
+	  names.push_back(prefix + ".so");
+	  names.push_back(prefix + ".a");
+	}
+    }
+  else
+    names.push_back(input_argument->name());
+
+  for (std::vector<std::string>::const_iterator n = names.begin();
+       n != names.end();
+       ++n)
+    {
+      int dirindex = 0;
+      std::string found_name;
+      std::string name;
+      if (Input_file::try_extra_search_path(&dirindex, input_argument, *n,
+					    &found_name, &name))
+	{
+	  File_read::prefetch(name);
+	  return;
+	}
+    }
+
+  bool is_in_sysroot;
+  int dirindex = 0;
+  std::string found_name;
+  std::string name = this->dirpath_->find(names, &is_in_sysroot, &dirindex,
+					  &found_name);
+  if (!name.empty())
+    File_read::prefetch(name);
+}
+
 } // End namespace gold.
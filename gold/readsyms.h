@@ -37,6 +37,9 @@ class Symbol_table;
 class Input_group;
 class Archive;
 class Finish_group;
+class Command_line;
+class Input_argument;
+class Input_file_argument;
 
 // This Task is responsible for reading the symbols from an input
 // file.  This also includes reading the relocations so that we can
@@ -486,6 +489,48 @@ class Read_script : public Task
   Task_token* next_blocker_;
 };
 
+// This Task is used for --prefetch-inputs.  It runs as soon as the
+// search path is complete, finds every input file named on the
+// command line, and asks the operating system to start reading it, so
+// that the Read_symbols tasks which open the files later do not stall
+// on cold caches.
+
+class Prefetch_inputs : public Task
+{
+ public:
+  Prefetch_inputs(Dirsearch* dirpath, const Command_line* cmdline)
+    : dirpath_(dirpath), cmdline_(cmdline)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*)
+  { }
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Prefetch_inputs"; }
+
+ private:
+  // Prefetch the files named by an input argument.
+  void
+  prefetch_argument(const Input_argument*);
+
+  // Prefetch a single input file.
+  void
+  prefetch_file(const Input_file_argument*);
+
+  Dirsearch* dirpath_;
+  const Command_line* cmdline_;
+};
+
 } // end namespace gold
 
 #endif // !defined(GOLD_READSYMS_H)
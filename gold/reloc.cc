@@ -41,13 +41,43 @@ namespace gold
 
 // Read_relocs methods.
 
+// The amount of relocation data read ahead of Scan_relocs, used to
+// implement --max-memory.
+
+section_size_type Read_relocs::pending_bytes;
+section_size_type Read_relocs::max_pending_bytes;
+unsigned int Read_relocs::memory_waits;
+
+// A lock for the above counts.
+
+static Lock* pending_relocs_lock = NULL;
+static Initialize_lock pending_relocs_initialize_lock(&pending_relocs_lock);
+
 // These tasks just read the relocation information from the file.
 // After reading it, the start another task to process the
 // information.  These tasks requires access to the file.
 
+// With --max-memory, once the relocation data which has been read
+// but not yet scanned exceeds the limit, we do not read any more
+// until the previous object has been scanned.  Since the Scan_relocs
+// tasks run in order, this always leaves one task which can run.
+
 Task_token*
 Read_relocs::is_runnable()
 {
+  if (this->this_blocker_ != NULL
+      && this->this_blocker_->is_blocked()
+      && Read_relocs::is_memory_limited())
+    {
+      uint64_t limit = parameters->options().max_memory() * 1024 * 1024;
+      pending_relocs_initialize_lock.initialize();
+      Hold_optional_lock hl(pending_relocs_lock);
+      if (Read_relocs::pending_bytes >= limit)
+	{
+	  ++Read_relocs::memory_waits;
+	  return this->this_blocker_;
+	}
+    }
   return this->object_->is_locked() ? this->object_->token() : NULL;
 }
 
@@ -71,6 +101,15 @@ Read_relocs::run(Workqueue* workqueue)
   this->object_->set_relocs_data(rd);
   this->object_->release();
 
+  if (Read_relocs::is_memory_limited())
+    {
+      pending_relocs_initialize_lock.initialize();
+      Hold_optional_lock hl(pending_relocs_lock);
+      Read_relocs::pending_bytes += rd->view_size;
+      if (Read_relocs::pending_bytes > Read_relocs::max_pending_bytes)
+	Read_relocs::max_pending_bytes = Read_relocs::pending_bytes;
+    }
+
   // If garbage collection or identical comdat folding is desired, we  
   // process the relocs first before scanning them.  Scanning of relocs is
   // done only after garbage or identical sections is identified.
@@ -100,6 +139,45 @@ Read_relocs::get_name() const
   return "Read_relocs " + this->object_->name();
 }
 
+// Return whether --max-memory applies.  Garbage collection and
+// identical code folding need the relocations of all the objects at
+// once, so we can not limit them.
+
+bool
+Read_relocs::is_memory_limited()
+{
+  return (parameters->options().max_memory() != 0
+	  && !parameters->options().gc_sections()
+	  && !parameters->options().icf_enabled());
+}
+
+// Record that RD has been scanned.
+
+void
+Read_relocs::release_relocs_data(const Read_relocs_data* rd)
+{
+  if (!Read_relocs::is_memory_limited())
+    return;
+  pending_relocs_initialize_lock.initialize();
+  Hold_optional_lock hl(pending_relocs_lock);
+  gold_assert(Read_relocs::pending_bytes >= rd->view_size);
+  Read_relocs::pending_bytes -= rd->view_size;
+}
+
+// Print statistics about the relocations read ahead of scanning.
+
+void
+Read_relocs::print_stats()
+{
+  if (!Read_relocs::is_memory_limited())
+    return;
+  fprintf(stderr, _("%s: maximum relocation bytes pending scan: %llu\n"),
+	  program_name,
+	  static_cast<unsigned long long>(Read_relocs::max_pending_bytes));
+  fprintf(stderr, _("%s: relocation reads delayed for memory: %u\n"),
+	  program_name, Read_relocs::memory_waits);
+}
+
 // Gc_process_relocs methods.
 
 Gc_process_relocs::~Gc_process_relocs()
@@ -186,6 +264,7 @@ void
 Scan_relocs::run(Workqueue*)
 {
   this->object_->scan_relocs(this->symtab_, this->layout_, this->rd_);
+  Read_relocs::release_relocs_data(this->rd_);
   delete this->rd_;
   this->rd_ = NULL;
   this->object_->release();
@@ -270,6 +349,7 @@ Sized_relobj_file<size, big_endian>::do_read_relocs(Read_relocs_data* rd)
 
   const Output_sections& out_sections(this->output_sections());
   const std::vector<Address>& out_offsets(this->section_offsets());
+  const bool is_memory_limited = Read_relocs::is_memory_limited();
 
   const unsigned char* pshdrs = this->get_view(this->elf_file_.shoff(),
 					       shnum * This::shdr_size,
@@ -350,8 +430,19 @@ Sized_relobj_file<size, big_endian>::do_read_relocs(Read_relocs_data* rd)
       Section_relocs& sr(rd->relocs.back());
       sr.reloc_shndx = i;
       sr.data_shndx = shndx;
-      sr.contents = this->get_lasting_view(shdr.get_sh_offset(), sh_size,
-					   true, true);
+      // With --max-memory, relocations which are only copied to the
+      // output file are read a window at a time when they are scanned,
+      // rather than being held in memory until then.
+      if (is_memory_limited
+	  && (parameters->options().relocatable() || !is_section_allocated)
+	  && !parameters->incremental())
+	sr.reloc_offset = shdr.get_sh_offset();
+      else
+	{
+	  sr.contents = this->get_lasting_view(shdr.get_sh_offset(), sh_size,
+					       true, !is_memory_limited);
+	  rd->view_size += sh_size;
+	}
       sr.sh_type = sh_type;
       sr.reloc_count = reloc_count;
       sr.output_section = os;
@@ -373,7 +464,9 @@ Sized_relobj_file<size, big_endian>::do_read_relocs(Read_relocs_data* rd)
       gold_assert(loccount == symtabshdr.get_sh_info());
       off_t locsize = loccount * sym_size;
       rd->local_symbols = this->get_lasting_view(symtabshdr.get_sh_offset(),
-						 locsize, true, true);
+						 locsize, true,
+						 !is_memory_limited);
+      rd->view_size += locsize;
     }
 }
 
@@ -453,7 +546,9 @@ Sized_relobj_file<size, big_endian>::do_scan_relocs(Symbol_table* symtab,
           if (p->output_section == NULL)
             continue;
         }
-      if (!parameters->options().relocatable())
+      if (p->contents == NULL)
+	this->scan_relocs_in_windows(symtab, layout, local_symbols, p);
+      else if (!parameters->options().relocatable())
 	{
 	  // As noted above, when not generating an object file, we
 	  // only scan allocated sections.  We may see a non-allocated
@@ -532,6 +627,60 @@ Sized_relobj_file<size, big_endian>::emit_relocs_scan(
     rr);
 }
 
+// The size of the buffer used by scan_relocs_in_windows.
+
+static const section_size_type reloc_window_size = 1024 * 1024;
+
+// Scan the input relocations of a section for -r or --emit-relocs,
+// reading them into a buffer of reloc_window_size bytes at a time.
+// The strategies for these relocations depend only on each relocation
+// itself, so scanning them in pieces gives the same result.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::scan_relocs_in_windows(
+    Symbol_table* symtab,
+    Layout* layout,
+    const unsigned char* plocal_syms,
+    const Read_relocs_data::Relocs_list::iterator& p)
+{
+  Sized_target<size, big_endian>* target =
+      parameters->sized_target<size, big_endian>();
+
+  Relocatable_relocs* rr = this->relocatable_relocs(p->reloc_shndx);
+  gold_assert(rr != NULL);
+  rr->set_reloc_count(p->reloc_count);
+
+  const section_size_type reloc_size =
+    (p->sh_type == elfcpp::SHT_REL
+     ? elfcpp::Elf_sizes<size>::rel_size
+     : elfcpp::Elf_sizes<size>::rela_size);
+  const size_t window_count = reloc_window_size / reloc_size;
+  std::vector<unsigned char> window(std::min(p->reloc_count, window_count)
+				    * reloc_size);
+
+  for (size_t i = 0; i < p->reloc_count; i += window_count)
+    {
+      size_t count = std::min(p->reloc_count - i, window_count);
+      this->read(p->reloc_offset + i * reloc_size, count * reloc_size,
+		 &window[0]);
+      if (parameters->options().relocatable())
+	target->scan_relocatable_relocs(symtab, layout, this, p->data_shndx,
+					p->sh_type, &window[0], count,
+					p->output_section,
+					p->needs_special_offset_handling,
+					this->local_symbol_count_,
+					plocal_syms, rr);
+      else
+	target->emit_relocs_scan(symtab, layout, this, p->data_shndx,
+				 p->sh_type, &window[0], count,
+				 p->output_section,
+				 p->needs_special_offset_handling,
+				 this->local_symbol_count_,
+				 plocal_syms, rr);
+    }
+}
+
 // Scan the input relocations for --incremental.
 
 template<int size, bool big_endian>
@@ -687,6 +836,32 @@ Sized_relobj_file<size, big_endian>::write_sections(const Layout* layout,
   File_read::Read_multiple rm;
   bool is_sorted = true;
 
+  // Sections which we do not change at all, because they have no
+  // relocations, may be copied by the kernel straight from the input
+  // file into the output file.  The views still see the data, because
+  // this is only done when they map the output file.  We leave alone
+  // executable sections, which some targets patch while relocating.
+  int output_descriptor = -1;
+  std::vector<bool> has_relocs;
+  if (parameters->options().copy_file_range())
+    output_descriptor = of->descriptor();
+  if (output_descriptor >= 0)
+    {
+      has_relocs.resize(shnum, false);
+      const unsigned char* ps = pshdrs + This::shdr_size;
+      for (unsigned int i = 1; i < shnum; ++i, ps += This::shdr_size)
+	{
+	  typename This::Shdr shdr(ps);
+	  if (shdr.get_sh_type() == elfcpp::SHT_REL
+	      || shdr.get_sh_type() == elfcpp::SHT_RELA)
+	    {
+	      unsigned int index = this->adjust_shndx(shdr.get_sh_info());
+	      if (index < shnum)
+		has_relocs[index] = true;
+	    }
+	}
+    }
+
   const unsigned char* p = pshdrs + This::shdr_size;
   for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
     {
@@ -814,10 +989,22 @@ Sized_relobj_file<size, big_endian>::write_sections(const Layout* layout,
 	      if (!must_decompress)
 		{
 		  off_t sh_offset = shdr.get_sh_offset();
-		  if (!rm.empty() && rm.back().file_offset > sh_offset)
-		    is_sorted = false;
-		  rm.push_back(File_read::Read_multiple_entry(sh_offset,
-							      view_size, view));
+		  bool copied = (output_descriptor >= 0
+				 && view_size >= File_read::min_copy_size
+				 && !has_relocs[i]
+				 && ((shdr.get_sh_flags()
+				      & elfcpp::SHF_EXECINSTR) == 0)
+				 && this->copy_to_file(sh_offset, view_size,
+						       output_descriptor,
+						       view_start));
+		  if (!copied)
+		    {
+		      if (!rm.empty() && rm.back().file_offset > sh_offset)
+			is_sorted = false;
+		      rm.push_back(File_read::Read_multiple_entry(sh_offset,
+								  view_size,
+								  view));
+		    }
 		}
 	    }
 	}
@@ -85,7 +85,29 @@ class Read_relocs : public Task
   std::string
   get_name() const;
 
+  // Return whether --max-memory limits the amount of relocation data
+  // read ahead of Scan_relocs.
+  static bool
+  is_memory_limited();
+
+  // Record that the relocation data in RD has been scanned and
+  // released.
+  static void
+  release_relocs_data(const Read_relocs_data* rd);
+
+  // Print statistics to stderr.
+  static void
+  print_stats();
+
  private:
+  // The number of bytes of relocation data which have been read but
+  // not yet scanned, with --max-memory.
+  static section_size_type pending_bytes;
+  // The largest value of PENDING_BYTES.
+  static section_size_type max_pending_bytes;
+  // The number of times a Read_relocs task waited for memory.
+  static unsigned int memory_waits;
+
   Symbol_table* symtab_;
   Layout* layout_;
   Relobj* object_;
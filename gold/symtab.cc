@@ -41,6 +41,7 @@
 #include "script.h"
 #include "plugin.h"
 #include "incremental.h"
+#include "timer.h"
 
 namespace gold
 {
@@ -3464,6 +3465,15 @@ Symbol_table::sized_write_section_symbol(const Output_section* os,
   of->write_output_view(offset, sym_size, pov);
 }
 
+// Statistics about ODR violation detection, for --stats.
+
+static Lock* odr_stats_lock = NULL;
+static Initialize_lock odr_stats_initialize_lock(&odr_stats_lock);
+static unsigned int odr_stats_symbols;
+static unsigned int odr_stats_locations;
+static unsigned int odr_stats_objects;
+static Timer::TimeStats odr_stats_time;
+
 // Print statistical information to stderr.  This is used for --stats.
 
 void
@@ -3477,6 +3487,20 @@ Symbol_table::print_stats() const
 	  program_name, this->table_.size());
 #endif
   this->namepool_.print_stats("symbol table stringpool");
+  if (parameters->options().detect_odr_violations())
+    {
+      fprintf(stderr, _("%s: ODR violation candidates: %u symbols, "
+			"%u locations in %u objects\n"),
+	      program_name, odr_stats_symbols, odr_stats_locations,
+	      odr_stats_objects);
+      fprintf(stderr,
+	      _("%s: ODR violation detection time: "
+		"(user: %ld.%06ld sys: %ld.%06ld wall: %ld.%06ld)\n"),
+	      program_name,
+	      odr_stats_time.user / 1000, (odr_stats_time.user % 1000) * 1000,
+	      odr_stats_time.sys / 1000, (odr_stats_time.sys % 1000) * 1000,
+	      odr_stats_time.wall / 1000, (odr_stats_time.wall % 1000) * 1000);
+    }
 }
 
 // We check for ODR violations by looking for symbols with the same
@@ -3514,32 +3538,6 @@ struct Odr_violation_compare
   }
 };
 
-// Returns all of the lines attached to LOC, not just the one the
-// instruction actually came from.
-std::vector<std::string>
-Symbol_table::linenos_from_loc(const Task* task,
-                               const Symbol_location& loc)
-{
-  // We need to lock the object in order to read it.  This
-  // means that we have to run in a singleton Task.  If we
-  // want to run this in a general Task for better
-  // performance, we will need one Task for object, plus
-  // appropriate locking to ensure that we don't conflict with
-  // other uses of the object.  Also note, one_addr2line is not
-  // currently thread-safe.
-  Task_lock_obj<Object> tl(task, loc.object);
-
-  std::vector<std::string> result;
-  Symbol_location code_loc = loc;
-  parameters->target().function_location(&code_loc);
-  // 16 is the size of the object-cache that one_addr2line should use.
-  std::string canonical_result = Dwarf_line_info::one_addr2line(
-      code_loc.object, code_loc.shndx, code_loc.offset, 16, &result);
-  if (!canonical_result.empty())
-    result.push_back(canonical_result);
-  return result;
-}
-
 // OutputIterator that records if it was ever assigned to.  This
 // allows it to be used with std::set_intersection() to check for
 // intersection rather than computing the intersection.
@@ -3569,27 +3567,202 @@ struct Check_intersection
   bool value_;
 };
 
-// Check candidate_odr_violations_ to find symbols with the same name
-// but apparently different definitions (different source-file/line-no
-// for each line assigned to the first instruction).
+// The state shared by the tasks which check for ODR violations.  An
+// Odr_lines_task looks up the lines for all the locations in one
+// object, so that each object's line information is only read once,
+// and the objects are read in parallel.  When they are all done, an
+// Odr_report_task compares the lines for each symbol.
+
+struct Odr_check
+{
+  // A location where a candidate symbol is defined, and all the lines
+  // attached to it, not just the one the instruction actually came
+  // from.  This helps the ODR checker avoid false positives.
+  struct Location
+  {
+    Symbol_location loc;
+    std::vector<std::string> linenos;
+  };
+
+  // A candidate symbol and the locations where it is defined.
+  struct Candidate
+  {
+    const char* name;
+    std::vector<Location> locations;
+  };
+
+  typedef std::vector<Location*> Location_list;
+
+  // The name of the output file, for the warnings.
+  std::string output_file_name;
+  // The candidate symbols, in the order in which they are reported.
+  std::vector<Candidate> candidates;
+  // The locations defined in each object.
+  std::vector<std::pair<Object*, Location_list> > objects;
+};
+
+// Add the time used by TIMER to odr_stats_time.
+
+static void
+odr_stats_add_time(Timer* timer)
+{
+  Timer::TimeStats elapsed = timer->get_elapsed_time();
+  odr_stats_initialize_lock.initialize();
+  Hold_optional_lock hl(odr_stats_lock);
+  odr_stats_time.user += elapsed.user;
+  odr_stats_time.sys += elapsed.sys;
+  odr_stats_time.wall += elapsed.wall;
+}
+
+// Look up the lines of the locations in one object.
+
+class Odr_lines_task : public Task
+{
+ public:
+  Odr_lines_task(Object* object, Odr_check::Location_list* locations,
+		 Task_token* lines_blocker)
+    : object_(object), locations_(locations), lines_blocker_(lines_blocker)
+  { }
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->object_->is_locked())
+      return this->object_->token();
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  {
+    tl->add(this, this->lines_blocker_);
+    Task_token* token = this->object_->token();
+    if (token != NULL)
+      tl->add(this, token);
+  }
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Odr_lines_task " + this->object_->name(); }
+
+ private:
+  Object* object_;
+  Odr_check::Location_list* locations_;
+  Task_token* lines_blocker_;
+};
 
 void
-Symbol_table::detect_odr_violations(const Task* task,
-				    const char* output_file_name) const
+Odr_lines_task::run(Workqueue*)
+{
+  Timer timer;
+  if (parameters->options().stats())
+    timer.start();
+
+  // Find the code for each location first, so that if they are all
+  // in the same section we only need to read the lines for that
+  // section.
+  std::vector<Symbol_location> code_locs;
+  code_locs.reserve(this->locations_->size());
+  unsigned int read_shndx = 0;
+  for (Odr_check::Location_list::const_iterator p = this->locations_->begin();
+       p != this->locations_->end();
+       ++p)
+    {
+      Symbol_location code_loc = (*p)->loc;
+      parameters->target().function_location(&code_loc);
+      gold_assert(code_loc.object == this->object_);
+      if (code_locs.empty())
+	read_shndx = code_loc.shndx;
+      else if (read_shndx != code_loc.shndx)
+	read_shndx = -1U;
+      code_locs.push_back(code_loc);
+    }
+
+  Dwarf_line_info* lineinfo = Dwarf_line_info::make_line_info(this->object_,
+							      read_shndx);
+  for (size_t i = 0; i < code_locs.size(); ++i)
+    {
+      std::vector<std::string>* linenos = &(*this->locations_)[i]->linenos;
+      std::string canonical_result = lineinfo->addr2line(code_locs[i].shndx,
+							 code_locs[i].offset,
+							 linenos);
+      if (!canonical_result.empty())
+	linenos->push_back(canonical_result);
+    }
+  delete lineinfo;
+
+  this->object_->release();
+
+  if (parameters->options().stats())
+    odr_stats_add_time(&timer);
+}
+
+// Compare the lines of the definitions of each candidate symbol, and
+// warn about those which are disjoint.
+
+class Odr_report_task : public Task
 {
-  for (Odr_map::const_iterator it = candidate_odr_violations_.begin();
-       it != candidate_odr_violations_.end();
+ public:
+  Odr_report_task(Odr_check* check, Task_token* lines_blocker,
+		  Task_token* final_blocker)
+    : check_(check), lines_blocker_(lines_blocker),
+      final_blocker_(final_blocker)
+  { }
+
+  ~Odr_report_task()
+  {
+    delete this->check_;
+    delete this->lines_blocker_;
+  }
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->lines_blocker_->is_blocked())
+      return this->lines_blocker_;
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->final_blocker_); }
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Odr_report_task"; }
+
+ private:
+  Odr_check* check_;
+  Task_token* lines_blocker_;
+  Task_token* final_blocker_;
+};
+
+void
+Odr_report_task::run(Workqueue*)
+{
+  Timer timer;
+  if (parameters->options().stats())
+    timer.start();
+
+  for (std::vector<Odr_check::Candidate>::iterator it =
+	 this->check_->candidates.begin();
+       it != this->check_->candidates.end();
        ++it)
     {
-      const char* const symbol_name = it->first;
+      const char* const symbol_name = it->name;
 
       std::string first_object_name;
       std::vector<std::string> first_object_linenos;
 
-      Unordered_set<Symbol_location, Symbol_location_hash>::const_iterator
-          locs = it->second.begin();
-      const Unordered_set<Symbol_location, Symbol_location_hash>::const_iterator
-          locs_end = it->second.end();
+      std::vector<Odr_check::Location>::iterator locs = it->locations.begin();
+      const std::vector<Odr_check::Location>::iterator locs_end =
+	it->locations.end();
       for (; locs != locs_end && first_object_linenos.empty(); ++locs)
         {
           // Save the line numbers from the first definition to
@@ -3598,8 +3771,8 @@ Symbol_table::detect_odr_violations(const Task* task,
           // take O(N^2) time to do this.  This shortcut may cause
           // false negatives that appear or disappear depending on the
           // link order, but it won't cause false positives.
-          first_object_name = locs->object->name();
-          first_object_linenos = this->linenos_from_loc(task, *locs);
+          first_object_name = locs->loc.object->name();
+          first_object_linenos.swap(locs->linenos);
         }
       if (first_object_linenos.empty())
 	continue;
@@ -3611,8 +3784,7 @@ Symbol_table::detect_odr_violations(const Task* task,
 
       for (; locs != locs_end; ++locs)
         {
-          std::vector<std::string> linenos =
-              this->linenos_from_loc(task, *locs);
+          std::vector<std::string>& linenos = locs->linenos;
           // linenos will be empty if we couldn't parse the debug info.
           if (linenos.empty())
             continue;
@@ -3632,7 +3804,8 @@ Symbol_table::detect_odr_violations(const Task* task,
             {
               gold_warning(_("while linking %s: symbol '%s' defined in "
                              "multiple places (possible ODR violation):"),
-                           output_file_name, demangle(symbol_name).c_str());
+                           this->check_->output_file_name.c_str(),
+			   demangle(symbol_name).c_str());
               // This only prints one location from each definition,
               // which may not be the location we expect to intersect
               // with another definition.  We could print the whole
@@ -3642,7 +3815,7 @@ Symbol_table::detect_odr_violations(const Task* task,
                       first_object_name.c_str());
               fprintf(stderr, _("  %s from %s\n"),
                       second_object_canonical_result.c_str(),
-                      locs->object->name().c_str());
+                      locs->loc.object->name().c_str());
               // Only print one broken pair, to avoid needing to
               // compare against a list of the disjoint definition
               // locations we've found so far.  (If we kept comparing
@@ -3653,8 +3826,87 @@ Symbol_table::detect_odr_violations(const Task* task,
             }
         }
     }
-  // We only call one_addr2line() in this function, so we can clear its cache.
-  Dwarf_line_info::clear_addr2line_cache();
+
+  if (parameters->options().stats())
+    odr_stats_add_time(&timer);
+}
+
+// Check candidate_odr_violations_ to find symbols with the same name
+// but apparently different definitions (different source-file/line-no
+// for each line assigned to the first instruction).
+
+void
+Symbol_table::detect_odr_violations(Workqueue* workqueue,
+				    const char* output_file_name,
+				    Task_token* final_blocker) const
+{
+  if (this->candidate_odr_violations_.empty())
+    return;
+
+  Odr_check* check = new Odr_check;
+  check->output_file_name = output_file_name;
+  check->candidates.reserve(this->candidate_odr_violations_.size());
+  size_t location_count = 0;
+  for (Odr_map::const_iterator it = this->candidate_odr_violations_.begin();
+       it != this->candidate_odr_violations_.end();
+       ++it)
+    {
+      check->candidates.push_back(Odr_check::Candidate());
+      Odr_check::Candidate& candidate(check->candidates.back());
+      candidate.name = it->first;
+      candidate.locations.reserve(it->second.size());
+      for (Unordered_set<Symbol_location, Symbol_location_hash>::const_iterator
+	     locs = it->second.begin();
+	   locs != it->second.end();
+	   ++locs)
+	{
+	  candidate.locations.push_back(Odr_check::Location());
+	  candidate.locations.back().loc = *locs;
+	}
+      location_count += it->second.size();
+    }
+
+  // Now that the candidates will not move, group their locations by
+  // object.
+  Unordered_map<Object*, size_t> object_index;
+  for (std::vector<Odr_check::Candidate>::iterator pc =
+	 check->candidates.begin();
+       pc != check->candidates.end();
+       ++pc)
+    {
+      for (std::vector<Odr_check::Location>::iterator pl =
+	     pc->locations.begin();
+	   pl != pc->locations.end();
+	   ++pl)
+	{
+	  std::pair<Unordered_map<Object*, size_t>::iterator, bool> ins =
+	    object_index.insert(std::make_pair(pl->loc.object,
+					       check->objects.size()));
+	  if (ins.second)
+	    check->objects.push_back(std::make_pair(pl->loc.object,
+						    Odr_check::Location_list()));
+	  check->objects[ins.first->second].second.push_back(&*pl);
+	}
+    }
+
+  if (parameters->options().stats())
+    {
+      odr_stats_symbols += check->candidates.size();
+      odr_stats_locations += location_count;
+      odr_stats_objects += check->objects.size();
+    }
+
+  Task_token* lines_blocker = new Task_token(true);
+  lines_blocker->add_blockers(check->objects.size());
+  final_blocker->add_blocker();
+
+  for (std::vector<std::pair<Object*, Odr_check::Location_list> >::iterator p =
+	 check->objects.begin();
+       p != check->objects.end();
+       ++p)
+    workqueue->queue(new Odr_lines_task(p->first, &p->second, lines_blocker));
+
+  workqueue->queue(new Odr_report_task(check, lines_blocker, final_blocker));
 }
 
 // Warnings functions.
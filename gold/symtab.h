@@ -60,6 +60,8 @@ class Output_file;
 class Output_symtab_xindex;
 class Garbage_collection;
 class Icf;
+class Workqueue;
+class Task_token;
 
 // The base class of an entry in the symbol table.  The symbol table
 // can have a lot of entries, so we don't want this class too big.
@@ -1609,10 +1611,13 @@ class Symbol_table
 		size_t relnum, off_t reloffset) const
   { this->warnings_.issue_warning(sym, relinfo, relnum, reloffset); }
 
-  // Check candidate_odr_violations_ to find symbols with the same name
-  // but apparently different definitions (different source-file/line-no).
+  // Queue tasks to check candidate_odr_violations_ to find symbols
+  // with the same name but apparently different definitions
+  // (different source-file/line-no).  FINAL_BLOCKER is blocked until
+  // the tasks have reported any violations.
   void
-  detect_odr_violations(const Task*, const char* output_file_name) const;
+  detect_odr_violations(Workqueue*, const char* output_file_name,
+			Task_token* final_blocker) const;
 
   // Add any undefined symbols named on the command line to the symbol
   // table.
@@ -1909,12 +1914,6 @@ class Symbol_table
   do_allocate_commons_list(Layout*, Commons_section_type, Commons_type*,
 			   Mapfile*, Sort_commons_order);
 
-  // Returns all of the lines attached to LOC, not just the one the
-  // instruction actually came from.  This helps the ODR checker avoid
-  // false positives.
-  static std::vector<std::string>
-  linenos_from_loc(const Task* task, const Symbol_location& loc);
-
   // Implement detect_odr_violations.
   template<int size, bool big_endian>
   void
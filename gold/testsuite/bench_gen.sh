@@ -0,0 +1,170 @@
+#!/bin/sh
+
+# bench_gen.sh -- generate synthetic inputs for benchmarking gold.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# Usage: bench_gen.sh WORKLOAD DIR OBJECTS FUNCTIONS SYMBOLS
+
+# Generate OBJECTS object files in DIR, each defining FUNCTIONS
+# functions in their own sections and SYMBOLS data symbols.  Every
+# function calls the next one, and the last function of each object
+# calls into the next object, so that each object has relocations
+# against the others.  WORKLOAD is one of:
+
+#   objects  plain objects, linked into an executable
+#   archive  the same objects, in archives of 16 members each
+#   debug    objects compiled with -g, with a type for every function
+#   tls      -fpic objects using thread local variables, linked -shared
+#   script   plain objects, linked with a linker script which gives
+#            every object its own output section
+
+# The file DIR/link.args receives the linker arguments, relative to
+# DIR.  The objects do not use the C library, and are never run.
+
+# The compiler is taken from $CC, and the archiver from $AR.
+
+set -e
+
+if test $# -ne 5; then
+  echo "usage: $0 WORKLOAD DIR OBJECTS FUNCTIONS SYMBOLS" 1>&2
+  exit 1
+fi
+
+workload=$1
+dir=$2
+objects=$3
+functions=$4
+symbols=$5
+
+CC=${CC:-gcc}
+AR=${AR:-ar}
+
+cflags="-O0 -ffunction-sections -fdata-sections -fno-asynchronous-unwind-tables"
+case $workload in
+  objects | archive | script) ;;
+  debug) cflags="$cflags -g" ;;
+  tls) cflags="$cflags -fpic" ;;
+  *)
+    echo "$0: unknown workload $workload" 1>&2
+    exit 1
+    ;;
+esac
+
+mkdir -p "$dir"
+rm -f "$dir"/bench_*.c "$dir"/bench_*.o "$dir"/libbench_*.a
+
+# Write out all the sources with a single awk program, since a shell
+# loop is very slow for large workloads.
+awk -v workload="$workload" -v dir="$dir" -v objects="$objects" \
+    -v functions="$functions" -v symbols="$symbols" '
+BEGIN {
+  for (i = 0; i < objects; i++) {
+    file = sprintf("%s/bench_%d.c", dir, i);
+    if (i + 1 < objects)
+      printf("extern int bench_func_%d_0(int);\n", i + 1) > file;
+    for (k = 0; k < symbols; k++) {
+      if (workload == "tls")
+        printf("__thread int bench_tls_%d_%d;\n", i, k) > file;
+      printf("int bench_data_%d_%d = %d;\n", i, k, k) > file;
+    }
+    for (j = functions - 1; j >= 0; j--) {
+      if (workload == "debug")
+        printf("struct bench_type_%d_%d { int a; long b; char c[%d]; };\n",
+               i, j, j % 16 + 1) > file;
+      printf("int\nbench_func_%d_%d(int x)\n{\n", i, j) > file;
+      if (workload == "debug")
+        printf("  struct bench_type_%d_%d t = { x, %d, { 0 } };\n  x += t.a;\n",
+               i, j, j) > file;
+      if (symbols > 0)
+        printf("  x += bench_data_%d_%d;\n", i, j % symbols) > file;
+      if (workload == "tls" && symbols > 0)
+        printf("  x += bench_tls_%d_%d;\n", i, j % symbols) > file;
+      if (j + 1 < functions)
+        printf("  return bench_func_%d_%d(x);\n}\n", i, j + 1) > file;
+      else if (i + 1 < objects)
+        printf("  return bench_func_%d_0(x);\n}\n", i + 1) > file;
+      else
+        printf("  return x;\n}\n") > file;
+    }
+    close(file);
+  }
+  file = sprintf("%s/bench_main.c", dir);
+  printf("extern int bench_func_0_0(int);\n") > file;
+  printf("int\nbench_main(void)\n{\n  return bench_func_0_0(0);\n}\n") > file;
+  close(file);
+}'
+
+cd "$dir"
+
+for f in bench_*.c; do
+  $CC $cflags -c -o "${f%.c}.o" "$f"
+done
+
+objs=""
+i=0
+while test $i -lt "$objects"; do
+  objs="$objs bench_$i.o"
+  i=`expr $i + 1`
+done
+
+case $workload in
+  objects | debug)
+    echo "-e bench_main bench_main.o$objs" > link.args
+    ;;
+  tls)
+    echo "-shared bench_main.o$objs" > link.args
+    ;;
+  archive)
+    libs=""
+    set -- $objs
+    n=0
+    while test $# -gt 0; do
+      members=""
+      m=0
+      while test $# -gt 0 && test $m -lt 16; do
+	members="$members $1"
+	shift
+	m=`expr $m + 1`
+      done
+      $AR rc libbench_$n.a $members
+      libs="$libs libbench_$n.a"
+      n=`expr $n + 1`
+    done
+    echo "-e bench_main bench_main.o$libs" > link.args
+    ;;
+  script)
+    {
+      echo "SECTIONS"
+      echo "{"
+      echo "  . = 0x400000 + SIZEOF_HEADERS;"
+      echo "  .text.bench_main : { bench_main.o(.text .text.*) }"
+      for o in $objs; do
+	echo "  .text.${o%.o} : { $o(.text .text.*) }"
+      done
+      echo "  .data : { *(.data .data.*) }"
+      echo "  .bss : { *(.bss .bss.*) *(COMMON) }"
+      echo "}"
+    } > bench.lds
+    echo "-e bench_main -T bench.lds bench_main.o$objs" > link.args
+    ;;
+esac
+
+exit 0
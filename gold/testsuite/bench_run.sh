@@ -0,0 +1,169 @@
+#!/bin/sh
+
+# bench_run.sh -- time gold on synthetic inputs.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# Usage: bench_run.sh [options] [WORKLOAD...]
+
+# Generate the synthetic inputs described in bench_gen.sh, link each
+# of them with gold for every thread count, and write one line of JSON
+# per link to the report, with the times of each pass and the memory
+# use as printed by --stats.  The WORKLOADs default to all of them.
+
+# Options:
+#   -l LD          the linker to time (default ../ld-new)
+#   -d DIR         where to generate the inputs (default bench-inputs)
+#   -o REPORT      the report to write (default bench.json)
+#   -t "N ..."     the thread counts to use (default "1 2 4 8")
+#   -r RUNS        how many times to run each link; the fastest run
+#                  is reported (default 3)
+#   -n OBJECTS, -m FUNCTIONS, -k SYMBOLS
+#                  the size of each input (default 200, 50, 50)
+#   -b BASELINE    compare with an earlier report, and exit with
+#                  status 1 if any link got 10% slower or larger
+
+set -e
+
+ld=../ld-new
+dir=bench-inputs
+report=bench.json
+threads="1 2 4 8"
+runs=3
+objects=200
+functions=50
+symbols=50
+baseline=
+
+while getopts l:d:o:t:r:n:m:k:b: opt; do
+  case $opt in
+    l) ld=$OPTARG ;;
+    d) dir=$OPTARG ;;
+    o) report=$OPTARG ;;
+    t) threads=$OPTARG ;;
+    r) runs=$OPTARG ;;
+    n) objects=$OPTARG ;;
+    m) functions=$OPTARG ;;
+    k) symbols=$OPTARG ;;
+    b) baseline=$OPTARG ;;
+    *) exit 1 ;;
+  esac
+done
+shift `expr $OPTIND - 1`
+
+workloads=${*:-"objects archive debug tls script"}
+
+srcdir=`dirname "$0"`
+case $ld in
+  /*) ;;
+  *) ld=`pwd`/$ld ;;
+esac
+
+: > "$report"
+
+for w in $workloads; do
+  wdir=$dir/$w-$objects-$functions-$symbols
+  if ! test -f "$wdir/link.args"; then
+    echo "generating $w inputs in $wdir"
+    ${SHELL:-/bin/sh} "$srcdir/bench_gen.sh" $w "$wdir" $objects $functions $symbols
+  fi
+  args=`cat "$wdir/link.args"`
+
+  for t in $threads; do
+    best=
+    r=0
+    while test $r -lt "$runs"; do
+      (cd "$wdir" && "$ld" --threads --thread-count=$t --stats \
+	 -o bench.out $args) 2> "$wdir/stats.$t.$r"
+      wall=`sed -n 's/.*total run time:.*wall: \([0-9.]*\).*/\1/p' \
+	      "$wdir/stats.$t.$r"`
+      if test -z "$best" \
+	 || awk "BEGIN { exit !($wall < $best_wall) }"; then
+	best=$r
+	best_wall=$wall
+      fi
+      r=`expr $r + 1`
+    done
+
+    awk -v workload=$w -v threads=$t -v objects=$objects \
+	-v functions=$functions -v symbols=$symbols '
+function wall(s) { sub(/.*wall: /, "", s); sub(/\).*/, "", s); return s; }
+function field(s, name) {
+  sub(".*" name ": ", "", s); sub(/ .*/, "", s); return s;
+}
+/initial tasks run time:/ { initial = wall($0); }
+/middle tasks run time:/ { middle = wall($0); }
+/final tasks run time:/ { final = wall($0); }
+/total run time:/ {
+  total = wall($0); user = field($0, "user"); sys = field($0, "sys");
+}
+/total space allocated by malloc:/ { malloc = $(NF - 1); }
+/maximum resident set size:/ { rss = $(NF - 1); }
+/output file size:/ { output = $(NF - 1); }
+END {
+  printf("{\"workload\": \"%s\", \"threads\": %d, \"objects\": %d, ",
+	 workload, threads, objects);
+  printf("\"functions\": %d, \"symbols\": %d, ", functions, symbols);
+  printf("\"initial_wall\": %s, \"middle_wall\": %s, \"final_wall\": %s, ",
+	 initial + 0, middle + 0, final + 0);
+  printf("\"total_wall\": %s, \"total_user\": %s, \"total_sys\": %s, ",
+	 total + 0, user + 0, sys + 0);
+  printf("\"malloc_bytes\": %s, \"max_rss_kb\": %s, \"output_bytes\": %s}\n",
+	 malloc + 0, rss + 0, output + 0);
+}' "$wdir/stats.$t.$best" >> "$report"
+    tail -1 "$report"
+  done
+done
+
+if test -n "$baseline"; then
+  # Look up each link of the baseline in the new report.
+  awk '
+function value(s, name) {
+  if (!sub(".*\"" name "\": \"?", "", s))
+    return "";
+  sub(/["},].*/, "", s);
+  return s;
+}
+{
+  key = value($0, "workload") " " value($0, "threads") " " \
+	value($0, "objects") " " value($0, "functions") " " \
+	value($0, "symbols");
+}
+FNR == NR {
+  old_wall[key] = value($0, "total_wall");
+  old_rss[key] = value($0, "max_rss_kb");
+  next;
+}
+key in old_wall {
+  wall = value($0, "total_wall");
+  rss = value($0, "max_rss_kb");
+  if (old_wall[key] > 0 && wall > old_wall[key] * 1.1) {
+    printf("%s: total_wall %s -> %s\n", key, old_wall[key], wall);
+    status = 1;
+  }
+  if (old_rss[key] > 0 && rss > old_rss[key] * 1.1) {
+    printf("%s: max_rss_kb %s -> %s\n", key, old_rss[key], rss);
+    status = 1;
+  }
+}
+END { exit status; }' "$baseline" "$report"
+fi
+
+exit 0
@@ -0,0 +1,70 @@
+// call_graph_ordering.cc -- a test case for gold
+
+// Copyright (C) 2026 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// The goal of this program is to verify that --call-graph-ordering-file
+// places each function after its most frequent caller, ahead of the
+// functions which do not appear in the profile, and places a function
+// which the profile shows is never called with the unlikely code.  The
+// functions are defined in the reverse of the expected order.
+
+extern "C" int plain_func(int);
+extern "C" int hot_func_c(int);
+extern "C" int hot_func_b(int);
+extern "C" int hot_func_a(int);
+extern "C" int cold_func(int);
+
+int
+plain_func(int i)
+{
+  return i * 2;
+}
+
+int
+hot_func_c(int i)
+{
+  return i + 3;
+}
+
+int
+hot_func_b(int i)
+{
+  return hot_func_c(i) + 2;
+}
+
+int
+hot_func_a(int i)
+{
+  return hot_func_b(i) + 1;
+}
+
+int
+main()
+{
+  if (hot_func_a(0) != 6)
+    return cold_func(plain_func(1));
+  return 0;
+}
+
+int
+cold_func(int i)
+{
+  return i - 1;
+}
@@ -0,0 +1,42 @@
+// copy_file_range_test.cc -- a test case for gold --copy-file-range
+
+// Copyright (C) 2026 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// This defines a read-only section larger than
+// File_read::min_copy_size, with no relocations, which gold copies
+// to the output file with copy_file_range.
+
+#include <cassert>
+
+asm(".section .rodata.copy_file_range_data,\"a\"\n"
+    ".globl copy_file_range_data\n"
+    "copy_file_range_data:\n"
+    ".fill 0x20000, 1, 0x5a\n"
+    ".previous\n");
+
+extern "C" const unsigned char copy_file_range_data[];
+
+int
+main()
+{
+  for (int i = 0; i < 0x20000; i += 0x1000)
+    assert(copy_file_range_data[i] == 0x5a);
+  return 0;
+}
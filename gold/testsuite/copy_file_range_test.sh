@@ -0,0 +1,48 @@
+#!/bin/sh
+
+# copy_file_range_test.sh -- test --copy-file-range.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with copy_file_range_test.cc, which has a large
+# read-only section with no relocations.  gold copies that section
+# with copy_file_range when it can.  Check that it did copy some bytes
+# that way, and that the output is the same as with
+# --no-copy-file-range.
+
+if ! cmp -s copy_file_range_test_1 copy_file_range_test_2; then
+  echo "copy_file_range_test_1 and copy_file_range_test_2 differ"
+  exit 1
+fi
+
+copied=`sed -n 's/.*total bytes copied by the kernel: \([0-9]*\)$/\1/p' \
+  copy_file_range_test.stats`
+if test -z "$copied"; then
+  echo "missing copy statistics in copy_file_range_test.stats"
+  exit 1
+fi
+
+if test "$copied" -eq 0; then
+  echo "no bytes copied by the kernel in copy_file_range_test_1"
+  cat copy_file_range_test.stats
+  exit 1
+fi
+
+exit 0
@@ -0,0 +1,34 @@
+#!/bin/sh
+
+# decompress_test.sh -- test decompressing debug sections in parallel
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with basic_test.cc, compiled with compressed debug
+# sections.  With --threads, the .debug_str section is decompressed by
+# a separate task before the object is laid out.  Check that the
+# output is the same as without threads.
+
+if ! cmp -s decompress_test_1 decompress_test_2; then
+  echo "decompress_test_1 and decompress_test_2 differ"
+  exit 1
+fi
+
+exit 0
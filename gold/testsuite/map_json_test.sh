@@ -0,0 +1,46 @@
+#!/bin/sh
+
+# map_json_test.sh -- test --map-format=json
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with basic_test.cc.  We link it with -Map and
+# --map-format=json, and check the structure of the map.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check map_json_test.map '^{$'
+check map_json_test.map '^  "memory_map": \[$'
+check map_json_test.map '"name": ".text", "address": "0x[0-9a-f]*", "size": "0x[0-9a-f]*", "inputs": \['
+check map_json_test.map '"object": "basic_test.o", "symbols": \[.*{"name": "main", "value": "0x[0-9a-f]*"}'
+check map_json_test.map '^}$'
+
+exit 0
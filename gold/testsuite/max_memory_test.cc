@@ -0,0 +1,49 @@
+// max_memory_test.cc -- a test case for gold --max-memory
+
+// Copyright (C) 2026 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// This defines a table of 0x40000 pointers, each with a relocation.
+// The relocation section of the table is larger than the 1MB window
+// in which gold reads relocations with --max-memory, even with 8-byte
+// REL relocations, so it is read in several windows.
+
+int max_memory_target;
+
+#define P1 &max_memory_target,
+#define P4 P1 P1 P1 P1
+#define P16 P4 P4 P4 P4
+#define P64 P16 P16 P16 P16
+#define P256 P64 P64 P64 P64
+#define P1K P256 P256 P256 P256
+#define P4K P1K P1K P1K P1K
+#define P16K P4K P4K P4K P4K
+#define P64K P16K P16K P16K P16K
+#define P256K P64K P64K P64K P64K
+
+int* max_memory_table[] =
+{
+  P256K
+};
+
+int
+main()
+{
+  return max_memory_table[0x3ffff] == &max_memory_target ? 0 : 1;
+}
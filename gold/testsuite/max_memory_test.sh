@@ -0,0 +1,34 @@
+#!/bin/sh
+
+# max_memory_test.sh -- test --max-memory
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with max_memory_test.cc, whose relocations span
+# several windows.  With --max-memory, a relocatable link reads the
+# relocations in windows when scanning them.  Check that the output is
+# the same as without the option.
+
+if ! cmp -s max_memory_test_1.o max_memory_test_2.o; then
+  echo "max_memory_test_1.o and max_memory_test_2.o differ"
+  exit 1
+fi
+
+exit 0
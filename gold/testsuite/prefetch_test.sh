@@ -0,0 +1,45 @@
+#!/bin/sh
+
+# prefetch_test.sh -- test --prefetch-inputs
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with basic_test.cc.  We link it with
+# --prefetch-inputs --stats, and check that the input files were
+# prefetched and that the statistics were reported.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check prefetch_test.stats "input files prefetched: [1-9]"
+check prefetch_test.stats "input file prefetch hits: [0-9]"
+check prefetch_test.stats "input file prefetch stalls: [0-9]"
+
+exit 0